@@ -42,3 +42,10 @@ set(CMAKE_C_STANDARD 11)
 add_compile_definitions(MAGICUBE_$<IF:$<CONFIG:Debug>,DEBUG,RELEASE>)
 
 #========================================= COMPILER FLAGS =========================================#
+
+# The move and symmetry tables are generated and checked by the compiler, which takes more
+# constant evaluation steps than the MSVC and Clang defaults allow
+add_compile_options(
+	$<$<AND:$<COMPILE_LANGUAGE:CXX>,$<CXX_COMPILER_ID:MSVC>>:/constexpr:steps16777216>
+	$<$<AND:$<COMPILE_LANGUAGE:CXX>,$<CXX_COMPILER_ID:Clang,AppleClang>>:-fconstexpr-steps=16777216>
+)
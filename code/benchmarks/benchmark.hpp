@@ -0,0 +1,60 @@
+#pragma once
+
+#include <chrono>
+#include <random>
+#include <string_view>
+
+#include <fmt/format.h>
+
+#include "game/magicube/cube/move.hpp"
+
+namespace gzn::benchmarks {
+
+template<class T>
+inline void do_not_optimize(const T &value) noexcept {
+#if defined(_MSC_VER)
+	const volatile char sink{ *reinterpret_cast<const volatile char *>(&value) };
+	static_cast<void>(sink);
+#else
+	asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+struct result {
+	std::string_view name;
+	size_t operations{};
+	double seconds{};
+
+	[[nodiscard]] double per_second() const noexcept {
+		return seconds > 0.0 ? static_cast<double>(operations) / seconds : 0.0;
+	}
+};
+
+/// @brief Runs @p function once and prints how many of @p operations it did per second
+template<class Function>
+result measure(const std::string_view name, const size_t operations, Function &&function) {
+	using clock = std::chrono::steady_clock;
+
+	const auto start{ clock::now() };
+	function();
+	const std::chrono::duration<double> elapsed{ clock::now() - start };
+
+	const result measured{ name, operations, elapsed.count() };
+	fmt::print("{:<48} {:>12} ops {:>10.3f} ms {:>12.3f} Mops/s\n",
+		measured.name, measured.operations, measured.seconds * 1000.0, measured.per_second() / 1e6);
+	return measured;
+}
+
+[[nodiscard]] inline game::magicube::move_sequence random_moves(const size_t count,
+	const uint64_t seed = 0x6D61676963756265ull) {
+	std::mt19937_64 engine{ seed };
+	std::uniform_int_distribution<size_t> distribution{ 0, game::magicube::move_count - 1 };
+
+	game::magicube::move_sequence moves(count);
+	for (auto &m : moves) {
+		m = static_cast<game::magicube::move>(distribution(engine));
+	}
+	return moves;
+}
+
+} // namespace gzn::benchmarks
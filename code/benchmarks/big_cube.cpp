@@ -0,0 +1,87 @@
+#include <array>
+#include <random>
+#include <vector>
+#include <numeric>
+
+#include "game/magicube/cube/big_cube.hpp"
+#include "benchmarks/benchmark.hpp"
+
+int main() {
+	using namespace gzn;
+	using namespace gzn::game::magicube;
+
+	constexpr std::array<size_t, 9> sizes{ 3, 5, 7, 10, 17, 33, 65, 100, 255 };
+	constexpr size_t turns_count{ 1u << 16 };
+
+	struct layer_turn {
+		face f;
+		uint16_t layer;
+		uint8_t power;
+	};
+
+	std::mt19937_64 engine{ 0x6269675f63756265ull };
+	for (const auto size : sizes) {
+		auto cube{ *big_cube::create(size) };
+
+		std::vector<layer_turn> outer(turns_count);
+		std::vector<layer_turn> inner(turns_count);
+		for (size_t i{}; i < turns_count; ++i) {
+			const auto f{ static_cast<face>(engine() % face_count) };
+			const auto power{ static_cast<uint8_t>(1 + engine() % 3) };
+			outer[i] = { f, 0, power };
+			inner[i] = { f, static_cast<uint16_t>(1 + engine() % (size - 2)), power };
+		}
+
+		const auto outer_name{ fmt::format("big_cube {}x{}: face turn", size, size) };
+		const auto face_measured{ benchmarks::measure(outer_name, turns_count, [&cube, &outer] {
+			for (const auto &t : outer) {
+				cube.turn_layer(t.f, t.layer, t.power);
+			}
+			benchmarks::do_not_optimize(cube);
+		}) };
+
+		const auto inner_name{ fmt::format("big_cube {}x{}: slice turn", size, size) };
+		const auto slice_measured{ benchmarks::measure(inner_name, turns_count, [&cube, &inner] {
+			for (const auto &t : inner) {
+				cube.turn_layer(t.f, t.layer, t.power);
+			}
+			benchmarks::do_not_optimize(cube);
+		}) };
+
+		// what a move costs when it permutes every sticker through a table
+		const auto naive_name{ fmt::format("big_cube {}x{}: permutation of all stickers", size, size) };
+		const size_t area{ size * size };
+		std::vector<uint32_t> source_of(face_count * area);
+		std::iota(source_of.begin(), source_of.end(), 0u);
+		std::vector<uint8_t> stickers(face_count * area);
+		std::vector<uint8_t> permuted(face_count * area);
+		const auto naive_measured{ benchmarks::measure(naive_name, turns_count, [&source_of, &stickers, &permuted] {
+			for (size_t i{}; i < turns_count; ++i) {
+				for (size_t j{}; j < source_of.size(); ++j) {
+					permuted[j] = stickers[source_of[j]];
+				}
+				stickers.swap(permuted);
+			}
+			benchmarks::do_not_optimize(stickers);
+		}) };
+
+		const auto per_turn{ [](const benchmarks::result &measured) {
+			return measured.seconds * 1e9 / static_cast<double>(measured.operations);
+		} };
+		fmt::print("{}x{}: {:.1f} ns per face turn, {:.1f} ns per slice turn, {:.1f} ns per naive move\n",
+			size, size, per_turn(face_measured), per_turn(slice_measured), per_turn(naive_measured));
+
+		for (auto t{ inner.rbegin() }; t != inner.rend(); ++t) {
+			cube.turn_layer(t->f, t->layer, static_cast<uint8_t>(4 - t->power));
+		}
+		for (auto t{ outer.rbegin() }; t != outer.rend(); ++t) {
+			cube.turn_layer(t->f, t->layer, static_cast<uint8_t>(4 - t->power));
+		}
+		if (!cube.solved()) {
+			fmt::print("The inverse turns don't solve the {}x{} cube!\n", size, size);
+			return EXIT_FAILURE;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
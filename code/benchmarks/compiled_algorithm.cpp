@@ -0,0 +1,85 @@
+#include <vector>
+
+#include <magic_enum.hpp>
+
+#include "game/magicube/cube/compiled_algorithm.hpp"
+#include "benchmarks/benchmark.hpp"
+
+int main() {
+	using namespace gzn;
+	using namespace gzn::game::magicube;
+
+	constexpr size_t algorithm_count{ 64 };
+	constexpr size_t algorithm_length{ 40 };
+	constexpr size_t state_count{ 1u << 16 };
+
+	const auto moves{ benchmarks::random_moves(algorithm_count * algorithm_length + state_count) };
+	std::vector<move_sequence> algorithms;
+	std::vector<compiled_algorithm> compiled;
+	for (size_t i{}; i < algorithm_count; ++i) {
+		const auto first{ moves.begin() + static_cast<ptrdiff_t>(i * algorithm_length) };
+		algorithms.emplace_back(first, first + algorithm_length);
+	}
+
+	benchmarks::measure("compiled_algorithm: compile (40 moves)", algorithm_count, [&algorithms, &compiled] {
+		for (const auto &algorithm : algorithms) {
+			compiled.push_back(compiled_algorithm::compile(algorithm));
+		}
+		benchmarks::do_not_optimize(compiled);
+	});
+
+	std::vector<cube_state> initial(state_count);
+	cube_state state;
+	for (size_t i{}; i < state_count; ++i) {
+		state.apply(moves[algorithm_count * algorithm_length + i]);
+		initial[i] = state;
+	}
+
+	const auto applications{ algorithm_count * state_count };
+	auto expected{ initial };
+	benchmarks::measure("compiled_algorithm: move by move (40 moves)", applications, [&algorithms, &expected] {
+		for (const auto &algorithm : algorithms) {
+			for (auto &s : expected) {
+				s.apply(algorithm);
+			}
+		}
+		benchmarks::do_not_optimize(expected);
+	});
+
+	auto single{ initial };
+	benchmarks::measure("compiled_algorithm: one state at a time", applications, [&compiled, &single] {
+		for (const auto &algorithm : compiled) {
+			for (auto &s : single) {
+				algorithm.apply(s);
+			}
+		}
+		benchmarks::do_not_optimize(single);
+	});
+	if (single != expected) {
+		fmt::print("The compiled algorithms disagree with the moves!\n");
+		return EXIT_FAILURE;
+	}
+
+	fmt::print("Default kernel: {}\n", magic_enum::enum_name(compiled_algorithm::default_kernel()));
+	for (const auto kernel : magic_enum::enum_values<algorithm_kernel>()) {
+		if (!compiled_algorithm::supported(kernel)) {
+			fmt::print("{:<48} unsupported\n", magic_enum::enum_name(kernel));
+			continue;
+		}
+
+		const auto name{ fmt::format("compiled_algorithm: batch ({})", magic_enum::enum_name(kernel)) };
+		auto batch{ initial };
+		benchmarks::measure(name, applications, [&compiled, &batch, kernel] {
+			for (const auto &algorithm : compiled) {
+				algorithm.apply(batch.data(), batch.size(), kernel);
+			}
+			benchmarks::do_not_optimize(batch);
+		});
+		if (batch != expected) {
+			fmt::print("The {} kernel disagrees with the moves!\n", magic_enum::enum_name(kernel));
+			return EXIT_FAILURE;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,52 @@
+#include <vector>
+
+#include "game/magicube/cube/cube_state.hpp"
+#include "benchmarks/benchmark.hpp"
+
+int main() {
+	using namespace gzn;
+	using namespace gzn::game::magicube;
+
+	constexpr size_t moves_count{ 1u << 24 };
+	const auto moves{ benchmarks::random_moves(moves_count) };
+
+	benchmarks::measure("cubie_cube: apply move", moves_count, [&moves] {
+		cubie_cube cube;
+		for (const auto m : moves) {
+			cube = apply(cube, m);
+		}
+		benchmarks::do_not_optimize(cube);
+	});
+
+	cube_state state;
+	benchmarks::measure("cube_state: apply move", moves_count, [&moves, &state] {
+		for (const auto m : moves) {
+			state.apply(m);
+		}
+		benchmarks::do_not_optimize(state);
+	});
+
+	std::vector<cube_state> states(1u << 20);
+	for (size_t i{}; i < states.size(); ++i) {
+		states[i] = state.moved(moves[i]);
+		state = states[i];
+	}
+
+	benchmarks::measure("cube_state: hash", states.size(), [&states] {
+		uint64_t combined{};
+		for (const auto &s : states) {
+			combined ^= std::hash<cube_state>{}(s);
+		}
+		benchmarks::do_not_optimize(combined);
+	});
+
+	benchmarks::measure("cube_state: cubie round trip", states.size(), [&states] {
+		size_t mismatches{};
+		for (const auto &s : states) {
+			mismatches += cube_state::from_cubies(s.to_cubies()) != s;
+		}
+		benchmarks::do_not_optimize(mismatches);
+	});
+
+	return EXIT_SUCCESS;
+}
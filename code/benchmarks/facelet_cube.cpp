@@ -0,0 +1,69 @@
+#include <string>
+#include <vector>
+
+#include <magic_enum.hpp>
+
+#include "game/magicube/cube/cube_state.hpp"
+#include "game/magicube/cube/facelet_cube.hpp"
+#include "benchmarks/benchmark.hpp"
+
+int main() {
+	using namespace gzn;
+	using namespace gzn::game::magicube;
+
+	constexpr size_t moves_count{ 1u << 24 };
+	const auto moves{ benchmarks::random_moves(moves_count) };
+
+	fmt::print("Default kernel: {}\n", magic_enum::enum_name(facelet_cube::default_kernel()));
+
+	std::vector<facelet_cube> results;
+	for (const auto kernel : magic_enum::enum_values<facelet_kernel>()) {
+		if (!facelet_cube::supported(kernel)) {
+			fmt::print("{:<48} unsupported\n", magic_enum::enum_name(kernel));
+			continue;
+		}
+
+		const auto name{ fmt::format("facelet_cube: apply move ({})", magic_enum::enum_name(kernel)) };
+		facelet_cube cube;
+		benchmarks::measure(name, moves_count, [&moves, &cube, kernel] {
+			for (const auto m : moves) {
+				cube.apply(m, kernel);
+			}
+			benchmarks::do_not_optimize(cube);
+		});
+		results.push_back(cube);
+	}
+
+	for (const auto &cube : results) {
+		if (cube != results.front()) {
+			fmt::print("Kernels disagree on the final state!\n");
+			return EXIT_FAILURE;
+		}
+	}
+
+	std::vector<std::string> texts;
+	texts.reserve(1u << 18);
+	cube_state state;
+	for (size_t i{}; i < texts.capacity(); ++i) {
+		state.apply(moves[i]);
+		texts.push_back(facelet_cube::from_cubies(state.to_cubies()).to_string());
+	}
+
+	benchmarks::measure("facelet_cube: string -> cubies -> string", texts.size(), [&texts] {
+		char buffer[facelet_count]{};
+		size_t failures{};
+		for (const auto &text : texts) {
+			const auto cube{ facelet_cube::from_string(text) };
+			const auto cubies{ cube ? cube->to_cubies() : std::nullopt };
+			if (!cubies) {
+				++failures;
+				continue;
+			}
+			facelet_cube::from_cubies(*cubies).to_string(buffer);
+			failures += std::string_view{ buffer, facelet_count } != text;
+		}
+		benchmarks::do_not_optimize(failures);
+	});
+
+	return EXIT_SUCCESS;
+}
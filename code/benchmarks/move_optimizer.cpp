@@ -0,0 +1,94 @@
+#include <array>
+#include <vector>
+
+#include <core/tools/bits.hpp>
+
+#include "game/magicube/cube/move_optimizer.hpp"
+#include "benchmarks/benchmark.hpp"
+
+namespace {
+
+using namespace gzn::game::magicube;
+
+/// Canonical sequences of @p depth moves, counted by the face of the last move
+uint64_t count_canonical(const size_t depth) {
+	std::array<uint64_t, face_count + 1> counts{};
+	counts[face_count] = 1;
+	for (size_t i{}; i < depth; ++i) {
+		std::array<uint64_t, face_count + 1> next{};
+		for (size_t previous{}; previous <= face_count; ++previous) {
+			for (auto moves{ canonical_successors(previous) }; moves != 0; moves &= moves - 1) {
+				const auto m{ static_cast<move>(gzn::core::tools::count_trailing_zeros(moves)) };
+				next[static_cast<size_t>(face_of(m))] += counts[previous];
+			}
+		}
+		counts = next;
+	}
+	uint64_t total{};
+	for (const auto count : counts) total += count;
+	return total;
+}
+
+} // anonymous namespace
+
+int main() {
+	using namespace gzn;
+
+	constexpr size_t depth{ 16 };
+	const auto canonical{ count_canonical(depth) };
+	const auto shorter{ count_canonical(depth - 1) };
+	fmt::print("Canonical sequences of {} moves: {}, branching factor {:.2f} instead of {}\n",
+		depth, canonical, static_cast<double>(canonical) / static_cast<double>(shorter), move_count);
+
+	constexpr size_t sequence_count{ 1u << 18 };
+	constexpr size_t sequence_length{ 40 };
+	const auto moves{ benchmarks::random_moves(sequence_count * sequence_length) };
+	std::vector<move_sequence> sequences;
+	sequences.reserve(sequence_count);
+	for (size_t i{}; i < sequence_count; ++i) {
+		const auto first{ moves.begin() + static_cast<ptrdiff_t>(i * sequence_length) };
+		sequences.emplace_back(first, first + sequence_length);
+	}
+
+	auto simplified_sequences{ sequences };
+	benchmarks::measure("move_optimizer: simplify (40 moves)", sequence_count, [&simplified_sequences] {
+		simplify(simplified_sequences);
+		benchmarks::do_not_optimize(simplified_sequences);
+	});
+
+	size_t before{}, after{};
+	for (size_t i{}; i < sequence_count; ++i) {
+		before += sequences[i].size();
+		after += simplified_sequences[i].size();
+	}
+	fmt::print("Moves: {} -> {} ({:.1f}%)\n", before, after, 100.0 * static_cast<double>(after) / static_cast<double>(before));
+
+	std::vector<uint8_t> bytecode;
+	benchmarks::measure("move_optimizer: encode", sequence_count, [&sequences, &bytecode] {
+		bytecode = encode(sequences);
+		benchmarks::do_not_optimize(bytecode);
+	});
+	fmt::print("Bytecode: {} bytes, {:.2f} bits per move\n", bytecode.size(),
+		8.0 * static_cast<double>(bytecode.size()) / static_cast<double>(after));
+
+	std::vector<move_sequence> decoded;
+	decoded.reserve(sequence_count);
+	benchmarks::measure("move_optimizer: decode", sequence_count, [&bytecode, &decoded] {
+		const bool valid{ decode(bytecode, decoded) };
+		benchmarks::do_not_optimize(valid);
+	});
+	if (decoded != simplified_sequences) {
+		fmt::print("The decoded sequences differ from the simplified ones!\n");
+		return EXIT_FAILURE;
+	}
+
+	size_t characters{};
+	benchmarks::measure("move_optimizer: slice notation", sequence_count, [&sequences, &characters] {
+		for (const auto &sequence : sequences) {
+			characters += slice_notation(sequence).size();
+		}
+		benchmarks::do_not_optimize(characters);
+	});
+
+	return EXIT_SUCCESS;
+}
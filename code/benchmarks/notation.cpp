@@ -0,0 +1,82 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include "game/magicube/cube/notation.hpp"
+#include "benchmarks/benchmark.hpp"
+
+namespace {
+
+using namespace gzn::game::magicube;
+
+/// Turns of a 7x7 log: plain, wide, numbered, slices and rotations
+std::vector<turn> random_turns(const size_t count) {
+	std::mt19937_64 engine{ 0x6E6F746174696F6Eull };
+	std::uniform_int_distribution<size_t> kinds{ 0, 9 }, faces{ 0, face_count - 1 }, powers{ 1, 3 }, layers{ 2, 3 };
+
+	constexpr face slices[]{ face::D, face::L, face::F };
+
+	std::vector<turn> turns(count);
+	for (auto &t : turns) {
+		t.direction = static_cast<face>(faces(engine));
+		t.power = static_cast<uint8_t>(powers(engine));
+		switch (kinds(engine)) {
+			case 0: t.kind = turn_kind::wide; t.layers = static_cast<uint8_t>(layers(engine)); break;
+			case 1: t.kind = turn_kind::face; t.layers = static_cast<uint8_t>(layers(engine)); break;
+			// written as M, E, S, x, y and z, which follow only three of the faces each
+			case 2: t.kind = turn_kind::slice; t.direction = slices[faces(engine) % 3]; break;
+			case 3: t.kind = turn_kind::rotation; t.direction = static_cast<face>(faces(engine) % 3); break;
+			default: break;
+		}
+	}
+	return turns;
+}
+
+} // anonymous namespace
+
+int main() {
+	using namespace gzn;
+
+	constexpr size_t turn_count{ 1u << 23 };
+	const auto turns{ random_turns(turn_count) };
+
+	std::string text(turn_count * max_turn_length, '\0');
+	size_t length{};
+	benchmarks::measure("notation: format", turn_count, [&turns, &text, &length] {
+		length = format_notation(turns.data(), turns.size(), text.data(), text.size());
+		benchmarks::do_not_optimize(length);
+	});
+	text.resize(length);
+
+	std::vector<turn> parsed(turn_count);
+	notation_result result;
+	const auto measured{ benchmarks::measure("notation: parse", turn_count, [&text, &parsed, &result] {
+		result = parse_notation(text, parsed.data(), parsed.size());
+		benchmarks::do_not_optimize(result);
+	}) };
+	fmt::print("Text: {:.1f} MB, parsed at {:.0f} MB/s\n", static_cast<double>(length) / 1e6,
+		static_cast<double>(length) / 1e6 / measured.seconds);
+
+	if (!result || parsed != turns) {
+		fmt::print("The parsed turns differ from the formatted ones: {} at {}\n", result.error, result.position);
+		return EXIT_FAILURE;
+	}
+
+	const auto moves{ benchmarks::random_moves(turn_count) };
+	text.resize(turn_count * max_turn_length);
+	benchmarks::measure("notation: format moves", turn_count, [&moves, &text, &length] {
+		length = format_notation(moves.data(), moves.size(), text.data(), text.size());
+		benchmarks::do_not_optimize(length);
+	});
+	text.resize(length);
+
+	// the usual 3x3 scramble log
+	const auto face_measured{ benchmarks::measure("notation: parse face turns", turn_count, [&text, &parsed, &result] {
+		result = parse_notation(text, parsed.data(), parsed.size());
+		benchmarks::do_not_optimize(result);
+	}) };
+	fmt::print("Text: {:.1f} MB, parsed at {:.0f} MB/s\n", static_cast<double>(length) / 1e6,
+		static_cast<double>(length) / 1e6 / face_measured.seconds);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,70 @@
+#include <array>
+#include <vector>
+#include <filesystem>
+
+#include <fmt/ranges.h>
+
+#include "game/magicube/solver/pocket_table.hpp"
+#include "benchmarks/benchmark.hpp"
+
+int main() {
+	using namespace gzn;
+	using namespace gzn::game::magicube;
+
+	std::optional<pocket_table> generated;
+	benchmarks::measure("pocket_table: generate", pocket_table::state_count, [&generated] {
+		generated.emplace(pocket_table::generate());
+	});
+
+	const auto path{ std::filesystem::temp_directory_path() / "magicube_benchmark_pocket.table" };
+	if (!generated->save(path)) {
+		return EXIT_FAILURE;
+	}
+	std::optional<pocket_table> table;
+	benchmarks::measure("pocket_table: open", 1, [&table, &path] {
+		table = pocket_table::open(path);
+	});
+	if (!table) {
+		return EXIT_FAILURE;
+	}
+
+	constexpr size_t state_count{ 1u << 18 };
+	constexpr size_t scramble_length{ 25 };
+	const auto moves{ benchmarks::random_moves(state_count * scramble_length) };
+	std::vector<cube_state> states(state_count);
+	for (size_t i{}; i < state_count; ++i) {
+		const auto first{ moves.begin() + static_cast<ptrdiff_t>(i * scramble_length) };
+		states[i].apply(first, first + scramble_length);
+	}
+
+	std::array<uint64_t, pocket_table::max_distance + 1> distances{};
+	benchmarks::measure("pocket_table: distance", state_count, [&table, &states, &distances] {
+		for (const auto &state : states) {
+			++distances[table->distance(state).value_or(0)];
+		}
+		benchmarks::do_not_optimize(distances);
+	});
+	fmt::print("Distances of random states: {}\n", fmt::join(distances, " "));
+
+	std::vector<move_sequence> solutions(state_count);
+	const auto measured{ benchmarks::measure("pocket_table: solve", state_count, [&table, &states, &solutions] {
+		for (size_t i{}; i < state_count; ++i) {
+			solutions[i] = table->solve(states[i]).value_or(move_sequence{});
+		}
+		benchmarks::do_not_optimize(solutions);
+	}) };
+	fmt::print("{:.2f} us per optimal solution\n", measured.seconds * 1e6 / static_cast<double>(state_count));
+
+	for (size_t i{}; i < state_count; ++i) {
+		auto state{ states[i] };
+		state.apply(solutions[i]);
+		if (!pocket_table::solved(state)) {
+			fmt::print("The solution of the state {} doesn't solve it!\n", i);
+			return EXIT_FAILURE;
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::remove(path, error);
+	return EXIT_SUCCESS;
+}
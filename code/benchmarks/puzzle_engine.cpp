@@ -0,0 +1,87 @@
+#include <vector>
+#include <random>
+#include <string_view>
+
+#include "game/magicube/cube/cube_state.hpp"
+#include "game/magicube/puzzle/puzzles.hpp"
+#include "game/magicube/puzzle/puzzle_state.hpp"
+#include "benchmarks/benchmark.hpp"
+
+namespace {
+
+using namespace gzn;
+using namespace gzn::game::magicube;
+
+constexpr size_t moves_count{ 1u << 24 };
+
+template<class Puzzle>
+[[nodiscard]] std::vector<typename puzzle_state<Puzzle>::move_type> random_puzzle_moves() {
+	using state = puzzle_state<Puzzle>;
+	std::mt19937_64 engine{ 0x70757a7a6c65ull };
+	std::uniform_int_distribution<size_t> distribution{ 0, state::move_count - 1 };
+
+	std::vector<typename state::move_type> moves(moves_count);
+	for (auto &m : moves) {
+		m = static_cast<typename state::move_type>(distribution(engine));
+	}
+	return moves;
+}
+
+/// @brief Applies random moves, then checks that their inverses in the reverse order bring
+/// the puzzle back
+template<class Puzzle>
+[[nodiscard]] bool measure_puzzle(const std::string_view name) {
+	using state = puzzle_state<Puzzle>;
+	const auto moves{ random_puzzle_moves<Puzzle>() };
+
+	state puzzle;
+	benchmarks::measure(name, moves.size(), [&moves, &puzzle] {
+		puzzle.apply(moves.begin(), moves.end());
+		benchmarks::do_not_optimize(puzzle);
+	});
+
+	for (auto m{ moves.rbegin() }; m != moves.rend(); ++m) {
+		puzzle.apply(state::inverse(*m));
+	}
+	if (!puzzle.solved()) {
+		fmt::print("{}: the inverse moves don't solve the puzzle!\n", name);
+		return false;
+	}
+	return true;
+}
+
+} // anonymous namespace
+
+int main() {
+	const auto moves{ benchmarks::random_moves(moves_count) };
+
+	cube_state cube;
+	benchmarks::measure("cube_state: apply move", moves.size(), [&moves, &cube] {
+		cube.apply(moves.begin(), moves.end());
+		benchmarks::do_not_optimize(cube);
+	});
+
+	// the moves of the engine are numbered like `move` on the 3x3
+	puzzle_state<puzzles::cube_3x3> engine;
+	benchmarks::measure("puzzle_state<cube_3x3>: apply move", moves.size(), [&moves, &engine] {
+		for (const auto m : moves) {
+			engine.apply(static_cast<uint8_t>(m));
+		}
+		benchmarks::do_not_optimize(engine);
+	});
+	if (engine.words()[puzzles::cube_3x3::corners] != cube.corners() ||
+		engine.words()[puzzles::cube_3x3::edges] != cube.edges() ||
+		engine.hash() != cube.hash()) {
+		fmt::print("The engine and cube_state disagree on the 3x3!\n");
+		return EXIT_FAILURE;
+	}
+
+	const bool verified{
+		measure_puzzle<puzzles::cube_3x3>("puzzle_state<cube_3x3>: random moves") &&
+		measure_puzzle<puzzles::cube_2x2>("puzzle_state<cube_2x2>: random moves") &&
+		measure_puzzle<puzzles::pyraminx>("puzzle_state<pyraminx>: random moves") &&
+		measure_puzzle<puzzles::skewb>("puzzle_state<skewb>: random moves") &&
+		measure_puzzle<puzzles::megaminx>("puzzle_state<megaminx>: random moves")
+	};
+	return verified ? EXIT_SUCCESS : EXIT_FAILURE;
+}
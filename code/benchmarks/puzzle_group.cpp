@@ -0,0 +1,109 @@
+#include <vector>
+#include <random>
+#include <optional>
+#include <string_view>
+
+#include "game/magicube/puzzle/puzzles.hpp"
+#include "game/magicube/puzzle/puzzle_group.hpp"
+#include "benchmarks/benchmark.hpp"
+
+namespace {
+
+using namespace gzn;
+using namespace gzn::game::magicube;
+
+constexpr size_t state_count{ 1u << 18 };
+constexpr size_t scramble_length{ 60 };
+
+/// @brief Builds the group, then tests random states, every other one with a piece twisted in
+/// place, which no sequence of turns can do, and the states which aren't states at all
+template<class Puzzle>
+[[nodiscard]] bool measure_group(const std::string_view name) {
+	using state_type = puzzle_state<Puzzle>;
+
+	const auto build_name{ fmt::format("puzzle_group<{}>: build", name) };
+	const auto reachable_name{ fmt::format("puzzle_group<{}>: reachable", name) };
+
+	std::optional<puzzle_group<Puzzle>> group;
+	benchmarks::measure(build_name, 1, [&group] {
+		group.emplace();
+	});
+	fmt::print("{}: {} states, a base of {} points\n", name, group->order(), group->group().base_length());
+
+	std::mt19937_64 engine{ 0x736368726569ull };
+	std::vector<state_type> states(state_count);
+	for (size_t i{}; i < state_count; ++i) {
+		for (size_t m{}; m < scramble_length; ++m) {
+			states[i].apply(static_cast<typename state_type::move_type>(engine() % state_type::move_count));
+		}
+		if (i % 2 == 1) {
+			const auto field{ states[i].field(0, 0) };
+			states[i].set_field(0, 0, static_cast<uint8_t>(field ^ (1u << state_type::layouts[0].position_bits)));
+		}
+	}
+
+	size_t reachable{};
+	const auto measured{ benchmarks::measure(reachable_name, state_count,
+		[&group, &states, &reachable] {
+			for (const auto &state : states) {
+				reachable += group->reachable(state);
+			}
+		}) };
+	fmt::print("{:.3f} us per state\n", measured.seconds * 1e6 / static_cast<double>(state_count));
+	if (reachable != state_count / 2) {
+		fmt::print("{}: {} of {} states are reachable, expected a half!\n", name, reachable, state_count);
+		return false;
+	}
+
+	// a position or an orientation past the last one in any orbit, and two pieces at the same
+	// position, all of them fit the fields
+	std::vector<state_type> malformed;
+	for (size_t o{}; o < state_type::orbit_count; ++o) {
+		const auto &orbit{ state_type::definition.orbits[o] };
+		const auto &layout{ state_type::layouts[o] };
+		if ((1u << layout.position_bits) > orbit.count) {
+			malformed.emplace_back().set_field(o, 0, static_cast<uint8_t>((1u << layout.position_bits) - 1));
+		}
+		if ((1u << (layout.field_bits - layout.position_bits)) > orbit.orientations) {
+			malformed.emplace_back().set_field(o, 0, static_cast<uint8_t>(orbit.orientations << layout.position_bits));
+		}
+		if (orbit.count > 1) {
+			auto &duplicated{ malformed.emplace_back() };
+			duplicated.set_field(o, 0, duplicated.field(o, 1));
+		}
+	}
+	for (const auto &state : malformed) {
+		if (group->reachable(state) || !puzzle_group<Puzzle>::cycles(state).empty()) {
+			fmt::print("{}: a malformed state is taken for a state!\n", name);
+			return false;
+		}
+	}
+
+	// the commutator of the first two faces
+	state_type algorithm;
+	algorithm.apply(state_type::make_move(0, 1));
+	algorithm.apply(state_type::make_move(1, 1));
+	algorithm.apply(state_type::make_move(0, state_type::turn_order - 1));
+	algorithm.apply(state_type::make_move(1, state_type::turn_order - 1));
+	const auto algorithm_order{ puzzle_group<Puzzle>::algorithm_order(algorithm) };
+	if (algorithm_order != order(puzzle_group<Puzzle>::to_permutation(algorithm))) {
+		fmt::print("{}: the cycles and the permutation disagree on the order!\n", name);
+		return false;
+	}
+	fmt::print("{}: the commutator of the first two faces has the order {} and {} cycles\n",
+		name, algorithm_order, puzzle_group<Puzzle>::cycles(algorithm).size());
+	return true;
+}
+
+} // anonymous namespace
+
+int main() {
+	const bool verified{
+		measure_group<puzzles::cube_2x2>("cube_2x2") &&
+		measure_group<puzzles::cube_3x3>("cube_3x3") &&
+		measure_group<puzzles::pyraminx>("pyraminx") &&
+		measure_group<puzzles::skewb>("skewb") &&
+		measure_group<puzzles::megaminx>("megaminx")
+	};
+	return verified ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,93 @@
+#include <array>
+#include <random>
+#include <vector>
+#include <filesystem>
+#include <string_view>
+
+#include "game/magicube/solver/reduction_solver.hpp"
+#include "benchmarks/benchmark.hpp"
+
+int main() {
+	using namespace gzn;
+	using namespace gzn::game::magicube;
+
+	const auto directory{ std::filesystem::temp_directory_path() };
+	const auto tables{ two_phase_tables::load_or_generate(directory / "magicube_benchmark_two_phase.tables") };
+	auto pocket{ pocket_table::load_or_generate(directory / "magicube_benchmark_pocket.table") };
+	if (!tables || !pocket) {
+		return EXIT_FAILURE;
+	}
+	const auto shared_pocket{ std::make_shared<const pocket_table>(std::move(*pocket)) };
+	// the outer 3x3 stage searched on the calling thread, then split between the threads of the pool
+	const std::array<reduction_solver, 2> solvers{ reduction_solver{ tables, shared_pocket, 1 },
+		reduction_solver{ tables, shared_pocket } };
+	const std::array<std::string_view, 2> solver_names{ "1 thread", "pool" };
+
+	constexpr size_t scramble_count{ 64 };
+	constexpr size_t scramble_length{ 200 };
+	std::mt19937_64 engine{ 0x726564756365ull };
+	for (size_t size{ reduction_solver::min_size }; size <= reduction_solver::max_size; ++size) {
+		const auto prepare_name{ fmt::format("reduction_solver {}x{}: prepare", size, size) };
+		benchmarks::measure(prepare_name, 1, [size] {
+			reduction_solver::prepare(size);
+		});
+
+		std::vector<big_cube> cubes(scramble_count, *big_cube::create(size));
+		for (auto &cube : cubes) {
+			for (size_t i{}; i < scramble_length; ++i) {
+				cube.turn_layer(static_cast<face>(engine() % face_count), engine() % size, static_cast<uint8_t>(1 + engine() % 3));
+			}
+		}
+
+		for (size_t s{}; s < solvers.size(); ++s) {
+			const auto &solver{ solvers[s] };
+			auto scrambled{ cubes };
+			std::vector<reduction_solution> solutions(scramble_count);
+			bool solved{ true };
+			const auto solve_name{ fmt::format("reduction_solver {}x{} on {}: solve", size, size, solver_names[s]) };
+			const auto measured{ benchmarks::measure(solve_name, scramble_count, [&solver, &cubes, &solutions, &solved] {
+				for (size_t i{}; i < scramble_count; ++i) {
+					auto solution{ solver.solve(cubes[i]) };
+					solved = solved && solution;
+					solutions[i] = solution ? std::move(*solution) : reduction_solution{};
+				}
+			}) };
+			if (!solved) {
+				fmt::print("{}x{} on {}: a scramble wasn't solved!\n", size, size, solver_names[s]);
+				return EXIT_FAILURE;
+			}
+
+			reduction_timings sum{};
+			std::chrono::microseconds slowest{};
+			size_t turns{};
+			for (size_t i{}; i < scramble_count; ++i) {
+				const auto &[solution, timings]{ solutions[i] };
+				for (const auto &t : solution) {
+					static_cast<void>(scrambled[i].apply(t));
+				}
+				if (!scrambled[i].solved()) {
+					fmt::print("{}x{} on {}: a solution doesn't solve its scramble!\n", size, size, solver_names[s]);
+					return EXIT_FAILURE;
+				}
+				turns += solution.size();
+				sum.outer += timings.outer;
+				sum.parity += timings.parity;
+				sum.centres += timings.centres;
+				sum.wings += timings.wings;
+				sum.orbits += timings.orbits;
+				slowest = std::max(slowest, timings.total);
+			}
+
+			const auto average{ [](const std::chrono::microseconds total) {
+				return static_cast<double>(total.count()) / 1000.0 / static_cast<double>(scramble_count);
+			} };
+			fmt::print("{}x{} on {}: {:.2f} ms per solve, {:.2f} ms at most, {:.1f} turns; outer layers {:.3f} ms, "
+				"parity {:.3f} ms, centres {:.3f} ms, wings {:.3f} ms, the orbit stage {:.3f} ms\n",
+				size, size, solver_names[s], measured.seconds * 1000.0 / static_cast<double>(scramble_count),
+				static_cast<double>(slowest.count()) / 1000.0, static_cast<double>(turns) / static_cast<double>(scramble_count),
+				average(sum.outer), average(sum.parity), average(sum.centres), average(sum.wings), average(sum.orbits));
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
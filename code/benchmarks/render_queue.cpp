@@ -0,0 +1,62 @@
+#include <array>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+#include "core/render/render_queue.hpp"
+#include "benchmarks/benchmark.hpp"
+
+int main() {
+	using namespace gzn;
+	using namespace gzn::core::render;
+
+	constexpr std::array<size_t, 5> counts{ 64, 1024, 8192, 65536, 262144 };
+	constexpr size_t items_count{ 1u << 22 };
+
+	std::mt19937_64 engine{ 0x72656e6465727175ull };
+	for (const auto count : counts) {
+		// a few programs, vertex arrays and materials, and the depth of every item
+		std::vector<keyed_draw> frame(count);
+		for (size_t i{}; i < count; ++i) {
+			draw_item item{};
+			item.vao = static_cast<uint32_t>(1 + engine() % 8);
+			item.material = static_cast<uint16_t>(engine() % 32);
+			item.depth = static_cast<float>(engine() % 100000) / 100000.0f;
+			frame[i] = { render_queue::sort_key(item) | (engine() % 4) << 48, static_cast<uint32_t>(i) };
+		}
+		const auto frames{ items_count / count };
+
+		std::vector<keyed_draw> keys;
+		std::vector<keyed_draw> scratch;
+		const auto radix_name{ fmt::format("render_queue {} items: sort_keys", count) };
+		benchmarks::measure(radix_name, frames * count, [&] {
+			for (size_t f{}; f < frames; ++f) {
+				keys = frame;
+				render_queue::sort_keys(keys, scratch);
+			}
+			benchmarks::do_not_optimize(keys);
+		});
+		const auto radix_sorted{ keys };
+
+		const auto std_name{ fmt::format("render_queue {} items: std::stable_sort", count) };
+		benchmarks::measure(std_name, frames * count, [&] {
+			for (size_t f{}; f < frames; ++f) {
+				keys = frame;
+				std::stable_sort(keys.begin(), keys.end(), [](const keyed_draw &lhs, const keyed_draw &rhs) {
+					return lhs.key < rhs.key;
+				});
+			}
+			benchmarks::do_not_optimize(keys);
+		});
+
+		const auto same{ std::equal(keys.begin(), keys.end(), radix_sorted.begin(), [](const keyed_draw &lhs, const keyed_draw &rhs) {
+			return lhs.key == rhs.key && lhs.index == rhs.index;
+		}) };
+		if (!same) {
+			fmt::print("sort_keys of {} items differs from std::stable_sort!\n", count);
+			return EXIT_FAILURE;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
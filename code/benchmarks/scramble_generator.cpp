@@ -0,0 +1,129 @@
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <filesystem>
+
+#include <core/tools/task_pool.hpp>
+
+#include "game/magicube/scramble/scramble_generator.hpp"
+#include "benchmarks/benchmark.hpp"
+
+int main() {
+	using namespace gzn;
+	using namespace gzn::game::magicube;
+
+	constexpr size_t number_count{ 1u << 26 };
+	core::tools::philox4x32 philox{ 1, 0 };
+	uint32_t philox_sum{};
+	benchmarks::measure("philox4x32: next", number_count, [&philox, &philox_sum] {
+		for (size_t i{}; i < number_count; ++i) {
+			philox_sum += philox();
+		}
+		benchmarks::do_not_optimize(philox_sum);
+	});
+	std::mt19937_64 mersenne{ 1 };
+	uint64_t mersenne_sum{};
+	benchmarks::measure("mt19937_64: next", number_count, [&mersenne, &mersenne_sum] {
+		for (size_t i{}; i < number_count; ++i) {
+			mersenne_sum += mersenne();
+		}
+		benchmarks::do_not_optimize(mersenne_sum);
+	});
+
+	constexpr uint64_t seed{ 2024 };
+	constexpr size_t state_count{ 1u << 18 };
+	std::vector<cube_state> states(state_count);
+	benchmarks::measure("random_scramble_state: sequential", state_count, [&states] {
+		for (size_t i{}; i < state_count; ++i) {
+			states[i] = random_scramble_state(seed, i);
+		}
+	});
+
+	// the streams don't depend on the thread or the order
+	std::vector<cube_state> parallel(state_count);
+	core::tools::task_pool pool;
+	constexpr size_t task_count{ 64 };
+	benchmarks::measure("random_scramble_state: task pool", state_count, [&pool, &parallel] {
+		core::tools::task_group tasks;
+		for (size_t task{}; task < task_count; ++task) {
+			pool.submit(tasks, [&parallel, task] {
+				for (size_t i{ task }; i < state_count; i += task_count) {
+					parallel[i] = random_scramble_state(seed, i);
+				}
+			});
+		}
+		pool.wait(tasks);
+	});
+	if (parallel != states) {
+		fmt::print("The states drawn on the pool differ from the sequential ones!\n");
+		return EXIT_FAILURE;
+	}
+
+	std::array<size_t, corner_count> first_corner{};
+	std::array<size_t, 3> first_twist{};
+	for (const auto &state : states) {
+		const auto cubies{ state.to_cubies() };
+		if (!is_solvable(cubies)) {
+			fmt::print("A random state isn't solvable!\n");
+			return EXIT_FAILURE;
+		}
+		++first_corner[cubies.cp[0]];
+		++first_twist[cubies.co[0]];
+	}
+	const auto uniform{ [](const auto &counts) {
+		const auto expected{ static_cast<double>(state_count) / static_cast<double>(counts.size()) };
+		return std::all_of(counts.begin(), counts.end(), [expected](const size_t count) {
+			return std::abs(static_cast<double>(count) - expected) < 0.02 * expected;
+		});
+	} };
+	if (!uniform(first_corner) || !uniform(first_twist)) {
+		fmt::print("The random states aren't uniform!\n");
+		return EXIT_FAILURE;
+	}
+
+	const auto tables{ two_phase_tables::load_or_generate(std::filesystem::temp_directory_path() / "magicube_benchmark_two_phase.tables") };
+	if (!tables) {
+		return EXIT_FAILURE;
+	}
+	const two_phase_solver solver{ tables };
+	const scramble_options options;
+
+	constexpr size_t scramble_count{ 128 };
+	std::vector<move_sequence> scrambles(scramble_count);
+	const auto measured{ benchmarks::measure("scramble_generator: scramble", scramble_count, [&solver, &options, &states, &scrambles] {
+		for (size_t i{}; i < scramble_count; ++i) {
+			scrambles[i] = scramble_generator::scramble(solver, states[i], options.solver).value_or(move_sequence{});
+		}
+	}) };
+
+	std::vector<uint8_t> packed;
+	size_t moves{};
+	for (size_t i{}; i < scramble_count; ++i) {
+		cube_state scrambled;
+		scrambled.apply(scrambles[i]);
+		if (scrambles[i].empty() || scrambled != states[i]) {
+			fmt::print("A scramble doesn't lead to its state!\n");
+			return EXIT_FAILURE;
+		}
+		pack_scramble(scrambles[i], packed);
+		moves += scrambles[i].size();
+	}
+	size_t offset{};
+	for (size_t i{}; i < scramble_count; ++i) {
+		move_sequence unpacked;
+		const auto size{ unpack_scramble(packed.data() + offset, packed.size() - offset, unpacked) };
+		if (size == 0 || unpacked != scrambles[i]) {
+			fmt::print("A packed scramble doesn't unpack to itself!\n");
+			return EXIT_FAILURE;
+		}
+		offset += size;
+	}
+	fmt::print("{:.2f} ms per scramble of {:.2f} moves on average, {:.2f} bytes per record\n",
+		measured.seconds * 1000.0 / static_cast<double>(scramble_count),
+		static_cast<double>(moves) / static_cast<double>(scramble_count),
+		static_cast<double>(packed.size()) / static_cast<double>(scramble_count));
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,45 @@
+#include <vector>
+
+#include "game/magicube/cube/symmetry.hpp"
+#include "benchmarks/benchmark.hpp"
+
+int main() {
+	using namespace gzn;
+	using namespace gzn::game::magicube;
+
+	const auto moves{ benchmarks::random_moves(1u << 20) };
+	std::vector<cube_state> states(moves.size());
+	cube_state state;
+	for (size_t i{}; i < states.size(); ++i) {
+		state.apply(moves[i]);
+		states[i] = state;
+	}
+
+	benchmarks::measure("symmetry: conjugate", states.size() * symmetry_count, [&states] {
+		uint64_t combined{};
+		for (const auto &s : states) {
+			for (symmetry sym{}; sym < symmetry_count; ++sym) {
+				combined ^= conjugate(s, sym).corners();
+			}
+		}
+		benchmarks::do_not_optimize(combined);
+	});
+
+	benchmarks::measure("symmetry: canonical (48)", states.size(), [&states] {
+		uint64_t combined{};
+		for (const auto &s : states) {
+			combined ^= canonical(s).state.hash();
+		}
+		benchmarks::do_not_optimize(combined);
+	});
+
+	benchmarks::measure("symmetry: canonical with inverse (96)", states.size(), [&states] {
+		uint64_t combined{};
+		for (const auto &s : states) {
+			combined ^= canonical(s, true).state.hash();
+		}
+		benchmarks::do_not_optimize(combined);
+	});
+
+	return EXIT_SUCCESS;
+}
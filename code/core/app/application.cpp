@@ -1,3 +1,5 @@
+#include <chrono>
+
 #define GLFW_INCLUDE_NONE
 #include <GLFW/glfw3.h>
 #include <fmt/format.h>
@@ -9,6 +11,7 @@
 #include "core/app/application.hpp"
 #include "core/app/window.hpp"
 #include "core/io/inputs.hpp"
+#include "core/render/gl_counters.hpp"
 
 namespace gzn::core {
 
@@ -25,7 +28,10 @@ std::unique_ptr<application> application::create() {
 		return nullptr;
 	}
 
+	const auto start{ std::chrono::steady_clock::now() };
 	if (std::unique_ptr<application> app{ new application{} }; app && app->initialized()) {
+		spdlog::info("[application::create] The window and OpenGL were ready in {:.2f} ms",
+			std::chrono::duration<double, std::milli>{ std::chrono::steady_clock::now() - start }.count());
 		s_instance_exists = true;
 		return std::move(app);
 	}
@@ -33,6 +39,7 @@ std::unique_ptr<application> application::create() {
 }
 
 application::~application() {
+	m_render_queue.reset(); // its buffer needs the context of the window
 	m_window.reset(); // to ensure that window will be destroyed before glfwTerminate
 	glfwTerminate();
 }
@@ -51,6 +58,7 @@ application::application() : m_window{ std::make_unique<window>() } {
 
 	glbinding::initialize(glfwGetProcAddress);
 	gl::glEnable(gl::GL_DEPTH_TEST);
+	m_render_queue = std::make_unique<render::render_queue>();
 }
 
 auto application::run() -> exit_code_type {
@@ -67,8 +75,10 @@ auto application::run() -> exit_code_type {
 	);
 	constexpr std::string_view title_format{ "[{:>5} FPS] {}" };
 
+	const auto start{ std::chrono::steady_clock::now() };
 	m_game->start();
 
+	bool first_frame{ true };
 	tools::clock<double> clock;
 	while (!m_window->should_close()) {
 		m_window->poll_events();
@@ -85,9 +95,17 @@ auto application::run() -> exit_code_type {
 
 		gl::glClear(gl::GL_COLOR_BUFFER_BIT | gl::GL_DEPTH_BUFFER_BIT);
 
-		m_game->draw(/* render */);
+		m_game->draw(*m_render_queue);
+		m_render_queue->flush();
+		render::gl_counters::end_frame();
 
 		m_window->swap_buffers();
+
+		if (first_frame) {
+			first_frame = false;
+			spdlog::info("[application::run] The first frame was presented {:.2f} ms after the start of the game",
+				std::chrono::duration<double, std::milli>{ std::chrono::steady_clock::now() - start }.count());
+		}
 	}
 
 	m_game->stop();
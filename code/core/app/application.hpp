@@ -6,6 +6,7 @@
 #include "core/defaults.hpp"
 #include "core/app/game_base.hpp"
 #include "core/app/window.hpp"
+#include "core/render/render_queue.hpp"
 
 struct GLFWwindow;
 
@@ -34,6 +35,8 @@ private:
 	inline static bool s_instance_exists{ false };
 	std::shared_ptr<game_base> m_game{ nullptr };
 	std::unique_ptr<window> m_window{ nullptr };
+	/// The draws of the game, submitted once it has drawn the frame
+	std::unique_ptr<render::render_queue> m_render_queue{ nullptr };
 
 	application();
 
@@ -4,13 +4,17 @@ namespace gzn::core {
 
 enum class notification_type;
 
+namespace render {
+class render_queue;
+} // namespace render
+
 class game_base {
 public:
 	virtual ~game_base() = default;
 
 	virtual void start() = 0;
 	virtual void update(const double delta) = 0;
-	virtual void draw() = 0;
+	virtual void draw(render::render_queue &queue) = 0;
 	virtual void stop() = 0;
 
 	virtual void pause() = 0;
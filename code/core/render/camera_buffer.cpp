@@ -0,0 +1,99 @@
+#include <cstddef>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+#include <glbinding/gl/gl.h>
+
+#include "core/render/gl_counters.hpp"
+#include "core/render/camera_buffer.hpp"
+
+namespace gzn::core::render {
+
+namespace {
+
+constexpr uint8_t camera_view_bit{ 1u << 0 };
+constexpr uint8_t camera_projection_bit{ 1u << 1 };
+constexpr uint8_t camera_view_projection_bit{ 1u << 2 };
+constexpr size_t camera_matrix_size{ sizeof(glm::mat4x4) };
+
+} // anonymous namespace
+
+std::optional<camera_buffer> camera_buffer::create() {
+	uint32_t buffer{};
+	gl::glGenBuffers(1, &buffer);
+	if (buffer == 0) {
+		spdlog::error("[camera_buffer::create] Failed to create the uniform buffer");
+		return std::nullopt;
+	}
+
+	camera_buffer camera{ buffer };
+	gl::glBindBuffer(gl::GL_UNIFORM_BUFFER, buffer);
+	gl::glBufferData(gl::GL_UNIFORM_BUFFER, sizeof(block), &camera.m_block, gl::GL_DYNAMIC_DRAW);
+	gl::glBindBufferBase(gl::GL_UNIFORM_BUFFER, binding, buffer);
+	return camera;
+}
+
+camera_buffer::camera_buffer(const uint32_t buffer) noexcept : m_buffer{ buffer } {}
+
+camera_buffer::~camera_buffer() {
+	if (m_buffer != 0) {
+		gl::glDeleteBuffers(1, &m_buffer);
+	}
+}
+
+camera_buffer::camera_buffer(camera_buffer &&other) noexcept
+	: m_buffer{ std::exchange(other.m_buffer, 0) }
+	, m_block{ other.m_block }
+	, m_dirty{ other.m_dirty } {}
+
+camera_buffer &camera_buffer::operator=(camera_buffer &&other) noexcept {
+	if (this != &other) {
+		if (m_buffer != 0) {
+			gl::glDeleteBuffers(1, &m_buffer);
+		}
+		m_buffer = std::exchange(other.m_buffer, 0);
+		m_block = other.m_block;
+		m_dirty = other.m_dirty;
+	}
+	return *this;
+}
+
+void camera_buffer::set_view(const glm::mat4x4 &view) noexcept {
+	if (view == m_block.view) return;
+
+	m_block.view = view;
+	m_block.view_projection = m_block.projection * view;
+	m_dirty |= camera_view_bit | camera_view_projection_bit;
+}
+
+void camera_buffer::set_projection(const glm::mat4x4 &projection) noexcept {
+	if (projection == m_block.projection) return;
+
+	m_block.projection = projection;
+	m_block.view_projection = projection * m_block.view;
+	m_dirty |= camera_projection_bit | camera_view_projection_bit;
+}
+
+void camera_buffer::upload() noexcept {
+	// a still camera saves the bind and the upload
+	if (m_dirty == 0) {
+		gl_counters::saved(2);
+		return;
+	}
+
+	// one range from the first dirty matrix to the last one
+	size_t first{};
+	while ((m_dirty & (1u << first)) == 0) ++first;
+	size_t last{ 2 };
+	while ((m_dirty & (1u << last)) == 0) --last;
+
+	const auto offset{ first * camera_matrix_size };
+	const auto size{ (last - first + 1) * camera_matrix_size };
+	gl::glBindBuffer(gl::GL_UNIFORM_BUFFER, m_buffer);
+	gl::glBufferSubData(gl::GL_UNIFORM_BUFFER, static_cast<gl::GLintptr>(offset), static_cast<gl::GLsizeiptr>(size),
+		reinterpret_cast<const std::byte *>(&m_block) + offset);
+	gl_counters::issued(2);
+	m_dirty = 0;
+}
+
+} // namespace gzn::core::render
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <optional>
+#include <cinttypes>
+#include <string_view>
+#include <glm/mat4x4.hpp>
+
+namespace gzn::core::render {
+
+/// @brief The camera of the frame in a uniform buffer bound once to `binding`, shared by every
+/// program which declares the block:
+///
+///     layout (std140) uniform camera {
+///         mat4 view;
+///         mat4 projection;
+///         mat4 view_projection;
+///     };
+///
+/// The matrices are uploaded by `upload` only when they changed, as one range over the dirty
+/// ones, so a still camera costs no call at all.
+class camera_buffer {
+public:
+	static constexpr std::string_view block_name{ "camera" };
+	static constexpr uint32_t binding{ 0 };
+
+	struct block {
+		glm::mat4x4 view{ 1.0f };
+		glm::mat4x4 projection{ 1.0f };
+		glm::mat4x4 view_projection{ 1.0f };
+	};
+	static_assert(sizeof(block) == 3 * 64, "the std140 layout of the block");
+
+	[[nodiscard]] static std::optional<camera_buffer> create();
+
+	~camera_buffer();
+
+	camera_buffer(const camera_buffer &other) = delete;
+	camera_buffer(camera_buffer &&other) noexcept;
+	camera_buffer &operator=(const camera_buffer &other) = delete;
+	camera_buffer &operator=(camera_buffer &&other) noexcept;
+
+	void set_view(const glm::mat4x4 &view) noexcept;
+	void set_projection(const glm::mat4x4 &projection) noexcept;
+
+	[[nodiscard]] const block &data() const noexcept { return m_block; }
+
+	/// @brief Sends the matrices which changed since the previous upload
+	void upload() noexcept;
+
+private:
+	uint32_t m_buffer{};
+	block m_block{};
+	/// Bits of the dirty matrices, in the order of the block
+	uint8_t m_dirty{};
+
+	explicit camera_buffer(const uint32_t buffer) noexcept;
+};
+
+} // namespace gzn::core::render
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cinttypes>
+
+namespace gzn::core::render {
+
+struct gl_frame_counters {
+	uint32_t issued{};
+	uint32_t saved{};
+};
+
+/// @brief Counts the state calls of the render wrappers on the GL thread: those which reached
+/// the driver and those skipped because the value or the binding was already there
+class gl_counters {
+public:
+	static void issued(const uint32_t count = 1) noexcept { s_current.issued += count; }
+	static void saved(const uint32_t count = 1) noexcept { s_current.saved += count; }
+
+	/// @brief Called by the application once the game has drawn
+	static void end_frame() noexcept {
+		s_last = s_current;
+		s_current = {};
+	}
+
+	[[nodiscard]] static const gl_frame_counters &last_frame() noexcept { return s_last; }
+
+private:
+	inline static gl_frame_counters s_current{};
+	inline static gl_frame_counters s_last{};
+};
+
+} // namespace gzn::core::render
@@ -0,0 +1,268 @@
+#include <cstring>
+#include <utility>
+#include <algorithm>
+
+#include <magic_enum.hpp>
+#include <spdlog/spdlog.h>
+#include <glm/gtc/type_ptr.hpp>
+#include <glbinding/gl/gl.h>
+
+#include "core/render/gl_counters.hpp"
+#include "core/render/camera_buffer.hpp"
+#include "core/render/program.hpp"
+
+namespace gzn::core::render {
+
+namespace {
+
+[[nodiscard]] std::optional<uint32_t> compile_program_shader(const std::string_view program_name,
+	const std::string_view source_code, const gl::GLenum type) {
+	const uint32_t shader{ gl::glCreateShader(type) };
+	const auto *text{ source_code.data() };
+	const auto text_length{ static_cast<gl::GLint>(source_code.length()) };
+	gl::glShaderSource(shader, 1, &text, &text_length);
+	gl::glCompileShader(shader);
+	int32_t success{};
+	gl::glGetShaderiv(shader, gl::GL_COMPILE_STATUS, &success);
+	if (!success) {
+		char info_log[512];
+		gl::glGetShaderInfoLog(shader, sizeof(info_log), nullptr, info_log);
+		spdlog::error("[program::create] Failed to compile '{}' shader of '{}': {}",
+			magic_enum::enum_name(type), program_name, info_log);
+		gl::glDeleteShader(shader);
+		return std::nullopt;
+	}
+	return shader;
+}
+
+[[nodiscard]] uint32_t uniform_value_size(const gl::GLenum type) noexcept {
+	switch (type) {
+		case gl::GL_INT:
+		case gl::GL_UNSIGNED_INT:
+		case gl::GL_BOOL:
+		case gl::GL_FLOAT:
+		case gl::GL_SAMPLER_2D:
+		case gl::GL_SAMPLER_CUBE:
+			return 4;
+		case gl::GL_FLOAT_VEC3: return 12;
+		case gl::GL_FLOAT_VEC4: return 16;
+		case gl::GL_FLOAT_MAT4: return 64;
+		default: return 0;
+	}
+}
+
+} // anonymous namespace
+
+std::optional<program> program::create(const std::string_view name,
+	const std::string_view vertex_source, const std::string_view fragment_source) {
+	const auto vertex_shader{ compile_program_shader(name, vertex_source, gl::GL_VERTEX_SHADER) };
+	const auto fragment_shader{ compile_program_shader(name, fragment_source, gl::GL_FRAGMENT_SHADER) };
+	if (!vertex_shader || !fragment_shader) {
+		if (vertex_shader) gl::glDeleteShader(*vertex_shader);
+		if (fragment_shader) gl::glDeleteShader(*fragment_shader);
+		return std::nullopt;
+	}
+
+	const uint32_t id{ gl::glCreateProgram() };
+	// or the driver may not keep what the program cache needs
+	gl::glProgramParameteri(id, gl::GL_PROGRAM_BINARY_RETRIEVABLE_HINT, static_cast<gl::GLint>(gl::GL_TRUE));
+	gl::glAttachShader(id, *vertex_shader);
+	gl::glAttachShader(id, *fragment_shader);
+	gl::glLinkProgram(id);
+	gl::glDetachShader(id, *vertex_shader);
+	gl::glDetachShader(id, *fragment_shader);
+	gl::glDeleteShader(*vertex_shader);
+	gl::glDeleteShader(*fragment_shader);
+	return linked(id, name, true);
+}
+
+std::optional<program> program::load(const std::string_view name, const program_binary &binary) {
+	const uint32_t id{ gl::glCreateProgram() };
+	gl::glProgramBinary(id, static_cast<gl::GLenum>(binary.format), binary.data.data(),
+		static_cast<gl::GLsizei>(binary.data.size()));
+	return linked(id, name, false);
+}
+
+std::optional<program> program::linked(const uint32_t id, const std::string_view name, const bool log_failure) {
+	int32_t success{};
+	gl::glGetProgramiv(id, gl::GL_LINK_STATUS, &success);
+	if (!success) {
+		if (log_failure) {
+			char info_log[512];
+			gl::glGetProgramInfoLog(id, sizeof(info_log), nullptr, info_log);
+			spdlog::error("[program::create] Failed to link '{}': {}", name, info_log);
+		}
+		gl::glDeleteProgram(id);
+		return std::nullopt;
+	}
+
+	program result{ id, name };
+	result.reflect();
+	return result;
+}
+
+program::program(const uint32_t id, const std::string_view name) : m_id{ id }, m_name{ name } {}
+
+program::~program() {
+	release();
+}
+
+program::program(program &&other) noexcept
+	: m_id{ std::exchange(other.m_id, 0) }
+	, m_name{ std::move(other.m_name) }
+	, m_uniforms{ std::move(other.m_uniforms) }
+	, m_values{ std::move(other.m_values) } {}
+
+program &program::operator=(program &&other) noexcept {
+	if (this != &other) {
+		release();
+		m_id = std::exchange(other.m_id, 0);
+		m_name = std::move(other.m_name);
+		m_uniforms = std::move(other.m_uniforms);
+		m_values = std::move(other.m_values);
+	}
+	return *this;
+}
+
+std::optional<program_binary> program::binary() const {
+	int32_t length{};
+	gl::glGetProgramiv(m_id, gl::GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0) {
+		return std::nullopt;
+	}
+
+	program_binary binary;
+	binary.data.resize(static_cast<size_t>(length));
+	gl::GLsizei written{};
+	gl::GLenum format{};
+	gl::glGetProgramBinary(m_id, length, &written, &format, binary.data.data());
+	if (written <= 0) {
+		return std::nullopt;
+	}
+	binary.data.resize(static_cast<size_t>(written));
+	binary.format = static_cast<uint32_t>(format);
+	return binary;
+}
+
+std::optional<program::uniform_id> program::uniform(const std::string_view name) const noexcept {
+	const auto found{ std::lower_bound(m_uniforms.begin(), m_uniforms.end(), name,
+		[](const uniform_slot &slot, const std::string_view key) { return slot.name < key; }) };
+	if (found == m_uniforms.end() || found->name != name) {
+		return std::nullopt;
+	}
+	return static_cast<uniform_id>(found - m_uniforms.begin());
+}
+
+void program::use() const noexcept {
+	if (s_bound == m_id) {
+		gl_counters::saved();
+		return;
+	}
+	gl::glUseProgram(m_id);
+	s_bound = m_id;
+	gl_counters::issued();
+}
+
+void program::set(const uniform_id id, const int32_t value) noexcept {
+	if (changed(id, &value, sizeof(value))) {
+		gl::glProgramUniform1i(m_id, m_uniforms[id].location, value);
+	}
+}
+
+void program::set(const uniform_id id, const float value) noexcept {
+	if (changed(id, &value, sizeof(value))) {
+		gl::glProgramUniform1f(m_id, m_uniforms[id].location, value);
+	}
+}
+
+void program::set(const uniform_id id, const glm::vec3 &value) noexcept {
+	if (changed(id, glm::value_ptr(value), sizeof(value))) {
+		gl::glProgramUniform3fv(m_id, m_uniforms[id].location, 1, glm::value_ptr(value));
+	}
+}
+
+void program::set(const uniform_id id, const glm::vec4 &value) noexcept {
+	if (changed(id, glm::value_ptr(value), sizeof(value))) {
+		gl::glProgramUniform4fv(m_id, m_uniforms[id].location, 1, glm::value_ptr(value));
+	}
+}
+
+void program::set(const uniform_id id, const glm::mat4x4 &value) noexcept {
+	if (changed(id, glm::value_ptr(value), sizeof(value))) {
+		gl::glProgramUniformMatrix4fv(m_id, m_uniforms[id].location, 1, gl::GL_FALSE, glm::value_ptr(value));
+	}
+}
+
+void program::reflect() {
+	int32_t count{};
+	int32_t max_length{};
+	gl::glGetProgramiv(m_id, gl::GL_ACTIVE_UNIFORMS, &count);
+	gl::glGetProgramiv(m_id, gl::GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length);
+
+	std::string name(static_cast<size_t>(std::max(max_length, 1)), '\0');
+	uint32_t values_size{};
+	for (int32_t i{}; i < count; ++i) {
+		gl::GLsizei length{};
+		gl::GLint array_size{};
+		gl::GLenum type{};
+		gl::glGetActiveUniform(m_id, static_cast<gl::GLuint>(i), max_length, &length, &array_size, &type, name.data());
+		// the members of the blocks have no location, their buffers are set instead
+		const auto location{ gl::glGetUniformLocation(m_id, name.c_str()) };
+		if (location < 0) continue;
+
+		std::string_view uniform_name{ name.data(), static_cast<size_t>(length) };
+		if (const auto bracket{ uniform_name.find('[') }; bracket != std::string_view::npos) {
+			uniform_name = uniform_name.substr(0, bracket);
+		}
+		const auto size{ uniform_value_size(type) };
+		m_uniforms.push_back(uniform_slot{ std::string{ uniform_name }, location, values_size, size });
+		values_size += size;
+	}
+	std::sort(m_uniforms.begin(), m_uniforms.end(), [](const uniform_slot &lhs, const uniform_slot &rhs) {
+		return lhs.name < rhs.name;
+	});
+	m_values.resize(values_size);
+
+	int32_t block_count{};
+	int32_t max_block_length{};
+	gl::glGetProgramiv(m_id, gl::GL_ACTIVE_UNIFORM_BLOCKS, &block_count);
+	gl::glGetProgramiv(m_id, gl::GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &max_block_length);
+	name.resize(std::max(name.size(), static_cast<size_t>(max_block_length)));
+	for (int32_t i{}; i < block_count; ++i) {
+		gl::GLsizei length{};
+		gl::glGetActiveUniformBlockName(m_id, static_cast<gl::GLuint>(i), static_cast<gl::GLsizei>(name.size()), &length, name.data());
+		if (std::string_view{ name.data(), static_cast<size_t>(length) } == camera_buffer::block_name) {
+			gl::glUniformBlockBinding(m_id, static_cast<gl::GLuint>(i), camera_buffer::binding);
+		}
+	}
+
+	spdlog::info("[program::reflect] '{}' has {} uniforms and {} blocks", m_name, m_uniforms.size(), block_count);
+}
+
+bool program::changed(const uniform_id id, const void *value, const uint32_t size) noexcept {
+	if (id >= m_uniforms.size() || m_uniforms[id].size != size) {
+		return false;
+	}
+	auto &slot{ m_uniforms[id] };
+	auto *last{ m_values.data() + slot.offset };
+	if (slot.written && std::memcmp(last, value, size) == 0) {
+		gl_counters::saved();
+		return false;
+	}
+	std::memcpy(last, value, size);
+	slot.written = true;
+	gl_counters::issued();
+	return true;
+}
+
+void program::release() noexcept {
+	if (m_id == 0) return;
+
+	if (s_bound == m_id) {
+		s_bound = 0;
+	}
+	gl::glDeleteProgram(m_id);
+	m_id = 0;
+}
+
+} // namespace gzn::core::render
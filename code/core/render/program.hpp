@@ -0,0 +1,91 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <optional>
+#include <cinttypes>
+#include <string_view>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+
+namespace gzn::core::render {
+
+/// @brief A linked program as the driver stores it, only valid for the same driver
+struct program_binary {
+	uint32_t format{};
+	std::vector<std::byte> data;
+};
+
+/// @brief A linked GLSL program. Its active uniforms are reflected once at link time, so a
+/// uniform is looked up by name only when it's first needed, and every value set is kept to
+/// skip the calls which wouldn't change it. The values are set with `glProgramUniform*`, so the
+/// program doesn't have to be bound.
+class program {
+public:
+	using uniform_id = uint32_t;
+
+	/// @returns Nothing if a shader fails to compile or the program fails to link
+	[[nodiscard]] static std::optional<program> create(const std::string_view name,
+		const std::string_view vertex_source, const std::string_view fragment_source);
+	/// @returns Nothing if the driver rejects @p binary, which it does after an update
+	[[nodiscard]] static std::optional<program> load(const std::string_view name, const program_binary &binary);
+
+	~program();
+
+	program(const program &other) = delete;
+	program(program &&other) noexcept;
+	program &operator=(const program &other) = delete;
+	program &operator=(program &&other) noexcept;
+
+	[[nodiscard]] uint32_t id() const noexcept { return m_id; }
+	[[nodiscard]] const std::string &name() const noexcept { return m_name; }
+	/// @returns Nothing if the driver keeps no binary of the program
+	[[nodiscard]] std::optional<program_binary> binary() const;
+
+	/// @returns Nothing if the program has no such active uniform, which the compiler may have
+	/// optimized out
+	[[nodiscard]] std::optional<uniform_id> uniform(const std::string_view name) const noexcept;
+
+	/// @brief Binds the program unless it's bound already
+	void use() const noexcept;
+
+	void set(const uniform_id id, const int32_t value) noexcept;
+	void set(const uniform_id id, const float value) noexcept;
+	void set(const uniform_id id, const glm::vec3 &value) noexcept;
+	void set(const uniform_id id, const glm::vec4 &value) noexcept;
+	void set(const uniform_id id, const glm::mat4x4 &value) noexcept;
+
+private:
+	struct uniform_slot {
+		std::string name;
+		int32_t location{ -1 };
+		/// Where the last value is kept in `m_values`
+		uint32_t offset{};
+		/// The size of the value, 0 for the types which can't be set
+		uint32_t size{};
+		bool written{ false };
+	};
+
+	inline static uint32_t s_bound{};
+
+	uint32_t m_id{};
+	std::string m_name;
+	/// Sorted by name
+	std::vector<uniform_slot> m_uniforms;
+	std::vector<std::byte> m_values;
+
+	program(const uint32_t id, const std::string_view name);
+
+	/// @returns Nothing, and deletes @p id, if it isn't linked
+	[[nodiscard]] static std::optional<program> linked(const uint32_t id, const std::string_view name, const bool log_failure);
+
+	void reflect();
+	/// @returns false if @p value is the last one set, which counts a saved call, or doesn't
+	/// fit the uniform
+	[[nodiscard]] bool changed(const uniform_id id, const void *value, const uint32_t size) noexcept;
+	void release() noexcept;
+};
+
+} // namespace gzn::core::render
@@ -0,0 +1,148 @@
+#include <chrono>
+#include <fstream>
+#include <system_error>
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+#include <glbinding/gl/gl.h>
+
+#include "core/render/program_cache.hpp"
+
+namespace gzn::core::render {
+
+namespace {
+
+using program_cache_clock = std::chrono::steady_clock;
+
+constexpr uint32_t program_file_magic{ 0x4752504D }; // "MPRG"
+constexpr uint32_t program_file_version{ 1 };
+
+struct program_file_header {
+	uint32_t magic{ program_file_magic };
+	uint32_t version{ program_file_version };
+	uint64_t key{};
+	uint32_t format{};
+	uint32_t size{};
+};
+static_assert(sizeof(program_file_header) == 24);
+/// Far above any real program, only a corrupted file comes close
+constexpr uint32_t max_program_binary_size{ 64u << 20 };
+
+/// 64-bit FNV-1a, chained through @p hash
+[[nodiscard]] constexpr uint64_t program_hash(const std::string_view text, uint64_t hash = 0xCBF29CE484222325) noexcept {
+	for (const auto c : text) {
+		hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001B3;
+	}
+	// the end of every string, so that moving text from one to the next changes the hash
+	return (hash ^ 0xFF) * 0x100000001B3;
+}
+
+[[nodiscard]] std::string_view driver_string(const gl::GLenum name) {
+	const auto *text{ reinterpret_cast<const char *>(gl::glGetString(name)) };
+	return text != nullptr ? std::string_view{ text } : std::string_view{};
+}
+
+[[nodiscard]] double program_cache_milliseconds(const program_cache_clock::time_point start) noexcept {
+	return std::chrono::duration<double, std::milli>{ program_cache_clock::now() - start }.count();
+}
+
+} // anonymous namespace
+
+program_cache::program_cache(const std::filesystem::path &directory) : m_directory{ directory } {
+	const auto vendor{ driver_string(gl::GL_VENDOR) };
+	const auto renderer{ driver_string(gl::GL_RENDERER) };
+	const auto version{ driver_string(gl::GL_VERSION) };
+	m_driver_hash = program_hash(version, program_hash(renderer, program_hash(vendor)));
+
+	int32_t formats{};
+	gl::glGetIntegerv(gl::GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+	m_supported = formats > 0;
+	if (!m_supported) {
+		spdlog::warn("[program_cache::program_cache] '{}' can't give back the program binaries, "
+			"every program will be compiled", renderer);
+		return;
+	}
+
+	std::error_code error;
+	std::filesystem::create_directories(m_directory, error);
+	if (error) {
+		spdlog::warn("[program_cache::program_cache] Failed to create '{}': {}", m_directory.string(), error.message());
+	}
+}
+
+std::optional<program> program_cache::load_or_build(const std::string_view name,
+	const std::string_view vertex_source, const std::string_view fragment_source) {
+	const auto start{ program_cache_clock::now() };
+	const auto path{ m_directory / fmt::format("{}.program", name) };
+	const auto key{ program_hash(fragment_source, program_hash(vertex_source, m_driver_hash)) };
+
+	if (m_supported) {
+		if (const auto binary{ load(path, key) }) {
+			if (auto loaded{ program::load(name, *binary) }) {
+				spdlog::info("[program_cache::load_or_build] Loaded '{}' from the cache in {:.2f} ms",
+					name, program_cache_milliseconds(start));
+				return loaded;
+			}
+			spdlog::info("[program_cache::load_or_build] The driver rejected the binary of '{}'", name);
+		}
+	}
+
+	auto built{ program::create(name, vertex_source, fragment_source) };
+	if (!built) {
+		return std::nullopt;
+	}
+	spdlog::info("[program_cache::load_or_build] Compiled '{}' in {:.2f} ms", name, program_cache_milliseconds(start));
+
+	if (m_supported) {
+		const auto binary{ built->binary() };
+		if (binary && save(path, key, *binary)) {
+			spdlog::info("[program_cache::load_or_build] Saved '{}' to '{}'", name, path.string());
+		}
+	}
+	return built;
+}
+
+std::optional<program_binary> program_cache::load(const std::filesystem::path &path, const uint64_t key) const {
+	std::ifstream file{ path, std::ios::binary };
+	if (!file) {
+		return std::nullopt;
+	}
+
+	program_file_header header{};
+	if (!file.read(reinterpret_cast<char *>(&header), sizeof(header))
+		|| header.magic != program_file_magic || header.version != program_file_version) {
+		spdlog::warn("[program_cache::load] '{}' isn't a program file of version {}", path.string(), program_file_version);
+		return std::nullopt;
+	}
+	// the sources or the driver changed since it was saved
+	if (header.key != key) {
+		return std::nullopt;
+	}
+	if (header.size == 0 || header.size > max_program_binary_size) {
+		spdlog::warn("[program_cache::load] '{}' is corrupted", path.string());
+		return std::nullopt;
+	}
+
+	program_binary binary{ header.format, std::vector<std::byte>(header.size) };
+	if (!file.read(reinterpret_cast<char *>(binary.data.data()), static_cast<std::streamsize>(binary.data.size()))) {
+		spdlog::warn("[program_cache::load] '{}' is truncated", path.string());
+		return std::nullopt;
+	}
+	return binary;
+}
+
+bool program_cache::save(const std::filesystem::path &path, const uint64_t key, const program_binary &binary) const {
+	std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+	if (!file) {
+		spdlog::error("[program_cache::save] Failed to open '{}' for writing", path.string());
+		return false;
+	}
+
+	const program_file_header header{ program_file_magic, program_file_version, key,
+		binary.format, static_cast<uint32_t>(binary.data.size()) };
+	file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char *>(binary.data.data()), static_cast<std::streamsize>(binary.data.size()));
+	return static_cast<bool>(file);
+}
+
+} // namespace gzn::core::render
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <optional>
+#include <cinttypes>
+#include <filesystem>
+#include <string_view>
+
+#include "core/render/program.hpp"
+
+namespace gzn::core::render {
+
+/// @brief Keeps the linked programs on the disk, so a launch after the first one skips the
+/// compilation of the shaders. A program is stored under its name with the hash of its sources
+/// and of the driver's vendor, renderer and version: any change to them, or a binary which the
+/// driver rejects, builds the program from the sources again and replaces the file.
+class program_cache {
+public:
+	/// @note Reads the strings of the driver, so the context must be current
+	explicit program_cache(const std::filesystem::path &directory);
+
+	[[nodiscard]] std::optional<program> load_or_build(const std::string_view name,
+		const std::string_view vertex_source, const std::string_view fragment_source);
+
+	/// @returns false if the driver can't give back the binaries, and every program is built
+	[[nodiscard]] bool supported() const noexcept { return m_supported; }
+
+private:
+	std::filesystem::path m_directory;
+	/// The hash of the driver strings, which every key starts from
+	uint64_t m_driver_hash{};
+	bool m_supported{ false };
+
+	[[nodiscard]] std::optional<program_binary> load(const std::filesystem::path &path, const uint64_t key) const;
+	[[nodiscard]] bool save(const std::filesystem::path &path, const uint64_t key, const program_binary &binary) const;
+};
+
+} // namespace gzn::core::render
@@ -0,0 +1,287 @@
+#include <array>
+#include <cstring>
+#include <utility>
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+#include <glbinding/gl/gl.h>
+
+#include "core/render/render_queue.hpp"
+
+namespace gzn::core::render {
+
+namespace {
+
+using queue_clock = std::chrono::steady_clock;
+
+/// The layout `glMultiDrawElementsIndirect` reads
+struct indirect_command {
+	uint32_t count;
+	uint32_t instance_count;
+	uint32_t first_index;
+	int32_t base_vertex;
+	uint32_t base_instance;
+};
+static_assert(sizeof(indirect_command) == 20);
+
+constexpr size_t queue_radix_bits{ 8 };
+constexpr size_t queue_radix_size{ 1u << queue_radix_bits };
+constexpr uint32_t queue_depth_bits{ 20 };
+/// Below this, clearing and scanning the histograms costs more than a comparison sort
+constexpr size_t min_radix_keys{ 1024 };
+
+constexpr std::string_view draw_parameters_extension{ "GL_ARB_shader_draw_parameters" };
+
+/// The `draws` block is bound to `render_queue::draws_binding`
+constexpr std::string_view draw_parameters_model_source{ R"glsl(
+	#extension GL_ARB_shader_draw_parameters : require
+
+	layout (std430, binding = 0) readonly buffer draws {
+		mat4 models[];
+	};
+
+	mat4 draw_model() { return models[gl_DrawIDARB]; }
+)glsl" };
+
+constexpr std::string_view uniform_model_source{ R"glsl(
+	uniform mat4 model;
+
+	mat4 draw_model() { return model; }
+)glsl" };
+
+/// The command buffer holds this many draws at least, so that a growing scene rarely replaces it
+constexpr size_t min_queue_commands{ 1024 };
+
+void accumulate(stream_stats &to, const stream_stats &from) noexcept {
+	to.frames += from.frames;
+	to.fence_waits += from.fence_waits;
+	to.wait_time += from.wait_time;
+}
+
+[[nodiscard]] bool same_state(const draw_item &lhs, const draw_item &rhs) noexcept {
+	return lhs.shader == rhs.shader && lhs.vao == rhs.vao && lhs.material == rhs.material;
+}
+
+} // anonymous namespace
+
+render_queue::render_queue()
+	: m_draw_parameters{ draw_parameters_supported() } {
+	if (!m_draw_parameters) {
+		spdlog::warn("[render_queue::render_queue] The driver has no {}, every item is a draw of its own",
+			draw_parameters_extension);
+	}
+}
+
+bool render_queue::draw_parameters_supported() noexcept {
+	gl::GLint count{};
+	gl::glGetIntegerv(gl::GL_NUM_EXTENSIONS, &count);
+	for (gl::GLint i{}; i < count; ++i) {
+		const auto *name{ reinterpret_cast<const char *>(gl::glGetStringi(gl::GL_EXTENSIONS, static_cast<gl::GLuint>(i))) };
+		if (name != nullptr && std::string_view{ name } == draw_parameters_extension) {
+			return true;
+		}
+	}
+	return false;
+}
+
+std::string_view render_queue::model_source(const bool draw_parameters) noexcept {
+	return draw_parameters ? draw_parameters_model_source : uniform_model_source;
+}
+
+uint16_t render_queue::add_material(material_binder bind) {
+	if (m_materials.size() >= max_materials) {
+		spdlog::error("[render_queue::add_material] There are {} materials already", max_materials - 1);
+		return 0;
+	}
+	m_materials.push_back(std::move(bind));
+	return static_cast<uint16_t>(m_materials.size() - 1);
+}
+
+void render_queue::submit(const draw_item &item) {
+	if (item.shader == nullptr || item.index_count == 0 || item.instance_count == 0) return;
+
+	m_items.push_back(item);
+}
+
+uint64_t render_queue::sort_key(const draw_item &item) noexcept {
+	const uint64_t program_bits{ item.shader != nullptr ? item.shader->id() & 0xFFFFu : 0u };
+	const uint64_t vao_bits{ item.vao & 0xFFFFu };
+	const uint64_t material_bits{ item.material & (max_materials - 1) };
+	constexpr auto depth_scale{ static_cast<float>((1u << queue_depth_bits) - 1) };
+	const uint64_t depth_bits{ static_cast<uint64_t>(std::clamp(item.depth, 0.0f, 1.0f) * depth_scale) };
+	return program_bits << 48 | vao_bits << 32 | material_bits << queue_depth_bits | depth_bits;
+}
+
+void render_queue::sort_keys(std::vector<keyed_draw> &keys, std::vector<keyed_draw> &scratch) {
+	if (keys.size() < min_radix_keys) {
+		std::stable_sort(keys.begin(), keys.end(), [](const keyed_draw &lhs, const keyed_draw &rhs) {
+			return lhs.key < rhs.key;
+		});
+		return;
+	}
+	scratch.resize(keys.size());
+
+	// every histogram in one pass over the keys
+	std::array<std::array<uint32_t, queue_radix_size>, 64 / queue_radix_bits> counts{};
+	for (const auto &k : keys) {
+		for (size_t digit{}; digit < counts.size(); ++digit) {
+			++counts[digit][(k.key >> (digit * queue_radix_bits)) & (queue_radix_size - 1)];
+		}
+	}
+
+	for (size_t digit{}; digit < counts.size(); ++digit) {
+		auto &count{ counts[digit] };
+		const auto shift{ digit * queue_radix_bits };
+		// the depth and the high bits of the ids are mostly the same for every item
+		if (count[(keys.front().key >> shift) & (queue_radix_size - 1)] == keys.size()) continue;
+
+		uint32_t offset{};
+		for (auto &c : count) {
+			offset += std::exchange(c, offset);
+		}
+		for (const auto &k : keys) {
+			scratch[count[(k.key >> shift) & (queue_radix_size - 1)]++] = k;
+		}
+		keys.swap(scratch);
+	}
+}
+
+void render_queue::flush() {
+	const auto start{ queue_clock::now() };
+	queue_stats stats{};
+	stats.items = static_cast<uint32_t>(m_items.size());
+	if (m_items.empty()) {
+		m_last_frame = stats;
+		return;
+	}
+
+	m_keys.resize(m_items.size());
+	for (size_t i{}; i < m_items.size(); ++i) {
+		m_keys[i] = { sort_key(m_items[i]), static_cast<uint32_t>(i) };
+	}
+	sort_keys(m_keys, m_scratch);
+	stats.sort_time = queue_clock::now() - start;
+
+	std::optional<stream_allocation> allocation;
+	if (m_draw_parameters) {
+		allocation = reserve(m_items.size())
+			? m_commands->allocate(m_items.size() * sizeof(indirect_command), sizeof(indirect_command)) : std::nullopt;
+		if (!allocation) {
+			spdlog::error("[render_queue::flush] No room for the commands of {} draws", m_items.size());
+			m_items.clear();
+			m_last_frame = stats;
+			return;
+		}
+		gl::glBindBuffer(gl::GL_DRAW_INDIRECT_BUFFER, m_commands->id());
+	}
+
+	const draw_item *bound{ nullptr };
+	for (size_t first{}; first < m_keys.size();) {
+		const auto &item{ m_items[m_keys[first].index] };
+		auto last{ first + 1 };
+		while (last < m_keys.size() && same_state(item, m_items[m_keys[last].index])) ++last;
+
+		if (bound == nullptr || bound->shader != item.shader) {
+			item.shader->use();
+			++stats.state_changes;
+		}
+		if (bound == nullptr || bound->vao != item.vao) {
+			gl::glBindVertexArray(item.vao);
+			++stats.state_changes;
+		}
+		if ((bound == nullptr || bound->material != item.material) && item.material != 0
+			&& item.material < m_materials.size() && m_materials[item.material]) {
+			m_materials[item.material]();
+			++stats.state_changes;
+		}
+		bound = &item;
+
+		if (!m_draw_parameters) {
+			draw_each(first, last, stats);
+			first = last;
+			continue;
+		}
+		for (auto i{ first }; i < last; ++i) {
+			const auto &draw{ m_items[m_keys[i].index] };
+			const indirect_command command{ draw.index_count, draw.instance_count, draw.first_index, draw.base_vertex, draw.base_instance };
+			std::memcpy(allocation->data + i * sizeof(indirect_command), &command, sizeof(command));
+		}
+		// `gl_DrawIDARB` starts at 0 in every multi-draw, so every run gets its own range
+		const auto models_size{ (last - first) * sizeof(glm::mat4x4) };
+		const auto models{ m_models->allocate(models_size, m_model_alignment) };
+		if (!models) {
+			spdlog::error("[render_queue::flush] No room for the models of {} draws", last - first);
+			break;
+		}
+		for (auto i{ first }; i < last; ++i) {
+			std::memcpy(models->data + (i - first) * sizeof(glm::mat4x4), &m_items[m_keys[i].index].model, sizeof(glm::mat4x4));
+		}
+		gl::glBindBufferRange(gl::GL_SHADER_STORAGE_BUFFER, draws_binding, m_models->id(),
+			static_cast<gl::GLintptr>(models->offset), static_cast<gl::GLsizeiptr>(models_size));
+
+		gl::glMultiDrawElementsIndirect(gl::GL_TRIANGLES, gl::GL_UNSIGNED_INT,
+			reinterpret_cast<const void *>(allocation->offset + first * sizeof(indirect_command)),
+			static_cast<gl::GLsizei>(last - first), 0);
+		++stats.draw_calls;
+		first = last;
+	}
+	if (m_draw_parameters) {
+		m_commands->end_frame();
+		m_models->end_frame();
+		gl::glBindBuffer(gl::GL_DRAW_INDIRECT_BUFFER, 0);
+	}
+
+	gl::glBindVertexArray(0);
+	m_items.clear();
+
+	stats.submit_time = queue_clock::now() - start;
+	m_last_frame = stats;
+}
+
+void render_queue::draw_each(const size_t first, const size_t last, queue_stats &stats) {
+	// the items of a run share the program
+	auto &shader{ *m_items[m_keys[first].index].shader };
+	const auto model{ shader.uniform(model_uniform) };
+	for (auto i{ first }; i < last; ++i) {
+		const auto &draw{ m_items[m_keys[i].index] };
+		if (model) {
+			shader.set(*model, draw.model);
+		}
+		gl::glDrawElementsInstancedBaseVertexBaseInstance(gl::GL_TRIANGLES, static_cast<gl::GLsizei>(draw.index_count),
+			gl::GL_UNSIGNED_INT, reinterpret_cast<const void *>(size_t{ draw.first_index } * sizeof(uint32_t)),
+			static_cast<gl::GLsizei>(draw.instance_count), draw.base_vertex, draw.base_instance);
+		++stats.draw_calls;
+	}
+}
+
+stream_stats render_queue::streaming() const noexcept {
+	auto stats{ m_stream_base };
+	if (m_commands) accumulate(stats, m_commands->stats());
+	if (m_models) accumulate(stats, m_models->stats());
+	return stats;
+}
+
+bool render_queue::reserve(const size_t count) {
+	if (m_model_alignment == 0) {
+		gl::GLint alignment{};
+		gl::glGetIntegerv(gl::GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+		m_model_alignment = static_cast<size_t>(std::max(alignment, 1));
+	}
+	// the regions don't start on a whole command, which may take one more
+	const auto commands_size{ [](const size_t draws) { return (draws + 1) * sizeof(indirect_command); } };
+	// every draw may be a run of its own, which starts on the alignment
+	const auto models_size{ [this](const size_t draws) { return draws * (sizeof(glm::mat4x4) + m_model_alignment); } };
+
+	const auto draws{ std::max(count, min_queue_commands) };
+	if (!m_commands || m_commands->region_size() < commands_size(count)) {
+		if (m_commands) accumulate(m_stream_base, m_commands->stats());
+		m_commands = stream_buffer::create(commands_size(draws));
+	}
+	if (!m_models || m_models->region_size() < models_size(count)) {
+		if (m_models) accumulate(m_stream_base, m_models->stats());
+		m_models = stream_buffer::create(models_size(draws));
+	}
+	return m_commands.has_value() && m_models.has_value();
+}
+
+} // namespace gzn::core::render
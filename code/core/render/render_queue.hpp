@@ -0,0 +1,128 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+#include <optional>
+#include <cinttypes>
+#include <functional>
+#include <string_view>
+#include <glm/mat4x4.hpp>
+
+#include "core/render/program.hpp"
+#include "core/render/stream_buffer.hpp"
+
+namespace gzn::core::render {
+
+/// @brief One indexed draw of triangles with 32-bit indices
+struct draw_item {
+	/// Not const, the model is set to its uniform without `GL_ARB_shader_draw_parameters`
+	program *shader{ nullptr };
+	uint32_t vao{};
+	/// 0 is no material, the others come from `render_queue::add_material`
+	uint16_t material{};
+	/// 0 is the nearest, 1 the farthest
+	float depth{};
+	/// Of the whole draw, a program reads it with `draw_model()` of `render_queue::model_source`
+	glm::mat4x4 model{ 1.0f };
+
+	uint32_t index_count{};
+	uint32_t first_index{};
+	int32_t base_vertex{};
+	uint32_t instance_count{ 1 };
+	uint32_t base_instance{};
+};
+
+struct keyed_draw {
+	uint64_t key{};
+	uint32_t index{};
+};
+
+struct queue_stats {
+	uint32_t items{};
+	/// A multi-draw for every run of items of the same program, vertex array and material, or a
+	/// draw for every item without `GL_ARB_shader_draw_parameters`
+	uint32_t draw_calls{};
+	/// Programs, vertex arrays and materials bound
+	uint32_t state_changes{};
+	std::chrono::nanoseconds sort_time{};
+	std::chrono::nanoseconds submit_time{};
+};
+
+/// @brief Collects the draws of a frame and submits them once the game has drawn. The items are
+/// sorted by a 64-bit key of their program, vertex array, material and depth, so that the state
+/// changes once per run of items sharing it, and every run is a single
+/// `glMultiDrawElementsIndirect` whose commands are streamed to a persistent mapped buffer.
+/// The models of the draws of a run are streamed next to them, to a storage buffer bound to
+/// `draws_binding`, where a program finds the model of its draw by the draw index of
+/// `GL_ARB_shader_draw_parameters`. That's not core before OpenGL 4.6, so without it every item
+/// is a draw of its own with the model in the `model_uniform` of its program. A vertex shader
+/// declares `mat4 draw_model()` for either way by `model_source` after its `#version` line.
+class render_queue {
+public:
+	using material_binder = std::function<void()>;
+
+	static constexpr std::string_view draws_block{ "draws" };
+	static constexpr uint32_t draws_binding{ 0 };
+	static constexpr std::string_view model_uniform{ "model" };
+
+	/// @note Asks the driver for `GL_ARB_shader_draw_parameters`, so the context must be current
+	render_queue();
+
+	/// @brief Whether the driver of the current context has `GL_ARB_shader_draw_parameters`
+	[[nodiscard]] static bool draw_parameters_supported() noexcept;
+	/// @brief The GLSL which declares `mat4 draw_model()`, the model of the item being drawn
+	[[nodiscard]] static std::string_view model_source(const bool draw_parameters) noexcept;
+
+	/// @returns false if every item is a draw of its own
+	[[nodiscard]] bool draw_parameters() const noexcept { return m_draw_parameters; }
+
+	/// Every material is 12 bits of the key
+	static constexpr size_t max_materials{ 1u << 12 };
+
+	/// @brief @p bind sets the state of the material, it's called before the first run of the
+	/// items of the material in a frame
+	/// @returns 0 if there are `max_materials` already
+	[[nodiscard]] uint16_t add_material(material_binder bind);
+
+	void submit(const draw_item &item);
+
+	/// @brief Sorts, batches and submits the items of the frame, then forgets them
+	void flush();
+
+	[[nodiscard]] const queue_stats &last_frame() const noexcept { return m_last_frame; }
+	/// @brief Since the creation, whatever the stream buffers the queue needed
+	[[nodiscard]] stream_stats streaming() const noexcept;
+
+	/// @brief The program in the 16 high bits, then the vertex array in 16 bits, the material
+	/// in 12 bits and the depth in the 20 low ones, front to back
+	[[nodiscard]] static uint64_t sort_key(const draw_item &item) noexcept;
+
+	/// @brief A stable LSD radix sort of @p keys by their key, a byte at a time, skipping the
+	/// bytes which every key shares. The few keys of a small frame are sorted by comparison
+	static void sort_keys(std::vector<keyed_draw> &keys, std::vector<keyed_draw> &scratch);
+
+private:
+	std::vector<draw_item> m_items;
+	std::vector<keyed_draw> m_keys;
+	std::vector<keyed_draw> m_scratch;
+	/// The index 0 is no material
+	std::vector<material_binder> m_materials{ material_binder{} };
+	/// The indirect commands, created by the first flush
+	std::optional<stream_buffer> m_commands;
+	/// The models of the draws, created by the first flush
+	std::optional<stream_buffer> m_models;
+	/// `GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT`, the models of every run start on it
+	size_t m_model_alignment{};
+	/// The stats of the stream buffers replaced by bigger ones
+	stream_stats m_stream_base{};
+	queue_stats m_last_frame{};
+	bool m_draw_parameters{ false };
+
+	/// @brief One `glDrawElementsInstancedBaseVertexBaseInstance` per item of the run
+	/// [@p first, @p last) of the sorted items
+	void draw_each(const size_t first, const size_t last, queue_stats &stats);
+	/// @brief Replaces the stream buffers if their regions can't hold @p count draws
+	[[nodiscard]] bool reserve(const size_t count);
+};
+
+} // namespace gzn::core::render
@@ -0,0 +1,134 @@
+#include <utility>
+
+#include <spdlog/spdlog.h>
+#include <glbinding/gl/gl.h>
+
+#include "core/render/stream_buffer.hpp"
+
+namespace gzn::core::render {
+
+namespace {
+
+using stream_clock = std::chrono::steady_clock;
+
+/// The regions start on this, which is at least the offset alignment of the uniform buffers
+constexpr size_t stream_region_alignment{ 256 };
+/// A wait is checked again this often, in nanoseconds
+constexpr gl::GLuint64 stream_wait_step{ 1'000'000 };
+
+[[nodiscard]] gl::GLsync stream_fence(void *fence) noexcept {
+	return static_cast<gl::GLsync>(fence);
+}
+
+} // anonymous namespace
+
+std::optional<stream_buffer> stream_buffer::create(const size_t region_size) {
+	const auto aligned_size{ (region_size + stream_region_alignment - 1) / stream_region_alignment * stream_region_alignment };
+	const auto total_size{ static_cast<gl::GLsizeiptr>(aligned_size * region_count) };
+	const auto flags{ gl::GL_MAP_WRITE_BIT | gl::GL_MAP_PERSISTENT_BIT | gl::GL_MAP_COHERENT_BIT };
+
+	uint32_t buffer{};
+	gl::glGenBuffers(1, &buffer);
+	gl::glBindBuffer(gl::GL_COPY_WRITE_BUFFER, buffer);
+	gl::glBufferStorage(gl::GL_COPY_WRITE_BUFFER, total_size, nullptr, flags);
+	auto *mapped{ static_cast<std::byte *>(gl::glMapBufferRange(gl::GL_COPY_WRITE_BUFFER, 0, total_size, flags)) };
+	gl::glBindBuffer(gl::GL_COPY_WRITE_BUFFER, 0);
+	if (mapped == nullptr) {
+		spdlog::error("[stream_buffer::create] Failed to map {} regions of {} bytes", region_count, aligned_size);
+		gl::glDeleteBuffers(1, &buffer);
+		return std::nullopt;
+	}
+	return stream_buffer{ buffer, mapped, aligned_size };
+}
+
+stream_buffer::stream_buffer(const uint32_t buffer, std::byte *mapped, const size_t region_size) noexcept
+	: m_buffer{ buffer }, m_mapped{ mapped }, m_region_size{ region_size } {}
+
+stream_buffer::~stream_buffer() {
+	release();
+}
+
+stream_buffer::stream_buffer(stream_buffer &&other) noexcept
+	: m_buffer{ std::exchange(other.m_buffer, 0) }
+	, m_mapped{ std::exchange(other.m_mapped, nullptr) }
+	, m_region_size{ other.m_region_size }
+	, m_region{ other.m_region }
+	, m_used{ other.m_used }
+	, m_acquired{ other.m_acquired }
+	, m_fences{ std::exchange(other.m_fences, {}) }
+	, m_stats{ other.m_stats } {}
+
+stream_buffer &stream_buffer::operator=(stream_buffer &&other) noexcept {
+	if (this != &other) {
+		release();
+		m_buffer = std::exchange(other.m_buffer, 0);
+		m_mapped = std::exchange(other.m_mapped, nullptr);
+		m_region_size = other.m_region_size;
+		m_region = other.m_region;
+		m_used = other.m_used;
+		m_acquired = other.m_acquired;
+		m_fences = std::exchange(other.m_fences, {});
+		m_stats = other.m_stats;
+	}
+	return *this;
+}
+
+std::optional<stream_allocation> stream_buffer::allocate(const size_t size, const size_t alignment) {
+	const auto region_start{ m_region * m_region_size };
+	const auto start{ (region_start + m_used + alignment - 1) / alignment * alignment };
+	if (start + size > region_start + m_region_size) {
+		return std::nullopt;
+	}
+	if (!m_acquired) {
+		wait_region();
+		m_acquired = true;
+	}
+	m_used = start + size - region_start;
+	return stream_allocation{ m_mapped + start, start };
+}
+
+void stream_buffer::end_frame() {
+	++m_stats.frames;
+	if (!m_acquired) return;
+
+	m_fences[m_region] = gl::glFenceSync(gl::GL_SYNC_GPU_COMMANDS_COMPLETE, gl::GL_NONE_BIT);
+	m_region = (m_region + 1) % region_count;
+	m_used = 0;
+	m_acquired = false;
+}
+
+void stream_buffer::wait_region() {
+	const auto fence{ stream_fence(std::exchange(m_fences[m_region], nullptr)) };
+	if (fence == nullptr) return;
+
+	// flushed, or a fence never submitted would never be signaled
+	auto result{ gl::glClientWaitSync(fence, gl::GL_SYNC_FLUSH_COMMANDS_BIT, 0) };
+	if (result == gl::GL_TIMEOUT_EXPIRED) {
+		const auto start{ stream_clock::now() };
+		++m_stats.fence_waits;
+		do {
+			result = gl::glClientWaitSync(fence, gl::GL_SYNC_FLUSH_COMMANDS_BIT, stream_wait_step);
+		} while (result == gl::GL_TIMEOUT_EXPIRED);
+		m_stats.wait_time += stream_clock::now() - start;
+	}
+	if (result == gl::GL_WAIT_FAILED) {
+		spdlog::error("[stream_buffer::wait_region] Failed to wait for the fence of the region {}", m_region);
+	}
+	gl::glDeleteSync(fence);
+}
+
+void stream_buffer::release() noexcept {
+	for (auto &fence : m_fences) {
+		if (fence != nullptr) {
+			gl::glDeleteSync(stream_fence(std::exchange(fence, nullptr)));
+		}
+	}
+	// the mapping goes with the buffer
+	if (m_buffer != 0) {
+		gl::glDeleteBuffers(1, &m_buffer);
+		m_buffer = 0;
+		m_mapped = nullptr;
+	}
+}
+
+} // namespace gzn::core::render
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <cinttypes>
+
+namespace gzn::core::render {
+
+struct stream_allocation {
+	/// Where the CPU writes, mapped for the lifetime of the buffer
+	std::byte *data{ nullptr };
+	/// From the start of the buffer, for the binding offsets and the base instances
+	size_t offset{};
+};
+
+struct stream_stats {
+	uint64_t frames{};
+	/// The frames whose region the GPU was still reading, so the CPU waited for its fence
+	uint64_t fence_waits{};
+	std::chrono::nanoseconds wait_time{};
+};
+
+/// @brief A buffer mapped once, persistent and coherent, for the data written anew every frame.
+/// It's split in `region_count` regions used one frame after the other: the region of a frame
+/// is fenced once the frame is submitted, and written again only once its fence is signaled, so
+/// the CPU writes while the GPU reads the previous frames, without any reallocation or stall
+/// in the driver. The CPU waits only when it's `region_count` frames ahead.
+class stream_buffer {
+public:
+	static constexpr size_t region_count{ 3 };
+
+	/// @returns Nothing if the buffer can't be created or mapped
+	[[nodiscard]] static std::optional<stream_buffer> create(const size_t region_size);
+
+	~stream_buffer();
+
+	stream_buffer(const stream_buffer &other) = delete;
+	stream_buffer(stream_buffer &&other) noexcept;
+	stream_buffer &operator=(const stream_buffer &other) = delete;
+	stream_buffer &operator=(stream_buffer &&other) noexcept;
+
+	[[nodiscard]] uint32_t id() const noexcept { return m_buffer; }
+	[[nodiscard]] size_t region_size() const noexcept { return m_region_size; }
+
+	/// @brief @p size bytes of the region of this frame, the first allocation of a frame waits
+	/// for the region if the GPU may still read it
+	/// @param alignment Of the offset from the start of the buffer, any value and not only the
+	/// powers of two, so that an offset can be a whole number of records
+	/// @returns Nothing if the region has no room left
+	[[nodiscard]] std::optional<stream_allocation> allocate(const size_t size, const size_t alignment = 16);
+
+	/// @brief Fences the region of this frame after the commands which read it, and moves on
+	/// to the next one
+	void end_frame();
+
+	[[nodiscard]] const stream_stats &stats() const noexcept { return m_stats; }
+
+private:
+	uint32_t m_buffer{};
+	std::byte *m_mapped{ nullptr };
+	size_t m_region_size{};
+	size_t m_region{};
+	size_t m_used{};
+	bool m_acquired{ false };
+	/// The `GLsync` of every region, null once signaled
+	std::array<void *, region_count> m_fences{};
+	stream_stats m_stats{};
+
+	stream_buffer(const uint32_t buffer, std::byte *mapped, const size_t region_size) noexcept;
+
+	void wait_region();
+	void release() noexcept;
+};
+
+} // namespace gzn::core::render
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cinttypes>
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+namespace gzn::core::tools {
+
+[[nodiscard]] inline uint32_t popcount(const uint64_t value) noexcept {
+#if defined(_MSC_VER)
+	return static_cast<uint32_t>(__popcnt64(value));
+#else
+	return static_cast<uint32_t>(__builtin_popcountll(value));
+#endif
+}
+
+/// @warning @p value must not be zero
+[[nodiscard]] inline uint32_t count_trailing_zeros(const uint64_t value) noexcept {
+#if defined(_MSC_VER)
+	unsigned long index{};
+	_BitScanForward64(&index, value);
+	return static_cast<uint32_t>(index);
+#else
+	return static_cast<uint32_t>(__builtin_ctzll(value));
+#endif
+}
+
+} // namespace gzn::core::tools
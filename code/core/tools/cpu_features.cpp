@@ -0,0 +1,48 @@
+#include <cinttypes>
+
+#include "core/tools/cpu_features.hpp"
+
+#if MAGICUBE_X86 && defined(_MSC_VER)
+	#include <intrin.h>
+	#include <immintrin.h>
+#endif
+
+namespace gzn::core::tools {
+
+namespace {
+
+cpu_features detect() noexcept {
+	cpu_features features;
+#if MAGICUBE_X86 && defined(_MSC_VER)
+	int32_t registers[4]{};
+	__cpuid(registers, 0);
+	const auto max_leaf{ registers[0] };
+
+	__cpuid(registers, 1);
+	features.ssse3 = (registers[2] & (1 << 9)) != 0;
+	features.sse41 = (registers[2] & (1 << 19)) != 0;
+
+	const bool os_saves_ymm{ (registers[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6 };
+	if (max_leaf >= 7) {
+		__cpuidex(registers, 7, 0);
+		features.avx2 = os_saves_ymm && (registers[1] & (1 << 5)) != 0;
+		features.bmi2 = (registers[1] & (1 << 8)) != 0;
+	}
+#elif MAGICUBE_X86
+	__builtin_cpu_init();
+	features.ssse3 = __builtin_cpu_supports("ssse3");
+	features.sse41 = __builtin_cpu_supports("sse4.1");
+	features.avx2 = __builtin_cpu_supports("avx2");
+	features.bmi2 = __builtin_cpu_supports("bmi2");
+#endif
+	return features;
+}
+
+} // anonymous namespace
+
+const cpu_features &cpu() noexcept {
+	static const cpu_features features{ detect() };
+	return features;
+}
+
+} // namespace gzn::core::tools
@@ -0,0 +1,28 @@
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+	#define MAGICUBE_X86 1
+#else
+	#define MAGICUBE_X86 0
+#endif
+
+// MSVC lets intrinsics be used anywhere, GCC and Clang need the function to be marked
+#if MAGICUBE_X86 && (defined(__GNUC__) || defined(__clang__))
+	#define MAGICUBE_TARGET(name) __attribute__((target(name)))
+#else
+	#define MAGICUBE_TARGET(name)
+#endif
+
+namespace gzn::core::tools {
+
+struct cpu_features {
+	bool ssse3{ false };
+	bool sse41{ false };
+	bool avx2{ false };
+	bool bmi2{ false };
+};
+
+/// @brief Instruction sets supported by both the CPU and the OS. Detected once.
+[[nodiscard]] const cpu_features &cpu() noexcept;
+
+} // namespace gzn::core::tools
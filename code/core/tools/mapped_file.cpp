@@ -0,0 +1,117 @@
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+#if defined(_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+
+#include "core/tools/mapped_file.hpp"
+
+namespace gzn::core::tools {
+
+std::optional<mapped_file> mapped_file::open(const std::filesystem::path &path, const access_pattern pattern) {
+	mapped_file file;
+#if defined(_WIN32)
+	const DWORD hint{ pattern == access_pattern::random ? FILE_FLAG_RANDOM_ACCESS : FILE_FLAG_SEQUENTIAL_SCAN };
+	file.m_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | hint, nullptr);
+	if (file.m_file == INVALID_HANDLE_VALUE) {
+		file.m_file = nullptr;
+		spdlog::error("[mapped_file::open] Failed to open '{}': error {}", path.string(), GetLastError());
+		return std::nullopt;
+	}
+
+	LARGE_INTEGER size{};
+	if (!GetFileSizeEx(file.m_file, &size) || size.QuadPart == 0) {
+		spdlog::error("[mapped_file::open] '{}' is empty or its size is unknown", path.string());
+		return std::nullopt;
+	}
+	file.m_size = static_cast<size_t>(size.QuadPart);
+
+	file.m_mapping = CreateFileMappingW(file.m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (file.m_mapping == nullptr) {
+		spdlog::error("[mapped_file::open] Failed to map '{}': error {}", path.string(), GetLastError());
+		return std::nullopt;
+	}
+
+	file.m_data = static_cast<const std::byte *>(MapViewOfFile(file.m_mapping, FILE_MAP_READ, 0, 0, 0));
+	if (file.m_data == nullptr) {
+		spdlog::error("[mapped_file::open] Failed to view '{}': error {}", path.string(), GetLastError());
+		return std::nullopt;
+	}
+#else
+	const int descriptor{ ::open(path.c_str(), O_RDONLY) };
+	if (descriptor < 0) {
+		spdlog::error("[mapped_file::open] Failed to open '{}'", path.string());
+		return std::nullopt;
+	}
+
+	struct stat info{};
+	if (fstat(descriptor, &info) != 0 || info.st_size == 0) {
+		spdlog::error("[mapped_file::open] '{}' is empty or its size is unknown", path.string());
+		close(descriptor);
+		return std::nullopt;
+	}
+	file.m_size = static_cast<size_t>(info.st_size);
+
+	void *address{ mmap(nullptr, file.m_size, PROT_READ, MAP_SHARED, descriptor, 0) };
+	close(descriptor); // the mapping keeps the file alive
+	if (address == MAP_FAILED) {
+		spdlog::error("[mapped_file::open] Failed to map '{}'", path.string());
+		return std::nullopt;
+	}
+	madvise(address, file.m_size, pattern == access_pattern::random ? MADV_RANDOM : MADV_SEQUENTIAL);
+	file.m_data = static_cast<const std::byte *>(address);
+#endif
+	return file;
+}
+
+mapped_file::~mapped_file() {
+	release();
+}
+
+mapped_file::mapped_file(mapped_file &&other) noexcept
+	: m_data{ std::exchange(other.m_data, nullptr) }
+	, m_size{ std::exchange(other.m_size, 0) }
+#if defined(_WIN32)
+	, m_file{ std::exchange(other.m_file, nullptr) }
+	, m_mapping{ std::exchange(other.m_mapping, nullptr) }
+#endif
+{}
+
+mapped_file &mapped_file::operator=(mapped_file &&other) noexcept {
+	if (this != &other) {
+		release();
+		m_data = std::exchange(other.m_data, nullptr);
+		m_size = std::exchange(other.m_size, 0);
+#if defined(_WIN32)
+		m_file = std::exchange(other.m_file, nullptr);
+		m_mapping = std::exchange(other.m_mapping, nullptr);
+#endif
+	}
+	return *this;
+}
+
+void mapped_file::release() noexcept {
+#if defined(_WIN32)
+	if (m_data != nullptr) UnmapViewOfFile(m_data);
+	if (m_mapping != nullptr) CloseHandle(m_mapping);
+	if (m_file != nullptr) CloseHandle(m_file);
+	m_mapping = nullptr;
+	m_file = nullptr;
+#else
+	if (m_data != nullptr) munmap(const_cast<std::byte *>(m_data), m_size);
+#endif
+	m_data = nullptr;
+	m_size = 0;
+}
+
+} // namespace gzn::core::tools
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cinttypes>
+#include <optional>
+#include <filesystem>
+
+namespace gzn::core::tools {
+
+/// @brief Read-only memory mapping of a whole file. The pages are shared with every other
+/// process which maps the same file and are read from the disk on the first access only.
+class mapped_file {
+public:
+	enum class access_pattern : uint8_t { sequential, random };
+
+	[[nodiscard]] static std::optional<mapped_file> open(const std::filesystem::path &path,
+		const access_pattern pattern = access_pattern::random);
+
+	~mapped_file();
+
+	mapped_file(const mapped_file &other) = delete;
+	mapped_file(mapped_file &&other) noexcept;
+	mapped_file &operator=(const mapped_file &other) = delete;
+	mapped_file &operator=(mapped_file &&other) noexcept;
+
+	[[nodiscard]] const std::byte *data() const noexcept { return m_data; }
+	[[nodiscard]] size_t size() const noexcept { return m_size; }
+
+private:
+	const std::byte *m_data{ nullptr };
+	size_t m_size{};
+#if defined(_WIN32)
+	void *m_file{ nullptr };
+	void *m_mapping{ nullptr };
+#endif
+
+	mapped_file() = default;
+
+	void release() noexcept;
+};
+
+} // namespace gzn::core::tools
@@ -0,0 +1,80 @@
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+#if defined(_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+#endif
+
+#include "core/tools/page_buffer.hpp"
+
+namespace gzn::core::tools {
+
+std::optional<page_buffer> page_buffer::allocate(const size_t size) {
+	page_buffer buffer;
+	buffer.m_size = size;
+#if defined(_WIN32)
+	// large pages need the SeLockMemoryPrivilege which nobody has by default
+	buffer.m_data = static_cast<std::byte *>(VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+	if (buffer.m_data == nullptr) {
+		spdlog::error("[page_buffer::allocate] Failed to allocate {} bytes: error {}", size, GetLastError());
+		return std::nullopt;
+	}
+#else
+	void *address{ MAP_FAILED };
+	#if defined(MAP_HUGETLB)
+	constexpr size_t huge_page_size{ 2u << 20 };
+	if (size % huge_page_size == 0) {
+		address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		buffer.m_huge_pages = address != MAP_FAILED;
+	}
+	#endif
+	if (address == MAP_FAILED) {
+		address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (address == MAP_FAILED) {
+			spdlog::error("[page_buffer::allocate] Failed to allocate {} bytes", size);
+			return std::nullopt;
+		}
+	#if defined(MADV_HUGEPAGE)
+		madvise(address, size, MADV_HUGEPAGE);
+	#endif
+	}
+	buffer.m_data = static_cast<std::byte *>(address);
+#endif
+	return buffer;
+}
+
+page_buffer::~page_buffer() {
+	release();
+}
+
+page_buffer::page_buffer(page_buffer &&other) noexcept
+	: m_data{ std::exchange(other.m_data, nullptr) }
+	, m_size{ std::exchange(other.m_size, 0) }
+	, m_huge_pages{ std::exchange(other.m_huge_pages, false) } {}
+
+page_buffer &page_buffer::operator=(page_buffer &&other) noexcept {
+	if (this != &other) {
+		release();
+		m_data = std::exchange(other.m_data, nullptr);
+		m_size = std::exchange(other.m_size, 0);
+		m_huge_pages = std::exchange(other.m_huge_pages, false);
+	}
+	return *this;
+}
+
+void page_buffer::release() noexcept {
+#if defined(_WIN32)
+	if (m_data != nullptr) VirtualFree(m_data, 0, MEM_RELEASE);
+#else
+	if (m_data != nullptr) munmap(m_data, m_size);
+#endif
+	m_data = nullptr;
+	m_size = 0;
+}
+
+} // namespace gzn::core::tools
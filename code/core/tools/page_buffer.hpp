@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+
+namespace gzn::core::tools {
+
+/// @brief Zero-filled memory straight from the OS. On Linux it's backed by huge pages when
+/// there are any reserved, or marked for transparent huge pages otherwise, which spares the TLB
+/// misses on random access to large tables.
+class page_buffer {
+public:
+	[[nodiscard]] static std::optional<page_buffer> allocate(const size_t size);
+
+	~page_buffer();
+
+	page_buffer(const page_buffer &other) = delete;
+	page_buffer(page_buffer &&other) noexcept;
+	page_buffer &operator=(const page_buffer &other) = delete;
+	page_buffer &operator=(page_buffer &&other) noexcept;
+
+	[[nodiscard]] std::byte *data() const noexcept { return m_data; }
+	[[nodiscard]] size_t size() const noexcept { return m_size; }
+	/// @brief Whether the explicit huge pages were available
+	[[nodiscard]] bool huge_pages() const noexcept { return m_huge_pages; }
+
+private:
+	std::byte *m_data{ nullptr };
+	size_t m_size{};
+	bool m_huge_pages{ false };
+
+	page_buffer() = default;
+
+	void release() noexcept;
+};
+
+} // namespace gzn::core::tools
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <limits>
+#include <cinttypes>
+
+namespace gzn::core::tools {
+
+/// @brief Philox4x32-10, the counter-based generator of Random123: a block of four numbers is
+/// ten rounds of multiplications over a 128-bit counter keyed by a 64-bit seed. The stream is
+/// the upper half of the counter, so any number of independent streams of a seed, one per task
+/// or per item, are drawn from in any order on any thread with the same results.
+class philox4x32 {
+public:
+	using result_type = uint32_t;
+	using block_type = std::array<uint32_t, 4>;
+
+	constexpr philox4x32(const uint64_t seed, const uint64_t stream) noexcept
+		: m_key{ static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32) }
+		, m_counter{ 0, 0, static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32) } {}
+
+	[[nodiscard]] static constexpr result_type min() noexcept { return 0; }
+	[[nodiscard]] static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+	[[nodiscard]] static constexpr block_type block(block_type counter, std::array<uint32_t, 2> key) noexcept {
+		constexpr uint64_t multiplier0{ 0xD2511F53 };
+		constexpr uint64_t multiplier1{ 0xCD9E8D57 };
+		for (size_t round{}; round < 10; ++round) {
+			const auto product0{ multiplier0 * counter[0] };
+			const auto product1{ multiplier1 * counter[2] };
+			counter = {
+				static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+				static_cast<uint32_t>(product1),
+				static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+				static_cast<uint32_t>(product0),
+			};
+			// the Weyl sequence of the golden ratio and of the square root of 3
+			key[0] += 0x9E3779B9;
+			key[1] += 0xBB67AE85;
+		}
+		return counter;
+	}
+
+	constexpr result_type operator()() noexcept {
+		if (m_index == m_block.size()) {
+			m_block = block(m_counter, m_key);
+			m_index = 0;
+			if (++m_counter[0] == 0) {
+				++m_counter[1];
+			}
+		}
+		return m_block[m_index++];
+	}
+
+	/// @brief A number of `[0, bound)` without a bias, by Lemire's multiply and reject
+	[[nodiscard]] constexpr uint32_t below(const uint32_t bound) noexcept {
+		auto product{ uint64_t{ (*this)() } * bound };
+		if (static_cast<uint32_t>(product) < bound) {
+			const auto threshold{ static_cast<uint32_t>(-bound) % bound };
+			while (static_cast<uint32_t>(product) < threshold) {
+				product = uint64_t{ (*this)() } * bound;
+			}
+		}
+		return static_cast<uint32_t>(product >> 32);
+	}
+
+private:
+	std::array<uint32_t, 2> m_key;
+	block_type m_counter;
+	block_type m_block{};
+	size_t m_index{ m_block.size() };
+};
+
+} // namespace gzn::core::tools
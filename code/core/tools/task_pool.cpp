@@ -0,0 +1,116 @@
+#include <algorithm>
+
+#include "core/tools/task_pool.hpp"
+
+namespace gzn::core::tools {
+
+namespace {
+
+thread_local const task_pool *current_pool{ nullptr };
+thread_local size_t current_worker{};
+
+} // anonymous namespace
+
+task_pool::task_pool(size_t threads) {
+	if (threads == 0) {
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	for (size_t i{}; i <= threads; ++i) {
+		m_queues.push_back(std::make_unique<queue>());
+	}
+	m_threads.reserve(threads);
+	for (size_t i{}; i < threads; ++i) {
+		m_threads.emplace_back([this, i] { work(i); });
+	}
+}
+
+task_pool::~task_pool() {
+	{
+		std::lock_guard lock{ m_mutex };
+		m_stopping = true;
+	}
+	m_wake.notify_all();
+	for (auto &thread : m_threads) {
+		thread.join();
+	}
+}
+
+void task_pool::submit(task_group &group, task job) {
+	const auto index{ current_pool == this
+		? current_worker
+		: m_next_queue.fetch_add(1, std::memory_order_relaxed) % m_threads.size() };
+
+	group.m_pending.fetch_add(1, std::memory_order_relaxed);
+	{
+		// counted under the lock of the queue, so a thief can't take the task before it is counted
+		std::lock_guard lock{ m_queues[index]->mutex };
+		m_queued.fetch_add(1, std::memory_order_release);
+		m_queues[index]->tasks.push_back({ std::move(job), &group });
+	}
+	{
+		// taking the lock keeps a worker from missing the wake-up between its check and its wait
+		std::lock_guard lock{ m_mutex };
+	}
+	m_wake.notify_one();
+	// a thread waiting for its group runs the new task if the workers are busy
+	m_idle.notify_one();
+}
+
+void task_pool::wait(task_group &group) {
+	const auto outside{ m_queues.size() - 1 };
+	while (!group.done()) {
+		if (run_one(current_pool == this ? current_worker : outside)) continue;
+
+		// the rest of the group is running on other threads
+		std::unique_lock lock{ m_mutex };
+		m_idle.wait(lock, [this, &group] {
+			return group.done() || m_queued.load(std::memory_order_acquire) != 0;
+		});
+	}
+}
+
+void task_pool::work(const size_t index) {
+	current_pool = this;
+	current_worker = index;
+
+	for (;;) {
+		if (run_one(index)) continue;
+
+		std::unique_lock lock{ m_mutex };
+		m_wake.wait(lock, [this] { return m_stopping || m_queued.load(std::memory_order_acquire) != 0; });
+		if (m_stopping) return;
+	}
+}
+
+bool task_pool::run_one(const size_t index) {
+	queued_task job;
+	for (size_t offset{}; offset < m_queues.size() && !job.job; ++offset) {
+		auto &victim{ *m_queues[(index + offset) % m_queues.size()] };
+		std::lock_guard lock{ victim.mutex };
+		if (victim.tasks.empty()) continue;
+
+		if (offset == 0) {
+			job = std::move(victim.tasks.back());
+			victim.tasks.pop_back();
+		} else {
+			job = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			m_stolen.fetch_add(1, std::memory_order_relaxed);
+		}
+		m_queued.fetch_sub(1, std::memory_order_acq_rel);
+	}
+	if (!job.job) {
+		return false;
+	}
+
+	job.job();
+
+	// the group may be gone as soon as its last task is counted
+	if (job.group->m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		std::lock_guard lock{ m_mutex };
+		m_idle.notify_all();
+	}
+	return true;
+}
+
+} // namespace gzn::core::tools
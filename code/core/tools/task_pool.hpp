@@ -0,0 +1,86 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+namespace gzn::core::tools {
+
+class task_pool;
+
+/// @brief The tasks of one batch, waited for together. It has to outlive its tasks, which
+/// `task_pool::wait` ensures.
+class task_group {
+public:
+	task_group() = default;
+
+	task_group(const task_group &other) = delete;
+	task_group &operator=(const task_group &other) = delete;
+
+	[[nodiscard]] bool done() const noexcept { return m_pending.load(std::memory_order_acquire) == 0; }
+
+private:
+	friend class task_pool;
+
+	std::atomic<size_t> m_pending{ 0 };
+};
+
+/// @brief Thread pool where every worker owns a task queue. A worker runs its own tasks
+/// newest first and steals the oldest ones from the others when it runs out.
+class task_pool {
+public:
+	using task = std::function<void()>;
+
+	/// @param threads 0 means every hardware thread
+	explicit task_pool(size_t threads = 0);
+	~task_pool();
+
+	task_pool(const task_pool &other) = delete;
+	task_pool &operator=(const task_pool &other) = delete;
+
+	/// @brief Tasks submitted by a worker go to its own queue, others are spread over all of them
+	void submit(task_group &group, task job);
+
+	/// @brief Runs the tasks of any group on the calling thread until every task of @p group is
+	/// finished. A task may wait for the group of the tasks it submitted, and the waits of
+	/// different groups don't wait for each other.
+	void wait(task_group &group);
+
+	[[nodiscard]] size_t size() const noexcept { return m_threads.size(); }
+	[[nodiscard]] uint64_t stolen() const noexcept { return m_stolen.load(std::memory_order_relaxed); }
+
+private:
+	struct queued_task {
+		task job;
+		task_group *group{ nullptr };
+	};
+
+	struct alignas(64) queue {
+		std::mutex mutex;
+		std::deque<queued_task> tasks;
+	};
+
+	/// One queue per worker and the last one for the threads outside of the pool
+	std::vector<std::unique_ptr<queue>> m_queues;
+	std::vector<std::thread> m_threads;
+
+	std::atomic<size_t> m_queued{ 0 };
+	std::atomic<size_t> m_next_queue{ 0 };
+	std::atomic<uint64_t> m_stolen{ 0 };
+
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_idle;
+	bool m_stopping{ false };
+
+	void work(const size_t index);
+	/// @returns false when there was nothing to run
+	bool run_one(const size_t index);
+};
+
+} // namespace gzn::core::tools
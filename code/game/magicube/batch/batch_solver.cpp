@@ -0,0 +1,495 @@
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <cstdio>
+#include <cctype>
+#include <memory>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <condition_variable>
+
+#include <spdlog/spdlog.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <core/tools/task_pool.hpp>
+
+#include "game/magicube/cube/notation.hpp"
+#include "game/magicube/cube/facelet_cube.hpp"
+#include "game/magicube/solver/pocket_table.hpp"
+#include "game/magicube/solver/reduction_solver.hpp"
+#include "game/magicube/batch/batch_solver.hpp"
+
+namespace gzn::game::magicube {
+
+namespace {
+
+using batch_clock = std::chrono::steady_clock;
+
+enum class batch_status : uint8_t { solved, skipped, invalid, unsolvable, failed };
+
+/// A scramble between its reading and its writing. The slot of the n-th line is n % capacity.
+struct batch_slot {
+	std::string text;
+	std::chrono::microseconds latency{};
+	batch_status status{ batch_status::skipped };
+	uint32_t length{};
+	bool ready{ false };
+};
+
+struct batch_progress {
+	latency_histogram interval;
+	latency_histogram total;
+	uint64_t solved{};
+	uint64_t failed{};
+	uint64_t moves{};
+	uint64_t interval_solved{};
+	batch_clock::time_point start{ batch_clock::now() };
+	batch_clock::time_point interval_start{ batch_clock::now() };
+};
+
+struct file_closer {
+	void operator()(std::FILE *file) const noexcept { std::fclose(file); }
+};
+
+bool is_separator(const char c) noexcept {
+	return std::isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+/// The longest scramble a line may hold
+constexpr size_t max_line_turns{ 1024 };
+
+constexpr std::array<std::pair<std::string_view, batch_puzzle>, 6> batch_puzzle_names{ {
+	{ "3x3", batch_puzzle::cube_3x3 },
+	{ "2x2", batch_puzzle::cube_2x2 },
+	{ "4x4", batch_puzzle::cube_4x4 },
+	{ "5x5", batch_puzzle::cube_5x5 },
+	{ "6x6", batch_puzzle::cube_6x6 },
+	{ "7x7", batch_puzzle::cube_7x7 },
+} };
+
+/// @returns 0 for the puzzles which aren't solved as a big_cube
+[[nodiscard]] constexpr size_t big_cube_size(const batch_puzzle puzzle) noexcept {
+	switch (puzzle) {
+	case batch_puzzle::cube_4x4: return 4;
+	case batch_puzzle::cube_5x5: return 5;
+	case batch_puzzle::cube_6x6: return 6;
+	case batch_puzzle::cube_7x7: return 7;
+	default: return 0;
+	}
+}
+
+/// @brief The turns of a 2x2 as the 3x3 turns doing the same to the corners: a wide turn is a
+/// rotation and the second layer is the opposite face turning back
+bool to_pocket_turns(turn *turns, const size_t count) noexcept {
+	for (size_t i{}; i < count; ++i) {
+		auto &t{ turns[i] };
+		if (t.kind == turn_kind::slice || t.layers > 2) return false;
+		if (t.kind == turn_kind::wide && t.layers == 2) {
+			t = turn{ turn_kind::rotation, t.direction, t.power, 1 };
+		} else if (t.kind != turn_kind::rotation && t.layers == 2) {
+			t = turn{ turn_kind::face, opposite(t.direction), static_cast<uint8_t>(4 - t.power), 1 };
+		}
+	}
+	return true;
+}
+
+/// @brief WCA notation; the wide turns, slices and rotations become face turns
+/// @param orientation How the cube is held after the scramble
+std::optional<move_sequence> parse_moves(const std::string_view text, const batch_puzzle puzzle,
+	cube_orientation &orientation, std::string &error) {
+	std::array<turn, max_line_turns> turns;
+	const auto parsed{ parse_notation(text, turns.data(), turns.size()) };
+	if (!parsed) {
+		error = fmt::format("{} at {}", parsed.error, parsed.position + 1);
+		return std::nullopt;
+	}
+	if (puzzle == batch_puzzle::cube_2x2 && !to_pocket_turns(turns.data(), parsed.count)) {
+		error = "not a 2x2 turn";
+		return std::nullopt;
+	}
+
+	move_sequence moves;
+	const auto held{ to_moves(turns.data(), parsed.count, moves) };
+	if (!held) {
+		error = "not a 3x3 turn";
+		return std::nullopt;
+	}
+	orientation = *held;
+	return moves;
+}
+
+/// @brief Empty lines and comments are written back empty
+bool skip_line(batch_slot &slot) {
+	const std::string_view line{ slot.text };
+	const auto first{ std::find_if_not(line.begin(), line.end(), is_separator) };
+	if (first == line.end() || *first == '#') {
+		slot.status = batch_status::skipped;
+		slot.text.clear();
+		return true;
+	}
+	return false;
+}
+
+/// @param solve Takes the cube_state and returns an optional solution
+template<class Solve>
+void solve_line(const Solve &solve, const batch_puzzle puzzle, batch_slot &slot) {
+	if (skip_line(slot)) {
+		return;
+	}
+	const std::string_view line{ slot.text };
+
+	std::string error;
+	std::optional<cube_state> state;
+	cube_orientation orientation;
+	const bool facelets{ line.size() == facelet_count && std::none_of(line.begin(), line.end(), is_separator) };
+	if (facelets && puzzle == batch_puzzle::cube_3x3) {
+		const auto cube{ facelet_cube::from_string(line) };
+		const auto cubies{ cube ? cube->to_cubies() : std::nullopt };
+		if (cubies) {
+			state = cube_state::from_cubies(*cubies);
+		} else {
+			error = "invalid facelets";
+		}
+	} else if (const auto moves{ parse_moves(line, puzzle, orientation, error) }; moves) {
+		state.emplace();
+		state->apply(*moves);
+	}
+
+	if (!state) {
+		slot.status = batch_status::invalid;
+		slot.text = fmt::format("# invalid: {}", error);
+		return;
+	}
+	if (!is_solvable(state->to_cubies())) {
+		slot.status = batch_status::unsolvable;
+		slot.text = "# unsolvable";
+		return;
+	}
+
+	auto solution{ solve(*state) };
+	if (!solution) {
+		slot.status = batch_status::failed;
+		slot.text = "# no solution";
+		return;
+	}
+	// the solution is of the cube held as before the rotations of the scramble
+	for (auto &m : *solution) {
+		m = orientation.held(m);
+	}
+	slot.status = batch_status::solved;
+	slot.length = static_cast<uint32_t>(solution->size());
+	slot.text.resize(solution->size() * max_turn_length);
+	slot.text.resize(format_notation(solution->data(), solution->size(), slot.text.data(), slot.text.size()));
+}
+
+void solve_big_line(const reduction_solver &solver, const size_t size, batch_slot &slot) {
+	if (skip_line(slot)) {
+		return;
+	}
+
+	std::array<turn, max_line_turns> turns;
+	const auto parsed{ parse_notation(slot.text, turns.data(), turns.size()) };
+	if (!parsed) {
+		slot.status = batch_status::invalid;
+		slot.text = fmt::format("# invalid: {} at {}", parsed.error, parsed.position + 1);
+		return;
+	}
+	auto cube{ *big_cube::create(size) };
+	for (size_t i{}; i < parsed.count; ++i) {
+		if (!cube.apply(turns[i])) {
+			slot.status = batch_status::invalid;
+			slot.text = fmt::format("# invalid: not a {}x{} turn", size, size);
+			return;
+		}
+	}
+
+	const auto solution{ solver.solve(cube) };
+	if (!solution) {
+		slot.status = batch_status::failed;
+		slot.text = "# no solution";
+		return;
+	}
+	slot.status = batch_status::solved;
+	slot.length = static_cast<uint32_t>(solution->turns.size());
+	slot.text.resize(solution->turns.size() * max_turn_length);
+	slot.text.resize(format_notation(solution->turns.data(), solution->turns.size(), slot.text.data(), slot.text.size()));
+}
+
+void report(batch_progress &progress, const size_t in_flight, const bool last) {
+	const auto now{ batch_clock::now() };
+	const std::chrono::duration<double> total{ now - progress.start };
+	const std::chrono::duration<double> interval{ now - progress.interval_start };
+	const auto &latencies{ last ? progress.total : progress.interval };
+	const auto milliseconds{ [](const std::chrono::microseconds value) { return static_cast<double>(value.count()) / 1000.0; } };
+
+	spdlog::info("[batch_solver::run] {} {} solved, {} failed, {:.1f}/s {}, {:.1f}/s overall; "
+		"latency p50 {:.1f} ms, p90 {:.1f} ms, p99 {:.1f} ms, max {:.1f} ms; {:.2f} moves on average; {} in flight",
+		last ? "Done:" : "Progress:", progress.solved, progress.failed,
+		static_cast<double>(progress.interval_solved) / std::max(interval.count(), 1e-9), last ? "at the end" : "lately",
+		static_cast<double>(progress.solved) / std::max(total.count(), 1e-9),
+		milliseconds(latencies.percentile(0.5)), milliseconds(latencies.percentile(0.9)),
+		milliseconds(latencies.percentile(0.99)), milliseconds(latencies.max()),
+		progress.solved > 0 ? static_cast<double>(progress.moves) / static_cast<double>(progress.solved) : 0.0,
+		in_flight);
+
+	progress.interval.reset();
+	progress.interval_solved = 0;
+	progress.interval_start = now;
+}
+
+} // anonymous namespace
+
+//===== latency_histogram =====//
+
+void latency_histogram::add(const std::chrono::microseconds latency) noexcept {
+	const auto value{ std::max<int64_t>(latency.count(), 1) };
+	const auto bucket{ static_cast<size_t>(std::log2(static_cast<double>(value)) * steps_per_octave) };
+	++m_buckets[std::min(bucket, bucket_count - 1)];
+	++m_count;
+	m_max = std::max(m_max, latency);
+}
+
+std::chrono::microseconds latency_histogram::percentile(const double fraction) const noexcept {
+	const auto target{ static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(m_count))) };
+	uint64_t seen{};
+	for (size_t i{}; i < bucket_count; ++i) {
+		seen += m_buckets[i];
+		if (seen >= target && seen > 0) {
+			const auto bound{ std::exp2(static_cast<double>(i + 1) / steps_per_octave) };
+			return std::min(m_max, std::chrono::microseconds{ static_cast<int64_t>(bound) });
+		}
+	}
+	return m_max;
+}
+
+//===== batch_options =====//
+
+std::optional<batch_options> batch_options::parse(const int argc, const char *const *argv) {
+	batch_options options;
+	for (int i{}; i < argc; ++i) {
+		const std::string_view argument{ argv[i] };
+		const bool has_value{ i + 1 < argc };
+		const std::string_view value{ has_value ? argv[i + 1] : "" };
+		const auto number{ [&value] { return std::strtoull(std::string{ value }.c_str(), nullptr, 10); } };
+
+		if (argument == "--puzzle" && has_value) {
+			const auto found{ std::find_if(batch_puzzle_names.begin(), batch_puzzle_names.end(),
+				[&value](const auto &name) { return name.first == value; }) };
+			if (found == batch_puzzle_names.end()) {
+				spdlog::error("[batch_options::parse] Unknown puzzle '{}'\n{}", value, usage());
+				return std::nullopt;
+			}
+			options.puzzle = found->second;
+		} else if (argument == "--input" && has_value) {
+			options.input = value;
+		} else if (argument == "--output" && has_value) {
+			options.output = value;
+		} else if (argument == "--tables" && has_value) {
+			options.tables_path = value;
+		} else if (argument == "--pocket-table" && has_value) {
+			options.pocket_table_path = value;
+		} else if (argument == "--threads" && has_value) {
+			options.threads = number();
+		} else if (argument == "--in-flight" && has_value) {
+			options.max_in_flight = std::max<size_t>(1, number());
+		} else if (argument == "--report" && has_value) {
+			options.report_interval = std::chrono::seconds{ std::max<unsigned long long>(1, number()) };
+		} else if (argument == "--length" && has_value) {
+			options.solver.target_length = static_cast<uint8_t>(std::min<unsigned long long>(number(), 30));
+		} else if (argument == "--timeout" && has_value) {
+			options.solver.timeout = std::chrono::milliseconds{ number() };
+		} else {
+			spdlog::error("[batch_options::parse] Unexpected argument '{}'\n{}", argument, usage());
+			return std::nullopt;
+		}
+		++i;
+	}
+	return options;
+}
+
+std::string_view batch_options::usage() noexcept {
+	return "Usage: magicube --batch [options]\n"
+		"  --puzzle <NxN>      3x3 (default), 2x2, which is solved optimally, or 4x4 to 7x7,\n"
+		"                      which are solved by reduction\n"
+		"  --input <path>      Scrambles, one per line; the standard input by default\n"
+		"  --output <path>     Solutions in the same order; the standard output by default\n"
+		"  --tables <path>     Two-phase tables, generated when missing\n"
+		"  --pocket-table <path>\n"
+		"                      2x2 distance table, generated when missing\n"
+		"  --threads <count>   0 (default) uses every hardware thread\n"
+		"  --in-flight <count> Scrambles read ahead of the output, 4096 by default\n"
+		"  --report <seconds>  Progress report interval, 10 by default\n"
+		"  --length <moves>    Stop at the first solution this short, 20 by default\n"
+		"  --timeout <ms>      Time limit per scramble, 1000 by default\n";
+}
+
+//===== batch_solver =====//
+
+batch_solver::batch_solver(const batch_options &options)
+	: m_options{ options } {}
+
+int batch_solver::run() {
+	const auto is_standard{ [](const std::filesystem::path &path) { return path.empty() || path == "-"; } };
+
+	std::unique_ptr<std::FILE, file_closer> output_file;
+	std::FILE *output{ stdout };
+	if (!is_standard(m_options.output)) {
+		output_file.reset(std::fopen(m_options.output.string().c_str(), "wb"));
+		if (!output_file) {
+			spdlog::error("[batch_solver::run] Failed to open '{}'", m_options.output.string());
+			return EXIT_FAILURE;
+		}
+		output = output_file.get();
+	} else {
+		// the solutions own the standard output
+		spdlog::set_default_logger(spdlog::stderr_color_mt("batch"));
+	}
+
+	std::ifstream input_file;
+	std::istream *input{ &std::cin };
+	if (!is_standard(m_options.input)) {
+		input_file.open(m_options.input);
+		if (!input_file) {
+			spdlog::error("[batch_solver::run] Failed to open '{}'", m_options.input.string());
+			return EXIT_FAILURE;
+		}
+		input = &input_file;
+	}
+
+	// only the tables of the puzzle are loaded: a big cube of an even size is reduced to a 2x2,
+	// of an odd size to a 3x3
+	const auto size{ big_cube_size(m_options.puzzle) };
+	std::shared_ptr<const two_phase_tables> tables;
+	std::shared_ptr<const pocket_table> pocket;
+	if (size > 0 ? size % 2 == 0 : m_options.puzzle == batch_puzzle::cube_2x2) {
+		auto loaded{ pocket_table::load_or_generate(m_options.pocket_table_path) };
+		if (!loaded) {
+			return EXIT_FAILURE;
+		}
+		pocket = std::make_shared<const pocket_table>(std::move(*loaded));
+	} else {
+		tables = two_phase_tables::load_or_generate(m_options.tables_path);
+		if (!tables) {
+			return EXIT_FAILURE;
+		}
+	}
+
+	std::optional<two_phase_solver> solver;
+	std::optional<reduction_solver> reducer;
+	if (size > 0) {
+		// the pool solves the scrambles side by side, so the orbits of one are solved in a row
+		reducer.emplace(tables, pocket, 1);
+		reduction_solver::prepare(size);
+	} else if (tables) {
+		solver.emplace(tables);
+	}
+	const auto solve{ [&solver, &pocket, this](const cube_state &state) {
+		return pocket ? pocket->solve(state) : solver->solve(state, m_options.solver);
+	} };
+
+	core::tools::task_pool pool{ m_options.threads };
+	core::tools::task_group scrambles;
+	spdlog::info("[batch_solver::run] Solving on {} threads, {} scrambles in flight at most",
+		pool.size(), m_options.max_in_flight);
+
+	std::vector<batch_slot> slots(m_options.max_in_flight);
+	std::mutex mutex;
+	std::condition_variable slot_freed;
+	std::condition_variable slot_ready;
+	uint64_t read{};
+	uint64_t written{};
+	bool reading{ true };
+	// once the output fails, the slots in flight are drained without writing and nothing more is read
+	bool write_failed{ false };
+
+	batch_progress progress;
+	std::thread writer{ [&] {
+		auto next_report{ batch_clock::now() + m_options.report_interval };
+		std::unique_lock lock{ mutex };
+		for (;;) {
+			auto &slot{ slots[written % slots.size()] };
+			const bool woke{ slot_ready.wait_until(lock, next_report, [&] {
+				return slot.ready || (!reading && written == read);
+			}) };
+			if (!woke || batch_clock::now() >= next_report) {
+				report(progress, static_cast<size_t>(read - written), false);
+				next_report += m_options.report_interval;
+				continue;
+			}
+			if (!slot.ready) break;
+
+			const bool writing{ !write_failed };
+			lock.unlock();
+			const bool wrote{ !writing || (std::fwrite(slot.text.data(), 1, slot.text.size(), output) == slot.text.size()
+				&& std::fputc('\n', output) != EOF) };
+			if (!wrote) {
+				spdlog::error("[batch_solver::run] Failed to write the solution of scramble {}", written + 1);
+			}
+			if (slot.status == batch_status::solved) {
+				++progress.solved;
+				++progress.interval_solved;
+				progress.moves += slot.length;
+			} else if (slot.status != batch_status::skipped) {
+				++progress.failed;
+			}
+			if (slot.status != batch_status::skipped) {
+				progress.interval.add(slot.latency);
+				progress.total.add(slot.latency);
+			}
+			slot.text.clear();
+			lock.lock();
+
+			write_failed = write_failed || !wrote;
+			slot.ready = false;
+			++written;
+			slot_freed.notify_one();
+		}
+	} };
+
+	std::string line;
+	while (std::getline(*input, line)) {
+		std::unique_lock lock{ mutex };
+		// backpressure: the reading waits for the writer instead of queueing without a limit
+		slot_freed.wait(lock, [&] { return read - written < slots.size(); });
+		if (write_failed) break;
+		const auto index{ read++ % slots.size() };
+		lock.unlock();
+
+		slots[index].text = std::move(line);
+		pool.submit(scrambles, [&, index] {
+			auto &slot{ slots[index] };
+			const auto start{ batch_clock::now() };
+			if (reducer) {
+				solve_big_line(*reducer, size, slot);
+			} else {
+				solve_line(solve, m_options.puzzle, slot);
+			}
+			slot.latency = std::chrono::duration_cast<std::chrono::microseconds>(batch_clock::now() - start);
+
+			std::lock_guard slot_lock{ mutex };
+			slot.ready = true;
+			slot_ready.notify_one();
+		});
+		line = std::string{};
+	}
+	{
+		std::lock_guard lock{ mutex };
+		reading = false;
+	}
+	slot_ready.notify_one();
+
+	pool.wait(scrambles);
+	writer.join();
+	if (!write_failed && (std::fflush(output) != 0 || std::ferror(output) != 0)) {
+		spdlog::error("[batch_solver::run] Failed to write the last solutions");
+		write_failed = true;
+	}
+
+	report(progress, 0, true);
+	return progress.failed == 0 && !write_failed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+} // namespace gzn::game::magicube
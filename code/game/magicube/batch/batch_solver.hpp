@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <optional>
+#include <cinttypes>
+#include <filesystem>
+
+#include "game/magicube/defaults.hpp"
+#include "game/magicube/solver/two_phase_solver.hpp"
+
+namespace gzn::game::magicube {
+
+enum class batch_puzzle : uint8_t {
+	cube_3x3, ///< Solved with the two-phase algorithm
+	cube_2x2, ///< Solved optimally with the complete distance table
+	cube_4x4, ///< The big cubes are solved by reduction
+	cube_5x5,
+	cube_6x6,
+	cube_7x7,
+};
+
+struct batch_options {
+	batch_puzzle puzzle{ batch_puzzle::cube_3x3 };
+	/// Empty or "-" reads the standard input
+	std::filesystem::path input{};
+	/// Empty or "-" writes to the standard output
+	std::filesystem::path output{};
+	std::filesystem::path tables_path{ defaults::solver::two_phase_tables_path };
+	std::filesystem::path pocket_table_path{ defaults::solver::pocket_table_path };
+	/// 0 means every hardware thread
+	size_t threads{ 0 };
+	/// Scrambles read but not written yet. The reading waits when there are this many.
+	size_t max_in_flight{ 4096 };
+	std::chrono::seconds report_interval{ 10 };
+	two_phase_options solver{};
+
+	/// @brief Parses the arguments which follow `--batch`
+	[[nodiscard]] static std::optional<batch_options> parse(const int argc, const char *const *argv);
+	[[nodiscard]] static std::string_view usage() noexcept;
+};
+
+/// @brief Solve times in buckets growing by 2^(1/8), from a microsecond to a couple of minutes
+class latency_histogram {
+public:
+	void add(const std::chrono::microseconds latency) noexcept;
+	void reset() noexcept { *this = latency_histogram{}; }
+
+	[[nodiscard]] uint64_t count() const noexcept { return m_count; }
+	/// @returns The upper bound of the bucket holding the @p fraction of the samples
+	[[nodiscard]] std::chrono::microseconds percentile(const double fraction) const noexcept;
+	[[nodiscard]] std::chrono::microseconds max() const noexcept { return m_max; }
+
+private:
+	static constexpr size_t steps_per_octave{ 8 };
+	static constexpr size_t bucket_count{ 28 * steps_per_octave };
+
+	std::array<uint64_t, bucket_count> m_buckets{};
+	uint64_t m_count{};
+	std::chrono::microseconds m_max{};
+};
+
+/// @brief Solves a stream of scrambles, one per line, on a thread pool without any window.
+/// A line is either a move sequence ("R U2 F' ...") or 54 facelets in the URFDLB order; a 2x2
+/// and the big cubes take move sequences only, with the inner layers and wide turns of theirs.
+/// The solutions are written in the input order, one line per input line, and the reading
+/// stalls while too many scrambles wait for their turn, so the memory stays bounded.
+class batch_solver {
+public:
+	explicit batch_solver(const batch_options &options);
+
+	/// @returns The exit code: 0 when every scramble was solved
+	[[nodiscard]] int run();
+
+private:
+	batch_options m_options;
+};
+
+} // namespace gzn::game::magicube
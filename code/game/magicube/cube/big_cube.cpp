@@ -0,0 +1,262 @@
+#include <array>
+#include <utility>
+#include <algorithm>
+
+#include <core/tools/cpu_features.hpp>
+
+#include "game/magicube/cube/big_cube.hpp"
+
+#if MAGICUBE_X86
+	#include <emmintrin.h>
+#endif
+
+namespace gzn::game::magicube {
+
+namespace {
+
+/// A row or a column of a face crossed by a layer. The layer is counted from the near edge of
+/// the face, the row 0 or the column 0, unless `far`; the stickers go from the left or the top
+/// unless `reversed`.
+struct layer_strip {
+	face on{};
+	bool column{};
+	bool far{};
+	bool reversed{};
+};
+
+/// The stickers of the strip `k` go to the strip `k + 1` when the face turns clockwise
+constexpr std::array<std::array<layer_strip, 4>, face_count> layer_strips{ {
+	{ { { face::R, false, false, false }, { face::F, false, false, false }, { face::L, false, false, false }, { face::B, false, false, false } } },
+	{ { { face::U, true, true, false }, { face::B, true, false, true }, { face::D, true, true, false }, { face::F, true, true, false } } },
+	{ { { face::U, false, true, false }, { face::R, true, false, false }, { face::D, false, false, true }, { face::L, true, true, true } } },
+	{ { { face::R, false, true, false }, { face::B, false, true, false }, { face::L, false, true, false }, { face::F, false, true, false } } },
+	{ { { face::U, true, false, false }, { face::F, true, false, false }, { face::D, true, false, false }, { face::B, true, true, true } } },
+	{ { { face::U, false, false, false }, { face::L, true, false, true }, { face::D, false, true, true }, { face::R, true, true, false } } },
+} };
+
+constexpr size_t tile_size{ 16 };
+
+#if MAGICUBE_X86
+
+/// Interleaving the rows `i` and `i + 8` rotates the 8-bit index `row * 16 + column` of every
+/// byte left by one bit; four rounds swap the nibbles, which is the transpose
+MAGICUBE_TARGET("sse2")
+inline void interleave_rows(const __m128i *rows, __m128i *output) noexcept {
+	for (size_t i{}; i < tile_size / 2; ++i) {
+		output[2 * i] = _mm_unpacklo_epi8(rows[i], rows[i + tile_size / 2]);
+		output[2 * i + 1] = _mm_unpackhi_epi8(rows[i], rows[i + tile_size / 2]);
+	}
+}
+
+MAGICUBE_TARGET("sse2")
+inline void transpose_tile(__m128i *rows) noexcept {
+	__m128i interleaved[tile_size];
+	interleave_rows(rows, interleaved);
+	interleave_rows(interleaved, rows);
+	interleave_rows(rows, interleaved);
+	interleave_rows(interleaved, rows);
+}
+
+/// The 16 bytes in the reverse order: the dwords, the words in them and the bytes in them
+MAGICUBE_TARGET("sse2")
+inline __m128i reverse_bytes(__m128i v) noexcept {
+	v = _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3));
+	v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+	return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+#endif
+
+/// The quarter turn of the n x n face @p source written into @p target. The face is covered by
+/// 16x16 tiles transposed in registers, loading the rows in the order that leaves nothing to
+/// reverse; the last tiles of a row overlap the ones before them rather than fall back to bytes.
+template<bool Clockwise>
+void rotate_tiles(const uint8_t *source, uint8_t *target, const size_t n) noexcept {
+#if MAGICUBE_X86
+	if (n >= tile_size) {
+		for (size_t next_row{}; next_row < n; next_row += tile_size) {
+			const auto tile_row{ std::min(next_row, n - tile_size) };
+			for (size_t next_column{}; next_column < n; next_column += tile_size) {
+				const auto tile_column{ std::min(next_column, n - tile_size) };
+
+				__m128i rows[tile_size];
+				for (size_t k{}; k < tile_size; ++k) {
+					const auto row{ Clockwise ? tile_row + tile_size - 1 - k : tile_row + k };
+					rows[k] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + row * n + tile_column));
+				}
+				transpose_tile(rows);
+				for (size_t i{}; i < tile_size; ++i) {
+					// clockwise: new[c][n - 1 - r] = old[r][c], counterclockwise: new[n - 1 - c][r] = old[r][c]
+					auto *output{ Clockwise
+						? target + (tile_column + i) * n + (n - tile_size - tile_row)
+						: target + (n - 1 - tile_column - i) * n + tile_row };
+					_mm_storeu_si128(reinterpret_cast<__m128i *>(output), rows[i]);
+				}
+			}
+		}
+		return;
+	}
+#endif
+	for (size_t row{}; row < n; ++row) {
+		for (size_t column{}; column < n; ++column) {
+			const auto sticker{ source[row * n + column] };
+			if constexpr (Clockwise) {
+				target[column * n + (n - 1 - row)] = sticker;
+			} else {
+				target[(n - 1 - column) * n + row] = sticker;
+			}
+		}
+	}
+}
+
+/// The half turn of a face, its stickers in the reverse order
+void reverse_stickers(uint8_t *stickers, const size_t count) noexcept {
+	size_t front{};
+	size_t back{ count };
+#if MAGICUBE_X86
+	for (; back - front >= 2 * tile_size; front += tile_size, back -= tile_size) {
+		auto *first{ reinterpret_cast<__m128i *>(stickers + front) };
+		auto *last{ reinterpret_cast<__m128i *>(stickers + back - tile_size) };
+		const auto head{ _mm_loadu_si128(first) };
+		_mm_storeu_si128(first, reverse_bytes(_mm_loadu_si128(last)));
+		_mm_storeu_si128(last, reverse_bytes(head));
+	}
+#endif
+	std::reverse(stickers + front, stickers + back);
+}
+
+} // anonymous namespace
+
+big_cube::big_cube(const size_t size)
+	: m_size{ size }
+	, m_spare(size * size) {
+	for (size_t f{}; f < face_count; ++f) {
+		m_faces[f].assign(size * size, static_cast<uint8_t>(f));
+	}
+}
+
+std::optional<big_cube> big_cube::create(const size_t size) {
+	if (size < min_size || size > max_size) {
+		return std::nullopt;
+	}
+	return big_cube{ size };
+}
+
+void big_cube::turn_layer(const face f, const size_t layer, const uint8_t power) noexcept {
+	if (layer >= m_size || power % 4 == 0) {
+		return;
+	}
+
+	const auto n{ static_cast<ptrdiff_t>(m_size) };
+	std::array<uint8_t *, 4> strips{};
+	std::array<ptrdiff_t, 4> strides{};
+	for (size_t k{}; k < 4; ++k) {
+		const auto &strip{ layer_strips[static_cast<size_t>(f)][k] };
+		const auto line{ static_cast<ptrdiff_t>(strip.far ? m_size - 1 - layer : layer) };
+		const ptrdiff_t step{ strip.column ? n : 1 };
+		const ptrdiff_t across{ strip.column ? 1 : n };
+		strips[k] = face_data(strip.on) + line * across + (strip.reversed ? (n - 1) * step : 0);
+		strides[k] = strip.reversed ? -step : step;
+	}
+
+	auto [s0, s1, s2, s3]{ strips };
+	const auto [d0, d1, d2, d3]{ strides };
+	switch (power % 4) {
+	case 1:
+		for (size_t i{}; i < m_size; ++i, s0 += d0, s1 += d1, s2 += d2, s3 += d3) {
+			const auto sticker{ *s3 };
+			*s3 = *s2;
+			*s2 = *s1;
+			*s1 = *s0;
+			*s0 = sticker;
+		}
+		break;
+	case 2:
+		for (size_t i{}; i < m_size; ++i, s0 += d0, s1 += d1, s2 += d2, s3 += d3) {
+			std::swap(*s0, *s2);
+			std::swap(*s1, *s3);
+		}
+		break;
+	default:
+		for (size_t i{}; i < m_size; ++i, s0 += d0, s1 += d1, s2 += d2, s3 += d3) {
+			const auto sticker{ *s0 };
+			*s0 = *s1;
+			*s1 = *s2;
+			*s2 = *s3;
+			*s3 = sticker;
+		}
+		break;
+	}
+
+	if (layer == 0) {
+		rotate_face(f, power);
+	}
+	if (layer == m_size - 1) {
+		// clockwise around the face is counterclockwise as seen from the opposite one
+		rotate_face(opposite(f), static_cast<uint8_t>(4 - power % 4));
+	}
+}
+
+bool big_cube::apply(const turn &t) noexcept {
+	size_t first{};
+	size_t last{};
+	switch (t.kind) {
+	case turn_kind::face:
+		first = t.layers - 1u;
+		last = t.layers;
+		break;
+	case turn_kind::wide:
+		last = t.layers;
+		break;
+	case turn_kind::slice:
+		if (m_size < 3) return false;
+		first = 1;
+		last = m_size - 1;
+		break;
+	case turn_kind::rotation:
+		last = m_size;
+		break;
+	}
+	if (t.layers == 0 || last > m_size) {
+		return false;
+	}
+
+	for (size_t layer{ first }; layer < last; ++layer) {
+		turn_layer(t.direction, layer, t.power);
+	}
+	return true;
+}
+
+bool big_cube::solved() const noexcept {
+	const size_t area{ m_size * m_size };
+	for (size_t f{}; f < face_count; ++f) {
+		const auto *stickers{ face_data(static_cast<face>(f)) };
+		if (std::find_if(stickers, stickers + area, [first = stickers[0]](const uint8_t sticker) {
+			return sticker != first;
+		}) != stickers + area) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void big_cube::rotate_face(const face f, const uint8_t power) noexcept {
+	auto &stickers{ m_faces[static_cast<size_t>(f)] };
+	switch (power % 4) {
+	case 1:
+		rotate_tiles<true>(stickers.data(), m_spare.data(), m_size);
+		stickers.swap(m_spare);
+		break;
+	case 2:
+		reverse_stickers(stickers.data(), stickers.size());
+		break;
+	case 3:
+		rotate_tiles<false>(stickers.data(), m_spare.data(), m_size);
+		stickers.swap(m_spare);
+		break;
+	default:
+		break;
+	}
+}
+
+} // namespace gzn::game::magicube
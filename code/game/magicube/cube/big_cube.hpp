@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <optional>
+#include <cinttypes>
+
+#include "game/magicube/cube/move.hpp"
+#include "game/magicube/cube/notation.hpp"
+
+namespace gzn::game::magicube {
+
+/// @brief The axes of a face of the cube: x goes to R, y to U and z to F
+struct face_frame {
+	std::array<int, 3> normal;
+	/// Where the columns and the rows of the face grow, as seen from the outside
+	std::array<int, 3> right;
+	std::array<int, 3> down;
+};
+
+/// In the order of the faces, the stickers of a face are laid out like the facelet string
+constexpr std::array<face_frame, face_count> face_frames{ {
+	{ { 0, 1, 0 }, { 1, 0, 0 }, { 0, 0, 1 } },
+	{ { 1, 0, 0 }, { 0, 0, -1 }, { 0, -1, 0 } },
+	{ { 0, 0, 1 }, { 1, 0, 0 }, { 0, -1, 0 } },
+	{ { 0, -1, 0 }, { 1, 0, 0 }, { 0, 0, -1 } },
+	{ { -1, 0, 0 }, { 0, 0, 1 }, { 0, -1, 0 } },
+	{ { 0, 0, -1 }, { -1, 0, 0 }, { 0, -1, 0 } },
+} };
+
+/// @brief The stickers of an NxN cube as face indices, a contiguous N*N array for every face.
+/// Every face is stored row by row as seen from the outside, oriented like the faces of the
+/// facelet string, so a 3x3 matches `facelet_cube` sticker for sticker.
+///
+/// A layer turn cycles four rows or columns of N stickers in place, with a stride of N for the
+/// columns, and turning an outer layer rotates its face into a spare array 16x16 tile by tile,
+/// each tile transposed in SSE registers, and swaps the arrays. A move costs O(N) plus O(N*N)
+/// for the face, never a pass over the whole cube.
+class big_cube {
+public:
+	static constexpr size_t min_size{ 2 };
+	/// The wide turns of the notation count up to 255 layers
+	static constexpr size_t max_size{ 255 };
+
+	/// @returns Nothing if @p size is out of `[min_size, max_size]`
+	[[nodiscard]] static std::optional<big_cube> create(const size_t size);
+
+	[[nodiscard]] size_t size() const noexcept { return m_size; }
+
+	/// @brief Turns the layer @p layer counted from @p f, 0 being the face itself, by @p power
+	/// clockwise quarter turns as seen from @p f
+	void turn_layer(const face f, const size_t layer, const uint8_t power) noexcept;
+
+	/// @brief A turn of the notation: `R` and `3R` turn one layer, `3Rw` the outer three, the
+	/// slices turn every inner layer, which is the middle one on a 3x3, and the rotations turn all
+	/// of them
+	/// @returns false if the turn needs more layers than the cube has
+	[[nodiscard]] bool apply(const turn &t) noexcept;
+	void apply(const move m) noexcept { turn_layer(face_of(m), 0, power_of(m)); }
+
+	[[nodiscard]] face at(const face f, const size_t row, const size_t column) const noexcept {
+		return static_cast<face>(face_data(f)[row * m_size + column]);
+	}
+	[[nodiscard]] const uint8_t *face_data(const face f) const noexcept { return m_faces[static_cast<size_t>(f)].data(); }
+
+	/// @brief Every face is of one color, however the cube is held
+	[[nodiscard]] bool solved() const noexcept;
+
+	[[nodiscard]] bool operator==(const big_cube &other) const noexcept {
+		return m_size == other.m_size && m_faces == other.m_faces;
+	}
+	[[nodiscard]] bool operator!=(const big_cube &other) const noexcept { return !(*this == other); }
+
+private:
+	size_t m_size;
+	std::array<std::vector<uint8_t>, face_count> m_faces;
+	/// Takes the place of the face it's rotated into
+	std::vector<uint8_t> m_spare;
+
+	explicit big_cube(const size_t size);
+
+	[[nodiscard]] uint8_t *face_data(const face f) noexcept { return m_faces[static_cast<size_t>(f)].data(); }
+
+	void rotate_face(const face f, const uint8_t power) noexcept;
+};
+
+} // namespace gzn::game::magicube
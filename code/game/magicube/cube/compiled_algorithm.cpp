@@ -0,0 +1,158 @@
+#include <array>
+
+#include "core/tools/cpu_features.hpp"
+#include "game/magicube/cube/compiled_algorithm.hpp"
+
+#if MAGICUBE_X86
+	#include <immintrin.h>
+#endif
+
+namespace gzn::game::magicube {
+
+namespace {
+
+using field_table = compiled_algorithm::field_table;
+
+void apply_algorithm_scalar(cube_state *states, const size_t count,
+	const field_table &corners, const field_table &edges) noexcept {
+	for (size_t i{}; i < count; ++i) {
+		states[i].apply(corners, edges);
+	}
+}
+
+#if MAGICUBE_X86
+
+constexpr size_t fields_per_word{ 8 };
+constexpr size_t states_per_step{ 4 };
+constexpr uint32_t edge_split{ fields_per_word * cube_state::field_bits };
+/// The 8 low fields of a word, the last 4 edges take half of them
+constexpr uint64_t word_fields{ (uint64_t{ 1 } << edge_split) - 1 };
+constexpr uint64_t last_edge_fields{ (uint64_t{ 1 } << (edge_split / 2)) - 1 };
+
+/// Every step moves the upper half of each group of fields to the upper half of a group twice
+/// as wide: the 8 fields are 2 groups of 4 in 32 bits, then 4 pairs in 16 bits and at last one
+/// field per byte. pdep and pext would do it in one instruction, but they are microcoded on
+/// AMD before Zen 3, hundreds of cycles each.
+struct spread_step {
+	uint32_t shift;
+	uint64_t low;
+	uint64_t high;
+};
+constexpr std::array<spread_step, 3> spread_steps{ {
+	{ 12, 0x00000000000FFFFFull, 0x000000FFFFF00000ull },
+	{ 6, 0x000003FF000003FFull, 0x000FFC00000FFC00ull },
+	{ 3, 0x001F001F001F001Full, 0x03E003E003E003E0ull },
+} };
+
+/// @brief The 8 low fields of every word of @p words in the 8 bytes of the word
+MAGICUBE_TARGET("avx2")
+inline __m256i spread_fields(__m256i words) noexcept {
+	for (const auto &[shift, low, high] : spread_steps) {
+		const auto low_fields{ _mm256_and_si256(words, _mm256_set1_epi64x(static_cast<int64_t>(low))) };
+		const auto high_fields{ _mm256_and_si256(words, _mm256_set1_epi64x(static_cast<int64_t>(high))) };
+		words = _mm256_or_si256(low_fields, _mm256_slli_epi64(high_fields, static_cast<int>(shift)));
+	}
+	return words;
+}
+
+/// @brief The inverse of `spread_fields`, the bytes hold 5-bit fields only
+MAGICUBE_TARGET("avx2")
+inline __m256i gather_fields(__m256i words) noexcept {
+	for (auto step{ spread_steps.rbegin() }; step != spread_steps.rend(); ++step) {
+		const auto low_fields{ _mm256_and_si256(words, _mm256_set1_epi64x(static_cast<int64_t>(step->low))) };
+		const auto high_fields{ _mm256_srli_epi64(words, static_cast<int>(step->shift)) };
+		words = _mm256_or_si256(low_fields, _mm256_and_si256(high_fields, _mm256_set1_epi64x(static_cast<int64_t>(step->high))));
+	}
+	return words;
+}
+
+/// vpshufb looks up only 16 entries, so the 32-entry table is split into two halves and the
+/// fifth bit of the field, moved to the top of the byte, picks one of them
+MAGICUBE_TARGET("avx2")
+inline __m256i lookup_fields(const __m256i fields, const __m256i low, const __m256i high) noexcept {
+	const auto select{ _mm256_slli_epi16(fields, 3) };
+	return _mm256_blendv_epi8(_mm256_shuffle_epi8(low, fields), _mm256_shuffle_epi8(high, fields), select);
+}
+
+MAGICUBE_TARGET("avx2")
+inline __m256i broadcast_half(const field_table &table, const size_t half) noexcept {
+	return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(table.data() + half * 16)));
+}
+
+MAGICUBE_TARGET("avx2")
+void apply_algorithm_avx2(cube_state *states, const size_t count,
+	const field_table &corners, const field_table &edges) noexcept {
+	static_assert(sizeof(cube_state) * states_per_step == 2 * sizeof(__m256i));
+
+	const auto corners_low{ broadcast_half(corners, 0) };
+	const auto corners_high{ broadcast_half(corners, 1) };
+	const auto edges_low{ broadcast_half(edges, 0) };
+	const auto edges_high{ broadcast_half(edges, 1) };
+	const auto word_mask{ _mm256_set1_epi64x(static_cast<int64_t>(word_fields)) };
+	const auto last_edge_mask{ _mm256_set1_epi64x(static_cast<int64_t>(last_edge_fields)) };
+
+	const size_t vectorized{ count - count % states_per_step };
+	for (size_t i{}; i < vectorized; i += states_per_step) {
+		auto *batch{ reinterpret_cast<__m256i *>(states + i) };
+		// the corners and the edges of the states 0, 2, 1 and 3, the order is undone by the store
+		const auto first{ _mm256_loadu_si256(batch) };
+		const auto second{ _mm256_loadu_si256(batch + 1) };
+		const auto corner_words{ _mm256_unpacklo_epi64(first, second) };
+		const auto edge_words{ _mm256_unpackhi_epi64(first, second) };
+
+		const auto moved_corners{ lookup_fields(spread_fields(corner_words), corners_low, corners_high) };
+		const auto moved_edges{ lookup_fields(spread_fields(edge_words), edges_low, edges_high) };
+		const auto moved_last_edges{ lookup_fields(spread_fields(_mm256_srli_epi64(edge_words, edge_split)), edges_low, edges_high) };
+
+		const auto corner_result{ _mm256_and_si256(gather_fields(moved_corners), word_mask) };
+		// the empty fields above the last 4 edges were looked up too
+		const auto edge_result{ _mm256_or_si256(_mm256_and_si256(gather_fields(moved_edges), word_mask),
+			_mm256_slli_epi64(_mm256_and_si256(gather_fields(moved_last_edges), last_edge_mask), edge_split)) };
+
+		_mm256_storeu_si256(batch, _mm256_unpacklo_epi64(corner_result, edge_result));
+		_mm256_storeu_si256(batch + 1, _mm256_unpackhi_epi64(corner_result, edge_result));
+	}
+	apply_algorithm_scalar(states + vectorized, count - vectorized, corners, edges);
+}
+
+#endif // MAGICUBE_X86
+
+using batch_function = void (*)(cube_state *, const size_t, const field_table &, const field_table &) noexcept;
+
+batch_function algorithm_function(const algorithm_kernel kernel) noexcept {
+	switch (kernel) {
+#if MAGICUBE_X86
+		case algorithm_kernel::avx2: return &apply_algorithm_avx2;
+#endif
+		default: return &apply_algorithm_scalar;
+	}
+}
+
+const batch_function default_batch_apply{ algorithm_function(compiled_algorithm::default_kernel()) };
+
+} // anonymous namespace
+
+void compiled_algorithm::apply(cube_state *states, const size_t count) const noexcept {
+	default_batch_apply(states, count, m_corners, m_edges);
+}
+
+void compiled_algorithm::apply(cube_state *states, const size_t count, const algorithm_kernel kernel) const noexcept {
+	algorithm_function(supported(kernel) ? kernel : algorithm_kernel::scalar)(states, count, m_corners, m_edges);
+}
+
+algorithm_kernel compiled_algorithm::default_kernel() noexcept {
+	if (supported(algorithm_kernel::avx2)) return algorithm_kernel::avx2;
+	return algorithm_kernel::scalar;
+}
+
+bool compiled_algorithm::supported(const algorithm_kernel kernel) noexcept {
+	switch (kernel) {
+#if MAGICUBE_X86
+		case algorithm_kernel::avx2: return core::tools::cpu().avx2;
+#endif
+		case algorithm_kernel::scalar: return true;
+		default: return false;
+	}
+}
+
+} // namespace gzn::game::magicube
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <iterator>
+#include <cinttypes>
+
+#include "game/magicube/cube/cube_state.hpp"
+
+namespace gzn::game::magicube {
+
+enum class algorithm_kernel : uint8_t { scalar, avx2 };
+
+/// @brief A move sequence composed into one permutation of the cubies together with the
+/// orientation changes. Whatever the length of the sequence, it's applied as a single move.
+class compiled_algorithm {
+public:
+	using field_table = cube_state::field_table;
+
+	constexpr compiled_algorithm() noexcept : compiled_algorithm{ cubie_cube{} } {}
+
+	/// @param permutation The state which the algorithm turns the solved cube into
+	constexpr explicit compiled_algorithm(const cubie_cube &permutation) noexcept
+		: m_permutation{ permutation } {
+		tables::make_fields(permutation, m_corners, m_edges);
+	}
+
+	template<class Iterator>
+	[[nodiscard]] static constexpr compiled_algorithm compile(Iterator first, const Iterator last) noexcept {
+		cubie_cube permutation{};
+		for (; first != last; ++first) {
+			permutation = magicube::apply(permutation, *first);
+		}
+		return compiled_algorithm{ permutation };
+	}
+	[[nodiscard]] static compiled_algorithm compile(const move_sequence &sequence) noexcept {
+		return compile(std::begin(sequence), std::end(sequence));
+	}
+
+	/// @brief This algorithm followed by @p next
+	[[nodiscard]] constexpr compiled_algorithm then(const compiled_algorithm &next) const noexcept {
+		return compiled_algorithm{ multiply(m_permutation, next.m_permutation) };
+	}
+	/// @brief The algorithm which undoes this one
+	[[nodiscard]] constexpr compiled_algorithm inverted() const noexcept {
+		return compiled_algorithm{ inverse(m_permutation) };
+	}
+
+	void apply(cube_state &state) const noexcept { state.apply(m_corners, m_edges); }
+	[[nodiscard]] cube_state applied(cube_state state) const noexcept {
+		apply(state);
+		return state;
+	}
+
+	/// @brief Applies the algorithm to each of the @p count states
+	void apply(cube_state *states, const size_t count) const noexcept;
+	void apply(cube_state *states, const size_t count, const algorithm_kernel kernel) const noexcept;
+
+	[[nodiscard]] constexpr const cubie_cube &permutation() const noexcept { return m_permutation; }
+	[[nodiscard]] constexpr const field_table &corner_fields() const noexcept { return m_corners; }
+	[[nodiscard]] constexpr const field_table &edge_fields() const noexcept { return m_edges; }
+
+	[[nodiscard]] constexpr bool operator==(const compiled_algorithm &other) const noexcept {
+		return m_permutation == other.m_permutation;
+	}
+	[[nodiscard]] constexpr bool operator!=(const compiled_algorithm &other) const noexcept {
+		return !(*this == other);
+	}
+
+	/// @brief The fastest kernel supported by the running CPU
+	[[nodiscard]] static algorithm_kernel default_kernel() noexcept;
+	[[nodiscard]] static bool supported(const algorithm_kernel kernel) noexcept;
+
+private:
+	cubie_cube m_permutation{};
+	alignas(32) field_table m_corners{};
+	alignas(32) field_table m_edges{};
+};
+
+} // namespace gzn::game::magicube
@@ -0,0 +1,81 @@
+#include <array>
+
+#include "game/magicube/cube/cube_state.hpp"
+
+namespace gzn::game::magicube {
+
+namespace {
+
+using field_table = cube_state::field_table;
+using tables::corner_field;
+using tables::edge_field;
+
+static_assert(tables::is_group_action(tables::field_moves), "The move tables aren't a group action");
+
+template<size_t Count>
+uint64_t apply_table(const uint64_t word, const field_table &table) noexcept {
+	uint64_t result{};
+	for (size_t i{}; i < Count; ++i) {
+		const auto shift{ i * cube_state::field_bits };
+		result |= uint64_t{ table[(word >> shift) & cube_state::field_mask] } << shift;
+	}
+	return result;
+}
+
+} // anonymous namespace
+
+cube_state cube_state::from_cubies(const cubie_cube &cube) noexcept {
+	cube_state state;
+	state.m_corners = 0;
+	for (size_t position{}; position < corner_count; ++position) {
+		const uint64_t field{ corner_field(position, cube.co[position]) };
+		state.m_corners |= field << (cube.cp[position] * field_bits);
+	}
+	state.m_edges = 0;
+	for (size_t position{}; position < edge_count; ++position) {
+		const uint64_t field{ edge_field(position, cube.eo[position]) };
+		state.m_edges |= field << (cube.ep[position] * field_bits);
+	}
+	return state;
+}
+
+cubie_cube cube_state::to_cubies() const noexcept {
+	cubie_cube cube;
+	for (size_t i{}; i < corner_count; ++i) {
+		const auto field{ (m_corners >> (i * field_bits)) & field_mask };
+		cube.cp[field & 0x7] = static_cast<uint8_t>(i);
+		cube.co[field & 0x7] = static_cast<uint8_t>(field >> 3);
+	}
+	for (size_t i{}; i < edge_count; ++i) {
+		const auto field{ (m_edges >> (i * field_bits)) & field_mask };
+		cube.ep[field & 0xF] = static_cast<uint8_t>(i);
+		cube.eo[field & 0xF] = static_cast<uint8_t>(field >> 4);
+	}
+	return cube;
+}
+
+cube_state inverse(const cube_state &state) noexcept {
+	// the cubie `i` at the position `p` turns into the cubie `p` at the position `i`
+	uint64_t corners{};
+	for (size_t i{}; i < corner_count; ++i) {
+		const auto field{ (state.corners() >> (i * cube_state::field_bits)) & cube_state::field_mask };
+		corners |= uint64_t{ corner_field(i, (3 - (field >> 3)) % 3) } << ((field & 0x7) * cube_state::field_bits);
+	}
+	uint64_t edges{};
+	for (size_t i{}; i < edge_count; ++i) {
+		const auto field{ (state.edges() >> (i * cube_state::field_bits)) & cube_state::field_mask };
+		edges |= uint64_t{ edge_field(i, field >> 4) } << ((field & 0xF) * cube_state::field_bits);
+	}
+	return cube_state::from_fields(corners, edges);
+}
+
+void cube_state::apply(const move m) noexcept {
+	apply(corner_moves(m), edge_moves(m));
+}
+
+void cube_state::apply(const field_table &corners, const field_table &edges) noexcept {
+	m_corners = apply_table<corner_count>(m_corners, corners);
+	m_edges = apply_table<edge_count>(m_edges, edges);
+}
+
+} // namespace gzn::game::magicube
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <iterator>
+#include <cinttypes>
+#include <functional>
+#include <type_traits>
+
+#include "game/magicube/cube/move.hpp"
+#include "game/magicube/cube/cubie.hpp"
+#include "game/magicube/cube/move_tables.hpp"
+
+namespace gzn::game::magicube {
+
+namespace detail {
+
+constexpr uint64_t pack_identity(const size_t count, const uint32_t bits) noexcept {
+	uint64_t word{};
+	for (size_t i{}; i < count; ++i) {
+		word |= uint64_t{ i } << (i * bits);
+	}
+	return word;
+}
+
+// murmur3 finalizer
+constexpr uint64_t mix(uint64_t value) noexcept {
+	value ^= value >> 33;
+	value *= 0xFF51AFD7ED558CCDull;
+	value ^= value >> 33;
+	value *= 0xC4CEB9FE1A85EC53ull;
+	value ^= value >> 33;
+	return value;
+}
+
+} // namespace detail
+
+/// @brief Bit-packed 3x3 cube state. Every cubie is stored as a 5-bit field holding the location
+/// and the twist of the cubie: `(twist << 3) | position` for corners and `(flip << 4) | position`
+/// for edges. Corners take 40 bits of one word and edges take 60 bits of another one.
+/// A face turn doesn't depend on the cubie, only on where it's located, so a move is applied as
+/// one lookup per field in a 32-entry table.
+class cube_state {
+public:
+	static constexpr uint32_t field_bits{ tables::field_bits };
+	static constexpr uint64_t field_mask{ (1u << field_bits) - 1 };
+	static constexpr size_t table_size{ tables::field_count };
+	using field_table = tables::field_table;
+
+	constexpr cube_state() noexcept = default;
+
+	[[nodiscard]] static cube_state from_cubies(const cubie_cube &cube) noexcept;
+	/// @brief Takes the packed words as they are, see `corners()` and `edges()`
+	[[nodiscard]] static constexpr cube_state from_fields(const uint64_t corners, const uint64_t edges) noexcept {
+		cube_state state;
+		state.m_corners = corners;
+		state.m_edges = edges;
+		return state;
+	}
+	[[nodiscard]] cubie_cube to_cubies() const noexcept;
+
+	void apply(const move m) noexcept;
+	/// @brief Moves every field through the tables, see `corner_moves()` and `edge_moves()`
+	void apply(const field_table &corners, const field_table &edges) noexcept;
+
+	template<class Iterator>
+	void apply(Iterator first, const Iterator last) noexcept {
+		for (; first != last; ++first) apply(*first);
+	}
+	void apply(const move_sequence &sequence) noexcept { apply(std::begin(sequence), std::end(sequence)); }
+
+	[[nodiscard]] cube_state moved(const move m) const noexcept {
+		auto result{ *this };
+		result.apply(m);
+		return result;
+	}
+
+	[[nodiscard]] constexpr bool solved() const noexcept {
+		return m_corners == solved_corners && m_edges == solved_edges;
+	}
+
+	/// @brief Where a corner field (`(twist << 3) | position`) goes after the move @p m
+	[[nodiscard]] static constexpr const field_table &corner_moves(const move m) noexcept {
+		return tables::field_moves.corners[static_cast<size_t>(m)];
+	}
+	/// @brief Where an edge field (`(flip << 4) | position`) goes after the move @p m
+	[[nodiscard]] static constexpr const field_table &edge_moves(const move m) noexcept {
+		return tables::field_moves.edges[static_cast<size_t>(m)];
+	}
+
+	[[nodiscard]] constexpr uint64_t corners() const noexcept { return m_corners; }
+	[[nodiscard]] constexpr uint64_t edges() const noexcept { return m_edges; }
+
+	[[nodiscard]] constexpr uint64_t hash() const noexcept {
+		return detail::mix(m_edges ^ detail::mix(m_corners));
+	}
+
+	[[nodiscard]] constexpr bool operator==(const cube_state &other) const noexcept {
+		return m_corners == other.m_corners && m_edges == other.m_edges;
+	}
+	[[nodiscard]] constexpr bool operator!=(const cube_state &other) const noexcept {
+		return !(*this == other);
+	}
+
+private:
+	static constexpr uint64_t solved_corners{ detail::pack_identity(corner_count, field_bits) };
+	static constexpr uint64_t solved_edges{ detail::pack_identity(edge_count, field_bits) };
+
+	uint64_t m_corners{ solved_corners };
+	uint64_t m_edges{ solved_edges };
+};
+
+/// @brief The state which the moves that lead to @p state turn back into the solved cube
+[[nodiscard]] cube_state inverse(const cube_state &state) noexcept;
+
+static_assert(std::is_trivially_copyable_v<cube_state>);
+static_assert(sizeof(cube_state) == 2 * sizeof(uint64_t));
+
+} // namespace gzn::game::magicube
+
+template<>
+struct std::hash<gzn::game::magicube::cube_state> {
+	[[nodiscard]] size_t operator()(const gzn::game::magicube::cube_state &state) const noexcept {
+		return static_cast<size_t>(state.hash());
+	}
+};
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <array>
+#include <cinttypes>
+
+#include "game/magicube/cube/move.hpp"
+
+namespace gzn::game::magicube {
+
+enum class corner : uint8_t { URF, UFL, ULB, UBR, DFR, DLF, DBL, DRB };
+enum class edge : uint8_t { UR, UF, UL, UB, DR, DF, DL, DB, FR, FL, BL, BR };
+
+constexpr size_t corner_count{ 8 };
+constexpr size_t edge_count{ 12 };
+
+/// @brief Position-based cubie representation: `cp[i]` is the corner which occupies the
+/// position `i` and `co[i]` is its twist (the same goes for edges).
+/// It's the unpacked interchange format between the different cube representations.
+struct cubie_cube {
+	std::array<uint8_t, corner_count> cp{ 0, 1, 2, 3, 4, 5, 6, 7 };
+	std::array<uint8_t, corner_count> co{};
+	std::array<uint8_t, edge_count> ep{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+	std::array<uint8_t, edge_count> eo{};
+
+	[[nodiscard]] constexpr bool operator==(const cubie_cube &other) const noexcept {
+		for (size_t i{}; i < corner_count; ++i) {
+			if (cp[i] != other.cp[i] || co[i] != other.co[i]) return false;
+		}
+		for (size_t i{}; i < edge_count; ++i) {
+			if (ep[i] != other.ep[i] || eo[i] != other.eo[i]) return false;
+		}
+		return true;
+	}
+	[[nodiscard]] constexpr bool operator!=(const cubie_cube &other) const noexcept {
+		return !(*this == other);
+	}
+};
+
+/// @brief Composition: the state after applying @p lhs and then @p rhs to the solved cube
+[[nodiscard]] constexpr cubie_cube multiply(const cubie_cube &lhs, const cubie_cube &rhs) noexcept {
+	cubie_cube result{};
+	for (size_t i{}; i < corner_count; ++i) {
+		result.cp[i] = lhs.cp[rhs.cp[i]];
+		result.co[i] = (lhs.co[rhs.cp[i]] + rhs.co[i]) % 3;
+	}
+	for (size_t i{}; i < edge_count; ++i) {
+		result.ep[i] = lhs.ep[rhs.ep[i]];
+		result.eo[i] = (lhs.eo[rhs.ep[i]] + rhs.eo[i]) % 2;
+	}
+	return result;
+}
+
+[[nodiscard]] constexpr cubie_cube inverse(const cubie_cube &cube) noexcept {
+	cubie_cube result{};
+	for (size_t i{}; i < corner_count; ++i) {
+		result.cp[cube.cp[i]] = static_cast<uint8_t>(i);
+		result.co[cube.cp[i]] = (3 - cube.co[i]) % 3;
+	}
+	for (size_t i{}; i < edge_count; ++i) {
+		result.ep[cube.ep[i]] = static_cast<uint8_t>(i);
+		result.eo[cube.ep[i]] = cube.eo[i];
+	}
+	return result;
+}
+
+/// @brief Clockwise quarter turn of the face @p f applied to the solved cube
+[[nodiscard]] constexpr cubie_cube face_turn(const face f) noexcept {
+	constexpr std::array<cubie_cube, face_count> turns{
+		cubie_cube{ // U
+			{ 3, 0, 1, 2, 4, 5, 6, 7 }, { 0, 0, 0, 0, 0, 0, 0, 0 },
+			{ 3, 0, 1, 2, 4, 5, 6, 7, 8, 9, 10, 11 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }
+		},
+		cubie_cube{ // R
+			{ 4, 1, 2, 0, 7, 5, 6, 3 }, { 2, 0, 0, 1, 1, 0, 0, 2 },
+			{ 8, 1, 2, 3, 11, 5, 6, 7, 4, 9, 10, 0 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }
+		},
+		cubie_cube{ // F
+			{ 1, 5, 2, 3, 0, 4, 6, 7 }, { 1, 2, 0, 0, 2, 1, 0, 0 },
+			{ 0, 9, 2, 3, 4, 8, 6, 7, 1, 5, 10, 11 }, { 0, 1, 0, 0, 0, 1, 0, 0, 1, 1, 0, 0 }
+		},
+		cubie_cube{ // D
+			{ 0, 1, 2, 3, 5, 6, 7, 4 }, { 0, 0, 0, 0, 0, 0, 0, 0 },
+			{ 0, 1, 2, 3, 5, 6, 7, 4, 8, 9, 10, 11 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }
+		},
+		cubie_cube{ // L
+			{ 0, 2, 6, 3, 4, 1, 5, 7 }, { 0, 1, 2, 0, 0, 2, 1, 0 },
+			{ 0, 1, 10, 3, 4, 5, 9, 7, 8, 2, 6, 11 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }
+		},
+		cubie_cube{ // B
+			{ 0, 1, 3, 7, 4, 5, 2, 6 }, { 0, 0, 1, 2, 0, 0, 2, 1 },
+			{ 0, 1, 2, 11, 4, 5, 6, 10, 8, 9, 3, 7 }, { 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 1, 1 }
+		},
+	};
+	return turns[static_cast<size_t>(f)];
+}
+
+[[nodiscard]] constexpr cubie_cube apply(const cubie_cube &cube, const move m) noexcept {
+	const auto turn{ face_turn(face_of(m)) };
+	auto result{ cube };
+	for (uint8_t i{}; i < power_of(m); ++i) {
+		result = multiply(result, turn);
+	}
+	return result;
+}
+
+template<size_t Size>
+[[nodiscard]] constexpr bool odd_permutation(const std::array<uint8_t, Size> &permutation) noexcept {
+	bool odd{ false };
+	for (size_t i{}; i < Size; ++i) {
+		for (size_t j{ i + 1 }; j < Size; ++j) {
+			odd ^= permutation[i] > permutation[j];
+		}
+	}
+	return odd;
+}
+
+/// @brief Checks the cubie permutations and the parity and orientation invariants
+[[nodiscard]] constexpr bool is_solvable(const cubie_cube &cube) noexcept {
+	uint32_t corners_seen{};
+	uint32_t twist{};
+	for (size_t i{}; i < corner_count; ++i) {
+		if (cube.cp[i] >= corner_count || cube.co[i] > 2) return false;
+		corners_seen |= 1u << cube.cp[i];
+		twist += cube.co[i];
+	}
+	uint32_t edges_seen{};
+	uint32_t flip{};
+	for (size_t i{}; i < edge_count; ++i) {
+		if (cube.ep[i] >= edge_count || cube.eo[i] > 1) return false;
+		edges_seen |= 1u << cube.ep[i];
+		flip += cube.eo[i];
+	}
+	return corners_seen == 0xFFu && edges_seen == 0xFFFu
+		&& twist % 3 == 0 && flip % 2 == 0
+		&& odd_permutation(cube.cp) == odd_permutation(cube.ep);
+}
+
+} // namespace gzn::game::magicube
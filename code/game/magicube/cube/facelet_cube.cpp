@@ -0,0 +1,335 @@
+#include <cstring>
+
+#include "core/tools/cpu_features.hpp"
+#include "game/magicube/cube/facelet_cube.hpp"
+
+#if MAGICUBE_X86
+	#include <immintrin.h>
+#endif
+
+namespace gzn::game::magicube {
+
+namespace {
+
+constexpr size_t lane_size{ 16 };
+constexpr size_t lane_count{ facelet_cube::storage_size / lane_size };
+constexpr uint8_t zero_lane_byte{ 0x80 }; // pshufb writes zero when the high bit is set
+
+constexpr std::array<std::array<uint8_t, 3>, corner_count> corner_facelets{ {
+	{  8,  9, 20 }, {  6, 18, 38 }, {  0, 36, 47 }, {  2, 45, 11 },
+	{ 29, 26, 15 }, { 27, 44, 24 }, { 33, 53, 42 }, { 35, 17, 51 },
+} };
+
+constexpr std::array<std::array<uint8_t, 2>, edge_count> edge_facelets{ {
+	{  5, 10 }, {  7, 19 }, {  3, 37 }, {  1, 46 }, { 32, 16 }, { 28, 25 },
+	{ 30, 43 }, { 34, 52 }, { 23, 12 }, { 21, 41 }, { 50, 39 }, { 48, 14 },
+} };
+
+constexpr std::array<std::array<face, 3>, corner_count> corner_colors{ {
+	{ face::U, face::R, face::F }, { face::U, face::F, face::L },
+	{ face::U, face::L, face::B }, { face::U, face::B, face::R },
+	{ face::D, face::F, face::R }, { face::D, face::L, face::F },
+	{ face::D, face::B, face::L }, { face::D, face::R, face::B },
+} };
+
+constexpr std::array<std::array<face, 2>, edge_count> edge_colors{ {
+	{ face::U, face::R }, { face::U, face::F }, { face::U, face::L }, { face::U, face::B },
+	{ face::D, face::R }, { face::D, face::F }, { face::D, face::L }, { face::D, face::B },
+	{ face::F, face::R }, { face::F, face::L }, { face::B, face::L }, { face::B, face::R },
+} };
+
+constexpr uint8_t unknown_cubie{ 0xFF };
+
+/// Corner index by the colors following its U/D sticker clockwise
+constexpr auto corner_by_colors{ [] {
+	std::array<std::array<uint8_t, face_count>, face_count> table{};
+	for (auto &row : table) for (auto &value : row) value = unknown_cubie;
+	for (size_t j{}; j < corner_count; ++j) {
+		table[static_cast<size_t>(corner_colors[j][1])][static_cast<size_t>(corner_colors[j][2])] =
+			static_cast<uint8_t>(j);
+	}
+	return table;
+}() };
+
+/// Edge index by its two colors, the flipped edges are marked with the high bit
+constexpr auto edge_by_colors{ [] {
+	std::array<std::array<uint8_t, face_count>, face_count> table{};
+	for (auto &row : table) for (auto &value : row) value = unknown_cubie;
+	for (size_t j{}; j < edge_count; ++j) {
+		const auto first{ static_cast<size_t>(edge_colors[j][0]) };
+		const auto second{ static_cast<size_t>(edge_colors[j][1]) };
+		table[first][second] = static_cast<uint8_t>(j);
+		table[second][first] = static_cast<uint8_t>(j | 0x80);
+	}
+	return table;
+}() };
+
+using facelet_permutation = facelet_cube::storage_type;
+
+/// masks[source lane][destination lane] select the bytes of the destination lane which come
+/// from the source lane, the rest of the bytes are zeroed by the shuffle
+struct alignas(32) lane_masks {
+	std::array<std::array<std::array<uint8_t, lane_size>, lane_count>, lane_count> masks{};
+};
+
+struct facelet_tables {
+	std::array<facelet_permutation, move_count> permutations{};
+	std::array<lane_masks, move_count> shuffles{};
+};
+
+constexpr facelet_tables make_facelet_tables() noexcept {
+	facelet_tables tables{};
+	for (size_t m{}; m < move_count; ++m) {
+		auto &source_of{ tables.permutations[m] };
+		for (size_t i{}; i < source_of.size(); ++i) {
+			source_of[i] = static_cast<uint8_t>(i);
+		}
+
+		// the sticker shown on the facelet came from the same facelet of the cubie in the solved cube
+		const auto turn{ apply(cubie_cube{}, static_cast<move>(m)) };
+		for (size_t i{}; i < corner_count; ++i) {
+			for (size_t n{}; n < 3; ++n) {
+				source_of[corner_facelets[i][(n + turn.co[i]) % 3]] = corner_facelets[turn.cp[i]][n];
+			}
+		}
+		for (size_t i{}; i < edge_count; ++i) {
+			for (size_t n{}; n < 2; ++n) {
+				source_of[edge_facelets[i][(n + turn.eo[i]) % 2]] = edge_facelets[turn.ep[i]][n];
+			}
+		}
+
+		auto &masks{ tables.shuffles[m].masks };
+		for (auto &source_lane : masks) {
+			for (auto &destination_lane : source_lane) {
+				for (auto &byte : destination_lane) {
+					byte = zero_lane_byte;
+				}
+			}
+		}
+		for (size_t i{}; i < source_of.size(); ++i) {
+			masks[source_of[i] / lane_size][i / lane_size][i % lane_size] = source_of[i] % lane_size;
+		}
+	}
+	return tables;
+}
+
+constexpr facelet_tables facelet_move_tables{ make_facelet_tables() };
+
+void apply_scalar(uint8_t *facelets, const size_t m) noexcept {
+	std::array<uint8_t, facelet_cube::storage_size> source;
+	std::memcpy(source.data(), facelets, source.size());
+
+	const auto &source_of{ facelet_move_tables.permutations[m] };
+	for (size_t i{}; i < facelet_count; ++i) {
+		facelets[i] = source[source_of[i]];
+	}
+}
+
+#if MAGICUBE_X86
+
+MAGICUBE_TARGET("ssse3")
+void apply_ssse3(uint8_t *facelets, const size_t m) noexcept {
+	auto lanes{ reinterpret_cast<__m128i *>(facelets) };
+	const auto &masks{ facelet_move_tables.shuffles[m].masks };
+
+	__m128i source[lane_count];
+	for (size_t k{}; k < lane_count; ++k) {
+		source[k] = _mm_load_si128(lanes + k);
+	}
+
+	for (size_t j{}; j < lane_count; ++j) {
+		__m128i result{ _mm_setzero_si128() };
+		for (size_t k{}; k < lane_count; ++k) {
+			const auto mask{ _mm_load_si128(reinterpret_cast<const __m128i *>(masks[k][j].data())) };
+			result = _mm_or_si128(result, _mm_shuffle_epi8(source[k], mask));
+		}
+		_mm_store_si128(lanes + j, result);
+	}
+}
+
+MAGICUBE_TARGET("avx2")
+void apply_avx2(uint8_t *facelets, const size_t m) noexcept {
+	// vpshufb doesn't cross 128-bit lanes, so every source lane is broadcast to both halves
+	// and shuffled into two destination lanes at once
+	const auto lanes{ reinterpret_cast<const __m128i *>(facelets) };
+	const auto &masks{ facelet_move_tables.shuffles[m].masks };
+
+	__m256i source[lane_count];
+	for (size_t k{}; k < lane_count; ++k) {
+		source[k] = _mm256_broadcastsi128_si256(_mm_load_si128(lanes + k));
+	}
+
+	auto halves{ reinterpret_cast<__m256i *>(facelets) };
+	for (size_t j{}; j < lane_count / 2; ++j) {
+		__m256i result{ _mm256_setzero_si256() };
+		for (size_t k{}; k < lane_count; ++k) {
+			const auto mask{ _mm256_load_si256(reinterpret_cast<const __m256i *>(masks[k][2 * j].data())) };
+			result = _mm256_or_si256(result, _mm256_shuffle_epi8(source[k], mask));
+		}
+		_mm256_store_si256(halves + j, result);
+	}
+}
+
+#endif // MAGICUBE_X86
+
+using apply_function = void (*)(uint8_t *, const size_t) noexcept;
+
+apply_function kernel_function(const facelet_kernel kernel) noexcept {
+	switch (kernel) {
+#if MAGICUBE_X86
+		case facelet_kernel::avx2:  return &apply_avx2;
+		case facelet_kernel::ssse3: return &apply_ssse3;
+#endif
+		default: return &apply_scalar;
+	}
+}
+
+const apply_function default_apply{ kernel_function(facelet_cube::default_kernel()) };
+
+constexpr std::array<uint8_t, 256> make_face_indices() noexcept {
+	std::array<uint8_t, 256> indices{};
+	for (auto &index : indices) index = 0xFF;
+	for (size_t f{}; f < face_names.size(); ++f) {
+		indices[static_cast<uint8_t>(face_names[f])] = static_cast<uint8_t>(f);
+	}
+	return indices;
+}
+
+constexpr auto face_indices{ make_face_indices() };
+
+} // anonymous namespace
+
+facelet_cube::facelet_cube() noexcept {
+	m_facelets.fill(0);
+	for (size_t i{}; i < facelet_count; ++i) {
+		m_facelets[i] = static_cast<uint8_t>(i / facelets_per_face);
+	}
+}
+
+std::optional<facelet_cube> facelet_cube::from_string(const std::string_view text) noexcept {
+	if (text.size() != facelet_count) {
+		return std::nullopt;
+	}
+
+	facelet_cube cube;
+	std::array<uint8_t, face_count> counts{};
+	for (size_t i{}; i < facelet_count; ++i) {
+		const auto index{ face_indices[static_cast<uint8_t>(text[i])] };
+		if (index >= face_count) {
+			return std::nullopt;
+		}
+		cube.m_facelets[i] = index;
+		++counts[index];
+	}
+
+	for (size_t f{}; f < face_count; ++f) {
+		const auto center{ f * facelets_per_face + facelets_per_face / 2 };
+		if (counts[f] != facelets_per_face || cube.m_facelets[center] != f) {
+			return std::nullopt;
+		}
+	}
+	return cube;
+}
+
+facelet_cube facelet_cube::from_cubies(const cubie_cube &cube) noexcept {
+	facelet_cube result;
+	for (size_t i{}; i < corner_count; ++i) {
+		for (size_t n{}; n < 3; ++n) {
+			result.m_facelets[corner_facelets[i][(n + cube.co[i]) % 3]] =
+				static_cast<uint8_t>(corner_colors[cube.cp[i]][n]);
+		}
+	}
+	for (size_t i{}; i < edge_count; ++i) {
+		for (size_t n{}; n < 2; ++n) {
+			result.m_facelets[edge_facelets[i][(n + cube.eo[i]) % 2]] =
+				static_cast<uint8_t>(edge_colors[cube.ep[i]][n]);
+		}
+	}
+	return result;
+}
+
+void facelet_cube::to_string(char *output) const noexcept {
+	for (size_t i{}; i < facelet_count; ++i) {
+		output[i] = face_names[m_facelets[i]];
+	}
+}
+
+std::string facelet_cube::to_string() const {
+	std::string text(facelet_count, ' ');
+	to_string(text.data());
+	return text;
+}
+
+std::optional<cubie_cube> facelet_cube::to_cubies() const noexcept {
+	cubie_cube cube;
+	uint32_t corners_seen{};
+	for (size_t i{}; i < corner_count; ++i) {
+		const auto &facelets{ corner_facelets[i] };
+		uint8_t twist{};
+		while (twist < 3 && at(facelets[twist]) != face::U && at(facelets[twist]) != face::D) {
+			++twist;
+		}
+		if (twist == 3) return std::nullopt;
+
+		const auto j{ corner_by_colors[m_facelets[facelets[(twist + 1) % 3]]][m_facelets[facelets[(twist + 2) % 3]]] };
+		// the side colors name the corner, its U/D sticker has to be the one of the same corner
+		if (j == unknown_cubie || at(facelets[twist]) != corner_colors[j][0]) return std::nullopt;
+
+		cube.cp[i] = j;
+		cube.co[i] = twist;
+		corners_seen |= 1u << j;
+	}
+
+	uint32_t edges_seen{};
+	for (size_t i{}; i < edge_count; ++i) {
+		const auto j{ edge_by_colors[m_facelets[edge_facelets[i][0]]][m_facelets[edge_facelets[i][1]]] };
+		if (j == unknown_cubie) return std::nullopt;
+
+		cube.ep[i] = j & 0x7F;
+		cube.eo[i] = j >> 7;
+		edges_seen |= 1u << cube.ep[i];
+	}
+
+	if (corners_seen != 0xFFu || edges_seen != 0xFFFu) {
+		return std::nullopt;
+	}
+	return cube;
+}
+
+void facelet_cube::apply(const move m) noexcept {
+	default_apply(m_facelets.data(), static_cast<size_t>(m));
+}
+
+void facelet_cube::apply(const move m, const facelet_kernel kernel) noexcept {
+	kernel_function(supported(kernel) ? kernel : facelet_kernel::scalar)(
+		m_facelets.data(), static_cast<size_t>(m));
+}
+
+void facelet_cube::apply(const move_sequence &sequence) noexcept {
+	for (const auto m : sequence) {
+		default_apply(m_facelets.data(), static_cast<size_t>(m));
+	}
+}
+
+bool facelet_cube::solved() const noexcept {
+	return *this == facelet_cube{};
+}
+
+facelet_kernel facelet_cube::default_kernel() noexcept {
+	if (supported(facelet_kernel::avx2)) return facelet_kernel::avx2;
+	if (supported(facelet_kernel::ssse3)) return facelet_kernel::ssse3;
+	return facelet_kernel::scalar;
+}
+
+bool facelet_cube::supported(const facelet_kernel kernel) noexcept {
+	switch (kernel) {
+#if MAGICUBE_X86
+		case facelet_kernel::avx2:  return core::tools::cpu().avx2;
+		case facelet_kernel::ssse3: return core::tools::cpu().ssse3;
+#endif
+		case facelet_kernel::scalar: return true;
+		default: return false;
+	}
+}
+
+} // namespace gzn::game::magicube
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <optional>
+#include <cinttypes>
+#include <string_view>
+
+#include "game/magicube/cube/move.hpp"
+#include "game/magicube/cube/cubie.hpp"
+
+namespace gzn::game::magicube {
+
+constexpr size_t facelets_per_face{ 9 };
+constexpr size_t facelet_count{ face_count * facelets_per_face };
+
+enum class facelet_kernel : uint8_t { scalar, ssse3, avx2 };
+
+/// @brief 54 stickers stored as face indices in the order of the facelet string
+/// `U1..U9 R1..R9 F1..F9 D1..D9 L1..L9 B1..B9`. The storage is padded to 64 bytes so the
+/// whole cube fits into one cache line and a face turn is a byte shuffle of four 16-byte lanes.
+class facelet_cube {
+public:
+	static constexpr size_t storage_size{ 64 };
+	using storage_type = std::array<uint8_t, storage_size>;
+
+	facelet_cube() noexcept;
+
+	[[nodiscard]] static std::optional<facelet_cube> from_string(const std::string_view text) noexcept;
+	[[nodiscard]] static facelet_cube from_cubies(const cubie_cube &cube) noexcept;
+
+	/// @brief Writes exactly `facelet_count` characters into @p output
+	void to_string(char *output) const noexcept;
+	[[nodiscard]] std::string to_string() const;
+
+	/// @returns Nothing if the stickers don't form valid cubies
+	[[nodiscard]] std::optional<cubie_cube> to_cubies() const noexcept;
+
+	void apply(const move m) noexcept;
+	void apply(const move m, const facelet_kernel kernel) noexcept;
+	void apply(const move_sequence &sequence) noexcept;
+
+	[[nodiscard]] face at(const size_t index) const noexcept { return static_cast<face>(m_facelets[index]); }
+	[[nodiscard]] const storage_type &data() const noexcept { return m_facelets; }
+
+	[[nodiscard]] bool solved() const noexcept;
+
+	[[nodiscard]] bool operator==(const facelet_cube &other) const noexcept { return m_facelets == other.m_facelets; }
+	[[nodiscard]] bool operator!=(const facelet_cube &other) const noexcept { return !(*this == other); }
+
+	/// @brief The fastest kernel supported by the running CPU
+	[[nodiscard]] static facelet_kernel default_kernel() noexcept;
+	[[nodiscard]] static bool supported(const facelet_kernel kernel) noexcept;
+
+private:
+	alignas(storage_size) storage_type m_facelets;
+};
+
+} // namespace gzn::game::magicube
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cinttypes>
+#include <string_view>
+
+namespace gzn::game::magicube {
+
+enum class face : uint8_t { U, R, F, D, L, B };
+
+enum class move : uint8_t {
+	U1, U2, U3,
+	R1, R2, R3,
+	F1, F2, F3,
+	D1, D2, D3,
+	L1, L2, L3,
+	B1, B2, B3,
+};
+
+using move_sequence = std::vector<move>;
+
+constexpr size_t face_count{ 6 };
+constexpr size_t move_count{ 18 };
+
+[[nodiscard]] constexpr move make_move(const face f, const uint8_t power) noexcept {
+	return static_cast<move>(static_cast<uint8_t>(f) * 3 + (power - 1) % 3);
+}
+
+[[nodiscard]] constexpr face face_of(const move m) noexcept {
+	return static_cast<face>(static_cast<uint8_t>(m) / 3);
+}
+
+/// @brief Number of clockwise quarter turns: 1, 2 or 3
+[[nodiscard]] constexpr uint8_t power_of(const move m) noexcept {
+	return static_cast<uint8_t>(m) % 3 + 1;
+}
+
+[[nodiscard]] constexpr move inverse(const move m) noexcept {
+	return make_move(face_of(m), 4 - power_of(m));
+}
+
+[[nodiscard]] constexpr face opposite(const face f) noexcept {
+	return static_cast<face>((static_cast<uint8_t>(f) + 3) % face_count);
+}
+
+/// @brief Where the face @p f goes when the whole cube turns a quarter the same way as the face
+/// @p axis: x is the rotation of R, y of U and z of F
+[[nodiscard]] constexpr face rotated(const face f, const face axis) noexcept {
+	constexpr std::array<std::array<face, face_count>, 3> quarter_rotations{ {
+		{ face::U, face::F, face::L, face::D, face::B, face::R }, // y
+		{ face::B, face::R, face::U, face::F, face::L, face::D }, // x
+		{ face::R, face::D, face::F, face::L, face::U, face::B }, // z
+	} };
+	if (axis >= face::D) {
+		// a quarter turn of D is three quarter turns of U
+		const auto other{ opposite(axis) };
+		return rotated(rotated(rotated(f, other), other), other);
+	}
+	return quarter_rotations[static_cast<size_t>(axis)][static_cast<size_t>(f)];
+}
+
+/// @brief Whether a move of the face @p next may follow a move of the face @p previous in a
+/// canonical sequence: the same face twice in a row is one move, and of two opposite faces,
+/// which commute, the one with the lower index goes first (U before D, R before L, F before B)
+[[nodiscard]] constexpr bool canonical_successor(const face previous, const face next) noexcept {
+	return next != previous && !(next == opposite(previous) && next < previous);
+}
+
+namespace detail {
+
+constexpr std::array<uint32_t, face_count + 1> make_canonical_successors() noexcept {
+	std::array<uint32_t, face_count + 1> successors{};
+	for (size_t previous{}; previous <= face_count; ++previous) {
+		for (size_t m{}; m < move_count; ++m) {
+			const auto next{ face_of(static_cast<move>(m)) };
+			if (previous == face_count || canonical_successor(static_cast<face>(previous), next)) {
+				successors[previous] |= 1u << m;
+			}
+		}
+	}
+	return successors;
+}
+
+inline constexpr auto canonical_successor_moves{ make_canonical_successors() };
+
+} // namespace detail
+
+/// @brief Bit `m` is set for every move which may follow a move of the face @p previous, see
+/// `canonical_successor()`; `face_count` stands for the start of a sequence. A search over
+/// canonical sequences branches 13.35 times per move on average instead of 18.
+[[nodiscard]] constexpr uint32_t canonical_successors(const size_t previous) noexcept {
+	return detail::canonical_successor_moves[previous];
+}
+
+/// The letters of the faces, in the order of `face`
+constexpr std::string_view face_names{ "URFDLB" };
+
+[[nodiscard]] constexpr std::string_view to_string(const move m) noexcept {
+	constexpr std::array<std::string_view, move_count> names{
+		"U", "U2", "U'", "R", "R2", "R'", "F", "F2", "F'",
+		"D", "D2", "D'", "L", "L2", "L'", "B", "B2", "B'",
+	};
+	return names[static_cast<size_t>(m)];
+}
+
+} // namespace gzn::game::magicube
@@ -0,0 +1,235 @@
+#include <array>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "game/magicube/cube/move_optimizer.hpp"
+
+namespace gzn::game::magicube {
+
+namespace {
+
+constexpr uint8_t no_successor{ 0xFF };
+constexpr size_t max_successors{ 15 };
+
+struct successor_tables {
+	/// moves[previous][index] is the index-th canonical successor of the face `previous`
+	std::array<std::array<move, max_successors>, face_count> moves{};
+	std::array<std::array<uint8_t, move_count>, face_count> indices{};
+	std::array<uint8_t, face_count> counts{};
+};
+
+constexpr successor_tables make_successor_tables() noexcept {
+	successor_tables tables{};
+	for (size_t previous{}; previous < face_count; ++previous) {
+		size_t index{};
+		for (size_t m{}; m < move_count; ++m) {
+			tables.indices[previous][m] = no_successor;
+			if (canonical_successors(previous) & (1u << m)) {
+				tables.moves[previous][index] = static_cast<move>(m);
+				tables.indices[previous][m] = static_cast<uint8_t>(index++);
+			}
+		}
+		tables.counts[previous] = static_cast<uint8_t>(index);
+	}
+	return tables;
+}
+
+constexpr successor_tables successors{ make_successor_tables() };
+
+static_assert(successors.indices[static_cast<size_t>(face::U)][static_cast<size_t>(move::B3)] == max_successors - 1,
+	"The successors of a face have to fit into a nibble");
+
+/// Merges @p m into the canonical sequence of @p length moves at @p moves, which has room for
+/// one more move
+void push_canonical(move *moves, size_t &length, const move m) noexcept {
+	const auto f{ face_of(m) };
+
+	// the same face right before, or right before a turn of the opposite face
+	size_t same{ length };
+	if (length >= 1 && face_of(moves[length - 1]) == f) {
+		same = length - 1;
+	} else if (length >= 2 && face_of(moves[length - 1]) == opposite(f) && face_of(moves[length - 2]) == f) {
+		same = length - 2;
+	}
+
+	if (same < length) {
+		const auto power{ static_cast<uint8_t>((power_of(moves[same]) + power_of(m)) % 4) };
+		if (power != 0) {
+			moves[same] = make_move(f, power);
+			return;
+		}
+		// the turns cancel out
+		if (same + 2 == length) {
+			moves[same] = moves[same + 1];
+		}
+		--length;
+		return;
+	}
+
+	moves[length] = m;
+	if (length >= 1 && !canonical_successor(face_of(moves[length - 1]), f)) {
+		// the opposite face goes after this one
+		std::swap(moves[length - 1], moves[length]);
+	}
+	++length;
+}
+
+/// The slice between a face and its opposite: M turns like L, E like D and S like F
+constexpr std::array<char, 3> slice_names{ 'E', 'M', 'S' };
+
+constexpr std::array<std::string_view, 4> power_suffixes{ "", "", "2", "'" };
+
+void append_turn(fmt::memory_buffer &output, const char name, const uint8_t power) {
+	if (output.size() > 0) output.push_back(' ');
+	output.push_back(name);
+	const auto suffix{ power_suffixes[power % 4] };
+	output.append(suffix.data(), suffix.data() + suffix.size());
+}
+
+void write_varint(size_t value, std::vector<uint8_t> &output) {
+	while (value >= 0x80) {
+		output.push_back(static_cast<uint8_t>(value | 0x80));
+		value >>= 7;
+	}
+	output.push_back(static_cast<uint8_t>(value));
+}
+
+/// @returns The number of bytes read, or 0 when there is no valid varint
+size_t read_varint(const uint8_t *data, const size_t size, size_t &value) noexcept {
+	value = 0;
+	for (size_t i{}; i < size && i < 10; ++i) {
+		value |= static_cast<size_t>(data[i] & 0x7F) << (7 * i);
+		if ((data[i] & 0x80) == 0) return i + 1;
+	}
+	return 0;
+}
+
+} // anonymous namespace
+
+void simplify(move_sequence &sequence) noexcept {
+	// the simplified prefix is never longer than the part already read, so it's built in place
+	size_t length{};
+	for (size_t i{}; i < sequence.size(); ++i) {
+		push_canonical(sequence.data(), length, sequence[i]);
+	}
+	sequence.resize(length);
+}
+
+void simplify(std::vector<move_sequence> &sequences) noexcept {
+	for (auto &sequence : sequences) {
+		simplify(sequence);
+	}
+}
+
+move_sequence simplified(move_sequence sequence) noexcept {
+	simplify(sequence);
+	return sequence;
+}
+
+bool is_canonical(const move_sequence &sequence) noexcept {
+	for (size_t i{ 1 }; i < sequence.size(); ++i) {
+		if (!canonical_successor(face_of(sequence[i - 1]), face_of(sequence[i]))) return false;
+	}
+	return true;
+}
+
+std::string slice_notation(const move_sequence &sequence) {
+	const auto moves{ simplified(sequence) };
+
+	// where[f] is the face which the center of `f` is on after the slice turns so far
+	std::array<face, face_count> where{ face::U, face::R, face::F, face::D, face::L, face::B };
+	fmt::memory_buffer output;
+	for (size_t i{}; i < moves.size(); ++i) {
+		const auto m{ moves[i] };
+		const auto power{ power_of(m) };
+		const auto current{ where[static_cast<size_t>(face_of(m))] };
+
+		const bool slice{ i + 1 < moves.size() && face_of(moves[i + 1]) == opposite(face_of(m))
+			&& power + power_of(moves[i + 1]) == 4 };
+		if (!slice) {
+			append_turn(output, face_names[static_cast<size_t>(current)], power);
+			continue;
+		}
+		++i;
+
+		// `X^p Y^-p` turns the slice between X and Y the same way as X and rotates the cube
+		// back; which one of them is X doesn't matter, so it's the one of U, R or F
+		const bool flipped{ current >= face::D };
+		const auto axis{ static_cast<size_t>(flipped ? opposite(current) : current) };
+		const auto turns{ static_cast<uint8_t>(flipped ? 4 - power : power) };
+		// the slice turns the other way than X: M and E follow L and D already, S follows F
+		append_turn(output, slice_names[axis], axis == static_cast<size_t>(face::F) ? 4 - turns : turns);
+
+		for (uint8_t k{}; k < 4 - turns; ++k) {
+			for (auto &f : where) {
+				f = rotated(f, static_cast<face>(axis));
+			}
+		}
+	}
+	return fmt::to_string(output);
+}
+
+void encode(const move_sequence &sequence, std::vector<uint8_t> &output) {
+	const auto moves{ simplified(sequence) };
+	write_varint(moves.size(), output);
+	if (moves.empty()) return;
+
+	output.push_back(static_cast<uint8_t>(moves.front()));
+	for (size_t i{ 1 }; i < moves.size(); i += 2) {
+		auto byte{ successors.indices[static_cast<size_t>(face_of(moves[i - 1]))][static_cast<size_t>(moves[i])] };
+		if (i + 1 < moves.size()) {
+			const auto next{ successors.indices[static_cast<size_t>(face_of(moves[i]))][static_cast<size_t>(moves[i + 1])] };
+			byte |= static_cast<uint8_t>(next << 4);
+		}
+		output.push_back(byte);
+	}
+}
+
+std::vector<uint8_t> encode(const std::vector<move_sequence> &sequences) {
+	std::vector<uint8_t> output;
+	for (const auto &sequence : sequences) {
+		encode(sequence, output);
+	}
+	return output;
+}
+
+size_t decode(const uint8_t *data, const size_t size, move_sequence &output) {
+	size_t length{};
+	const size_t header{ read_varint(data, size, length) };
+	if (header == 0) return 0;
+
+	output.clear();
+	if (length == 0) return header;
+
+	// the first move takes a byte and the rest of them two to a byte
+	const size_t bytes{ header + 1 + length / 2 };
+	if (bytes > size || data[header] >= move_count) return 0;
+
+	const auto *nibbles{ data + header + 1 };
+	output.reserve(length);
+	output.push_back(static_cast<move>(data[header]));
+	for (size_t i{}; i + 1 < length; ++i) {
+		const auto previous{ static_cast<size_t>(face_of(output.back())) };
+		const size_t index{ (nibbles[i / 2] >> (4 * (i % 2))) & 0xFu };
+		if (index >= successors.counts[previous]) return 0;
+		output.push_back(successors.moves[previous][index]);
+	}
+	return bytes;
+}
+
+bool decode(const std::vector<uint8_t> &bytecode, std::vector<move_sequence> &output) {
+	size_t offset{};
+	while (offset < bytecode.size()) {
+		auto &sequence{ output.emplace_back() };
+		const auto read{ decode(bytecode.data() + offset, bytecode.size() - offset, sequence) };
+		if (read == 0) {
+			output.pop_back();
+			return false;
+		}
+		offset += read;
+	}
+	return true;
+}
+
+} // namespace gzn::game::magicube
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cinttypes>
+
+#include "game/magicube/cube/move.hpp"
+
+namespace gzn::game::magicube {
+
+/// @brief Merges and cancels the turns of the same face, also across a turn of the opposite face
+/// (`R L R'` is `L`), and puts the commuting opposite faces into the canonical order, see
+/// `canonical_successor()`. The result does the same to the cube and is never longer.
+void simplify(move_sequence &sequence) noexcept;
+void simplify(std::vector<move_sequence> &sequences) noexcept;
+
+[[nodiscard]] move_sequence simplified(move_sequence sequence) noexcept;
+[[nodiscard]] bool is_canonical(const move_sequence &sequence) noexcept;
+
+/// @brief Writes @p sequence with slice turns in place of the opposite face turns going the
+/// same way (`R L'` is `M` and the rest of the moves are relabelled). It takes fewer turns in
+/// the slice turn metric, but the cube ends up rotated unless the slices cancel out.
+[[nodiscard]] std::string slice_notation(const move_sequence &sequence);
+
+//============================================ BYTECODE ============================================//
+
+// A canonical sequence is written as its length (LEB128), its first move in one byte and every
+// next move as a nibble: its index among the canonical successors of the previous move, of which
+// there are 15 at most. That's 4 bits per move instead of 8.
+
+/// @brief Appends the bytecode of @p sequence to @p output; the sequence is simplified first
+void encode(const move_sequence &sequence, std::vector<uint8_t> &output);
+[[nodiscard]] std::vector<uint8_t> encode(const std::vector<move_sequence> &sequences);
+
+/// @returns The number of bytes read, or 0 when the bytecode is broken
+[[nodiscard]] size_t decode(const uint8_t *data, const size_t size, move_sequence &output);
+/// @returns false when the bytecode is broken
+[[nodiscard]] bool decode(const std::vector<uint8_t> &bytecode, std::vector<move_sequence> &output);
+
+} // namespace gzn::game::magicube
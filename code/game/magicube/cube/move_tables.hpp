@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <cinttypes>
+
+#include "game/magicube/cube/move.hpp"
+#include "game/magicube/cube/cubie.hpp"
+
+/// @brief The move tables of the packed cubie fields. They're computed by the compiler and
+/// stored in the read-only data, so the lookups of a known move can be folded into constants.
+namespace gzn::game::magicube::tables {
+
+constexpr uint32_t field_bits{ 5 };
+constexpr size_t field_count{ 1u << field_bits };
+using field_table = std::array<uint8_t, field_count>;
+
+struct field_tables {
+	std::array<field_table, move_count> corners{};
+	std::array<field_table, move_count> edges{};
+};
+
+[[nodiscard]] constexpr uint8_t corner_field(const size_t position, const size_t twist) noexcept {
+	return static_cast<uint8_t>((twist << 3) | position);
+}
+
+[[nodiscard]] constexpr uint8_t edge_field(const size_t position, const size_t flip) noexcept {
+	return static_cast<uint8_t>((flip << 4) | position);
+}
+
+/// @brief Fills the tables with where the fields go under @p turn, any sequence of moves
+/// applied to the solved cube
+constexpr void make_fields(const cubie_cube &turn, field_table &corners, field_table &edges) noexcept {
+	// cubie_cube tells which cubie replaced the one on each position; the fields need the
+	// opposite direction: where the cubie from the given position goes
+	for (size_t to{}; to < corner_count; ++to) {
+		const size_t from{ turn.cp[to] };
+		for (size_t twist{}; twist < 3; ++twist) {
+			corners[corner_field(from, twist)] = corner_field(to, (twist + turn.co[to]) % 3);
+		}
+	}
+	for (size_t to{}; to < edge_count; ++to) {
+		const size_t from{ turn.ep[to] };
+		for (size_t flip{}; flip < 2; ++flip) {
+			edges[edge_field(from, flip)] = edge_field(to, (flip + turn.eo[to]) % 2);
+		}
+	}
+}
+
+[[nodiscard]] constexpr field_tables make_field_tables() noexcept {
+	field_tables tables{};
+	for (size_t m{}; m < move_count; ++m) {
+		make_fields(apply(cubie_cube{}, static_cast<move>(m)), tables.corners[m], tables.edges[m]);
+	}
+	return tables;
+}
+
+inline constexpr field_tables field_moves{ make_field_tables() };
+
+/// @brief Checks that the tables are an action of the face turn group on the fields: every
+/// quarter turn is a bijection of the order 4 whose square and cube are the half and the
+/// counterclockwise turns, and the opposite faces commute
+[[nodiscard]] constexpr bool is_group_action(const field_tables &tables) noexcept {
+	const auto check{ [](const std::array<field_table, move_count> &moves, const size_t count,
+		const size_t position_bits, const size_t orientations) {
+		for (size_t f{}; f < face_count; ++f) {
+			const auto &quarter{ moves[f * 3] };
+			const auto &half{ moves[f * 3 + 1] };
+			const auto &counter{ moves[f * 3 + 2] };
+			const auto &opposite_quarter{ moves[((f + 3) % face_count) * 3] };
+
+			std::array<bool, field_count> hit{};
+			for (size_t position{}; position < count; ++position) {
+				for (size_t orientation{}; orientation < orientations; ++orientation) {
+					const auto field{ (orientation << position_bits) | position };
+					const size_t once{ quarter[field] };
+					if ((once & ((1u << position_bits) - 1)) >= count || (once >> position_bits) >= orientations) {
+						return false;
+					}
+					if (hit[once]) return false;
+					hit[once] = true;
+
+					const auto twice{ quarter[once] };
+					const auto thrice{ quarter[twice] };
+					if (twice != half[field] || thrice != counter[field] || quarter[thrice] != field) return false;
+					if (opposite_quarter[once] != quarter[opposite_quarter[field]]) return false;
+				}
+			}
+		}
+		return true;
+	} };
+	return check(tables.corners, corner_count, 3, 3) && check(tables.edges, edge_count, 4, 2);
+}
+
+} // namespace gzn::game::magicube::tables
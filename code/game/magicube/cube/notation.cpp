@@ -0,0 +1,287 @@
+#include <algorithm>
+#include <array>
+
+#include "game/magicube/cube/notation.hpp"
+
+namespace gzn::game::magicube {
+
+namespace {
+
+constexpr uint32_t max_layers{ 255 };
+
+enum class symbol_class : uint8_t { none, separator, digit, face, wide_face, slice, rotation };
+
+struct symbol {
+	symbol_class type{ symbol_class::none };
+	face direction{ face::U };
+};
+
+constexpr std::array<symbol, 256> make_symbols() noexcept {
+	std::array<symbol, 256> symbols{};
+	for (const char c : { ' ', '\t', '\r', '\n' }) {
+		symbols[static_cast<uint8_t>(c)] = { symbol_class::separator, face::U };
+	}
+	for (char c{ '0' }; c <= '9'; ++c) {
+		symbols[static_cast<uint8_t>(c)] = { symbol_class::digit, face::U };
+	}
+
+	constexpr std::string_view faces{ "URFDLB" };
+	constexpr std::string_view wide_faces{ "urfdlb" };
+	for (size_t f{}; f < face_count; ++f) {
+		symbols[static_cast<uint8_t>(faces[f])] = { symbol_class::face, static_cast<face>(f) };
+		symbols[static_cast<uint8_t>(wide_faces[f])] = { symbol_class::wide_face, static_cast<face>(f) };
+	}
+	symbols['M'] = { symbol_class::slice, face::L };
+	symbols['E'] = { symbol_class::slice, face::D };
+	symbols['S'] = { symbol_class::slice, face::F };
+	symbols['x'] = { symbol_class::rotation, face::R };
+	symbols['y'] = { symbol_class::rotation, face::U };
+	symbols['z'] = { symbol_class::rotation, face::F };
+	return symbols;
+}
+
+constexpr auto symbols{ make_symbols() };
+
+[[nodiscard]] constexpr symbol_class symbol_at(const char c) noexcept {
+	return symbols[static_cast<uint8_t>(c)].type;
+}
+
+struct power_suffix {
+	uint8_t power{ 1 };
+	uint8_t length{};
+};
+
+constexpr std::array<power_suffix, 256> make_powers() noexcept {
+	std::array<power_suffix, 256> powers{};
+	powers['2'] = { 2, 1 };
+	powers['\''] = { 3, 1 };
+	return powers;
+}
+
+constexpr auto powers{ make_powers() };
+
+constexpr std::string_view face_letters{ "URFDLB" };
+/// Slices and rotations by the face they follow; the ones going the other way are inverted
+constexpr std::string_view slice_letters{ "EMSEMS" };
+constexpr std::string_view rotation_letters{ "yxzyxz" };
+
+/// Faces a slice or a rotation is written with, going the same way as its letter
+[[nodiscard]] constexpr bool written_directly(const turn &t) noexcept {
+	if (t.kind == turn_kind::slice) {
+		return t.direction == face::D || t.direction == face::L || t.direction == face::F;
+	}
+	return t.direction == face::U || t.direction == face::R || t.direction == face::F;
+}
+
+size_t write_number(uint32_t value, char *output) noexcept {
+	char digits[3]{};
+	size_t count{};
+	do {
+		digits[count++] = static_cast<char>('0' + value % 10);
+		value /= 10;
+	} while (value != 0 && count < 3);
+	for (size_t i{}; i < count; ++i) {
+		output[i] = digits[count - 1 - i];
+	}
+	return count;
+}
+
+/// @brief Writes the items separated by spaces with @p write, which takes up to
+/// `max_turn_length - 1` characters for each of them
+template<class T, class Write>
+size_t write_separated(const T *items, const size_t count, char *buffer, const size_t size, Write &&write) noexcept {
+	size_t length{};
+	for (size_t i{}; i < count; ++i) {
+		if (length + max_turn_length <= size) {
+			if (i > 0) buffer[length++] = ' ';
+			length += write(items[i], buffer + length);
+			continue;
+		}
+		// near the end of the buffer only what fits is copied
+		char text[max_turn_length]{ ' ' };
+		const auto written{ write(items[i], text + 1) + 1 };
+		for (size_t k{ i > 0 ? 0u : 1u }; k < written; ++k, ++length) {
+			if (length < size) buffer[length] = text[k];
+		}
+	}
+	return length;
+}
+
+} // anonymous namespace
+
+notation_result parse_notation(const std::string_view text, turn *output, const size_t capacity) noexcept {
+	notation_result result;
+	const auto fail{ [&result](const size_t position, const std::string_view error) {
+		result.position = position;
+		result.error = error;
+		return result;
+	} };
+
+	const size_t size{ text.size() };
+	// the end of the text reads as a separator
+	const auto at{ [text, size](const size_t i) noexcept { return i < size ? text[i] : ' '; } };
+	size_t i{};
+	while (i < size) {
+		auto current{ symbols[static_cast<uint8_t>(text[i])] };
+		if (current.type == symbol_class::separator) {
+			++i;
+			continue;
+		}
+
+		const size_t start{ i };
+		uint32_t layers{};
+		if (current.type == symbol_class::digit) {
+			for (; i < size && symbol_at(text[i]) == symbol_class::digit; ++i) {
+				layers = layers * 10 + static_cast<uint32_t>(text[i] - '0');
+				if (layers > max_layers) return fail(start, "too many layers");
+			}
+			if (layers == 0) return fail(start, "layers are counted from 1");
+			if (i == size || symbol_at(text[i]) != symbol_class::face) {
+				return fail(i, "expected a face after the layer count");
+			}
+			current = symbols[static_cast<uint8_t>(text[i])];
+		}
+
+		turn t{};
+		t.direction = current.direction;
+		switch (current.type) {
+			case symbol_class::face:
+				if (++i < size && text[i] == 'w') {
+					++i;
+					// "1Rw" is just R
+					t.kind = layers == 1 ? turn_kind::face : turn_kind::wide;
+					t.layers = static_cast<uint8_t>(layers == 0 ? 2 : layers);
+				} else {
+					t.layers = static_cast<uint8_t>(layers == 0 ? 1 : layers);
+				}
+				break;
+			case symbol_class::wide_face:
+				++i;
+				t.kind = turn_kind::wide;
+				t.layers = 2;
+				break;
+			case symbol_class::slice:
+				++i;
+				t.kind = turn_kind::slice;
+				break;
+			case symbol_class::rotation:
+				++i;
+				t.kind = turn_kind::rotation;
+				break;
+			default:
+				return fail(i, "unexpected character");
+		}
+
+		// looked up rather than branched on, the powers of a scramble are random
+		const auto power{ powers[static_cast<uint8_t>(at(i))] };
+		t.power = power.power;
+		i += power.length;
+		// "2'" is the same half turn
+		i += static_cast<size_t>(power.power == 2) & static_cast<size_t>(at(i) == '\'');
+		if (symbol_at(at(i)) != symbol_class::separator) {
+			return fail(i, "expected whitespace after the turn");
+		}
+
+		if (result.count == capacity) return fail(start, "too many turns");
+		output[result.count++] = t;
+	}
+	result.position = size;
+	return result;
+}
+
+std::optional<cube_orientation> to_moves(const turn *turns, const size_t count, move_sequence &output) {
+	// the centres after the rotations so far
+	cube_orientation orientation;
+	auto &centre_at{ orientation.centres };
+	const auto emit{ [&centre_at, &output](const face position, const uint8_t power) {
+		output.push_back(make_move(centre_at[static_cast<size_t>(position)], power));
+	} };
+	const auto rotate{ [&centre_at](const face direction, const uint8_t power) {
+		for (uint8_t k{}; k < power; ++k) {
+			auto next{ centre_at };
+			for (size_t position{}; position < face_count; ++position) {
+				next[static_cast<size_t>(rotated(static_cast<face>(position), direction))] = centre_at[position];
+			}
+			centre_at = next;
+		}
+	} };
+	// the middle layer is its faces turning the other way and the whole cube turning this way
+	const auto middle{ [&emit, &rotate](const face direction, const uint8_t power) {
+		emit(direction, static_cast<uint8_t>(4 - power));
+		emit(opposite(direction), power);
+		rotate(direction, power);
+	} };
+
+	for (size_t i{}; i < count; ++i) {
+		const auto &t{ turns[i] };
+		switch (t.kind) {
+			case turn_kind::face:
+				if (t.layers == 1) emit(t.direction, t.power);
+				else if (t.layers == 2) middle(t.direction, t.power);
+				else if (t.layers == 3) emit(opposite(t.direction), static_cast<uint8_t>(4 - t.power));
+				else return std::nullopt;
+				break;
+			case turn_kind::wide:
+				if (t.layers == 1) {
+					emit(t.direction, t.power);
+				} else if (t.layers == 2) {
+					emit(opposite(t.direction), t.power);
+					rotate(t.direction, t.power);
+				} else if (t.layers == 3) {
+					rotate(t.direction, t.power);
+				} else {
+					return std::nullopt;
+				}
+				break;
+			case turn_kind::slice:
+				middle(t.direction, t.power);
+				break;
+			case turn_kind::rotation:
+				rotate(t.direction, t.power);
+				break;
+		}
+	}
+	return orientation;
+}
+
+size_t write_turn(const turn &t, char *output) noexcept {
+	constexpr std::array<std::string_view, 4> suffixes{ "", "", "2", "'" };
+
+	size_t length{};
+	auto power{ t.power };
+	const auto direction{ static_cast<size_t>(t.direction) };
+	switch (t.kind) {
+		case turn_kind::face:
+		case turn_kind::wide:
+			if (t.layers > (t.kind == turn_kind::wide ? 2 : 1)) {
+				length += write_number(t.layers, output);
+			}
+			output[length++] = face_letters[direction];
+			if (t.kind == turn_kind::wide) output[length++] = 'w';
+			break;
+		case turn_kind::slice:
+		case turn_kind::rotation:
+			output[length++] = (t.kind == turn_kind::slice ? slice_letters : rotation_letters)[direction];
+			if (!written_directly(t)) power = static_cast<uint8_t>(4 - power);
+			break;
+	}
+	const auto suffix{ suffixes[power % 4] };
+	for (const char c : suffix) {
+		output[length++] = c;
+	}
+	return length;
+}
+
+size_t format_notation(const turn *turns, const size_t count, char *buffer, const size_t size) noexcept {
+	return write_separated(turns, count, buffer, size, write_turn);
+}
+
+size_t format_notation(const move *moves, const size_t count, char *buffer, const size_t size) noexcept {
+	return write_separated(moves, count, buffer, size, [](const move m, char *output) noexcept {
+		const auto name{ to_string(m) };
+		std::copy(name.begin(), name.end(), output);
+		return name.size();
+	});
+}
+
+} // namespace gzn::game::magicube
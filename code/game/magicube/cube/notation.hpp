@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <optional>
+#include <algorithm>
+#include <cinttypes>
+#include <string_view>
+
+#include <fmt/format.h>
+
+#include "game/magicube/cube/move.hpp"
+
+namespace gzn::game::magicube {
+
+enum class turn_kind : uint8_t {
+	face,     ///< `R`, and `3R` for the third layer only
+	wide,     ///< `Rw`, `r` and `3Rw` for the three outer layers
+	slice,    ///< `M`, `E` and `S`
+	rotation, ///< `x`, `y` and `z`
+};
+
+/// @brief A turn of the WCA notation for a cube of any size, 4 bytes
+struct turn {
+	turn_kind kind{ turn_kind::face };
+	/// The face turning the same way: M follows L, E follows D, S follows F, and x, y and z
+	/// follow R, U and F
+	face direction{ face::U };
+	/// Clockwise quarter turns: 1, 2 or 3
+	uint8_t power{ 1 };
+	/// The layer of a face turn or the number of the layers of a wide turn, counted from the face
+	uint8_t layers{ 1 };
+
+	[[nodiscard]] constexpr bool operator==(const turn &other) const noexcept {
+		return kind == other.kind && direction == other.direction && power == other.power && layers == other.layers;
+	}
+	[[nodiscard]] constexpr bool operator!=(const turn &other) const noexcept { return !(*this == other); }
+};
+
+/// `255Rw2` and a space
+constexpr size_t max_turn_length{ 8 };
+
+struct notation_result {
+	/// The number of the turns written to the output
+	size_t count{};
+	/// Where the parsing stopped: the end of the text or the beginning of the error
+	size_t position{};
+	/// Empty when the whole text is parsed
+	std::string_view error;
+
+	[[nodiscard]] explicit operator bool() const noexcept { return error.empty(); }
+};
+
+/// @brief Parses the turns separated by whitespace into @p output without allocating. Stops at
+/// the first error or when @p capacity turns are written.
+[[nodiscard]] notation_result parse_notation(const std::string_view text, turn *output, const size_t capacity) noexcept;
+
+/// @brief How the cube is held after the rotations of a sequence
+struct cube_orientation {
+	/// The face whose centre is on every position, as held at the start
+	std::array<face, face_count> centres{ face::U, face::R, face::F, face::D, face::L, face::B };
+
+	/// @brief The move of the cube as held doing what @p m does to the cube held as at the start
+	[[nodiscard]] constexpr move held(const move m) const noexcept {
+		size_t position{};
+		while (position + 1 < face_count && centres[position] != face_of(m)) ++position;
+		return make_move(static_cast<face>(position), power_of(m));
+	}
+};
+
+/// @brief The moves of a 3x3 with fixed centres doing the same as @p turns: the wide turns,
+/// slices and rotations relabel the faces of the moves after them
+/// @returns How the cube is held after the turns, nothing if one of the turns doesn't exist on
+/// a 3x3. A solution of the moves is turned as held with `cube_orientation::held`.
+[[nodiscard]] std::optional<cube_orientation> to_moves(const turn *turns, const size_t count, move_sequence &output);
+
+[[nodiscard]] constexpr turn to_turn(const move m) noexcept {
+	return turn{ turn_kind::face, face_of(m), power_of(m), 1 };
+}
+
+/// @brief Writes @p t into @p output, which has room for `max_turn_length` characters
+/// @returns The number of characters written
+size_t write_turn(const turn &t, char *output) noexcept;
+
+/// @brief Writes the turns separated by spaces into the @p size characters at @p buffer; the
+/// text is cut when the buffer is too small
+/// @returns The length of the whole text
+size_t format_notation(const turn *turns, const size_t count, char *buffer, const size_t size) noexcept;
+size_t format_notation(const move *moves, const size_t count, char *buffer, const size_t size) noexcept;
+
+} // namespace gzn::game::magicube
+
+template<>
+struct fmt::formatter<gzn::game::magicube::turn> {
+	constexpr auto parse(fmt::format_parse_context &context) { return context.begin(); }
+
+	template<class Context>
+	auto format(const gzn::game::magicube::turn &t, Context &context) const {
+		char text[gzn::game::magicube::max_turn_length];
+		return std::copy_n(text, gzn::game::magicube::write_turn(t, text), context.out());
+	}
+};
+
+template<>
+struct fmt::formatter<gzn::game::magicube::move> {
+	constexpr auto parse(fmt::format_parse_context &context) { return context.begin(); }
+
+	template<class Context>
+	auto format(const gzn::game::magicube::move m, Context &context) const {
+		const auto text{ gzn::game::magicube::to_string(m) };
+		return std::copy(text.begin(), text.end(), context.out());
+	}
+};
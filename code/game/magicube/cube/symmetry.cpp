@@ -0,0 +1,316 @@
+#include <array>
+
+#include "game/magicube/cube/symmetry.hpp"
+
+namespace gzn::game::magicube {
+
+namespace {
+
+using tables::corner_field;
+using tables::edge_field;
+
+using vector3 = std::array<int8_t, 3>;
+
+/// Signed permutation matrix: `(M v)[i] = signs[i] * v[axes[i]]`
+struct symmetry_matrix {
+	std::array<uint8_t, 3> axes{};
+	std::array<int8_t, 3> signs{};
+
+	[[nodiscard]] constexpr vector3 operator*(const vector3 &v) const noexcept {
+		return { static_cast<int8_t>(signs[0] * v[axes[0]]), static_cast<int8_t>(signs[1] * v[axes[1]]),
+			static_cast<int8_t>(signs[2] * v[axes[2]]) };
+	}
+
+	[[nodiscard]] constexpr bool reflection() const noexcept {
+		const bool odd{ ((axes[0] > axes[1]) != (axes[0] > axes[2])) != (axes[1] > axes[2]) };
+		return odd != (signs[0] * signs[1] * signs[2] < 0);
+	}
+};
+
+// x points to R, y to U and z to F
+constexpr std::array<vector3, face_count> face_normals{ {
+	{ 0, 1, 0 }, { 1, 0, 0 }, { 0, 0, 1 }, { 0, -1, 0 }, { -1, 0, 0 }, { 0, 0, -1 },
+} };
+
+/// The faces of each corner slot clockwise, the U or D one first. The twist of a cubie is the
+/// slot holding its U or D sticker.
+constexpr std::array<std::array<face, 3>, corner_count> corner_slots{ {
+	{ face::U, face::R, face::F }, { face::U, face::F, face::L },
+	{ face::U, face::L, face::B }, { face::U, face::B, face::R },
+	{ face::D, face::F, face::R }, { face::D, face::L, face::F },
+	{ face::D, face::B, face::L }, { face::D, face::R, face::B },
+} };
+
+constexpr std::array<std::array<face, 2>, edge_count> edge_slots{ {
+	{ face::U, face::R }, { face::U, face::F }, { face::U, face::L }, { face::U, face::B },
+	{ face::D, face::R }, { face::D, face::F }, { face::D, face::L }, { face::D, face::B },
+	{ face::F, face::R }, { face::F, face::L }, { face::B, face::L }, { face::B, face::R },
+} };
+
+struct symmetry_tables {
+	/// The cubie `i` of a conjugate comes from the cubie `corner_sources[s][i]` of the original,
+	/// and corners[s][i] maps the field of the latter onto the field of the former
+	std::array<std::array<cube_state::field_table, corner_count>, symmetry_count> corners{};
+	std::array<std::array<cube_state::field_table, edge_count>, symmetry_count> edges{};
+	std::array<std::array<uint8_t, corner_count>, symmetry_count> corner_sources{};
+	std::array<std::array<uint8_t, edge_count>, symmetry_count> edge_sources{};
+
+	std::array<std::array<move, move_count>, symmetry_count> moves{};
+	std::array<symmetry, symmetry_count> inverses{};
+	std::array<bool, symmetry_count> reflections{};
+};
+
+constexpr bool operator==(const vector3 &lhs, const vector3 &rhs) noexcept {
+	return lhs[0] == rhs[0] && lhs[1] == rhs[1] && lhs[2] == rhs[2];
+}
+
+constexpr face face_image(const symmetry_matrix &matrix, const face f) noexcept {
+	const auto image{ matrix * face_normals[static_cast<size_t>(f)] };
+	size_t result{};
+	while (!(face_normals[result] == image)) ++result;
+	return static_cast<face>(result);
+}
+
+struct slot_position {
+	size_t target{};
+	/// The slot of the target which the first slot of the source lands on
+	size_t shift{};
+};
+
+template<size_t Slots>
+constexpr size_t find_slot(const std::array<face, Slots> &slots, const face f) noexcept {
+	size_t slot{};
+	while (slot < Slots && slots[slot] != f) ++slot;
+	return slot;
+}
+
+/// @brief Where the cubie position @p position goes
+template<size_t Count, size_t Slots>
+constexpr slot_position slot_image(const symmetry_matrix &matrix,
+	const std::array<std::array<face, Slots>, Count> &slots, const size_t position) noexcept {
+	std::array<face, Slots> images{};
+	for (size_t i{}; i < Slots; ++i) {
+		images[i] = face_image(matrix, slots[position][i]);
+	}
+	for (size_t target{}; target < Count; ++target) {
+		bool same{ true };
+		for (const auto image : images) {
+			same = same && find_slot(slots[target], image) < Slots;
+		}
+		if (same) {
+			return { target, find_slot(slots[target], images[0]) };
+		}
+	}
+	return {};
+}
+
+constexpr std::array<symmetry_matrix, symmetry_count> make_matrices() noexcept {
+	constexpr std::array<std::array<uint8_t, 3>, 6> permutations{ {
+		{ 0, 1, 2 }, { 0, 2, 1 }, { 1, 0, 2 }, { 1, 2, 0 }, { 2, 0, 1 }, { 2, 1, 0 },
+	} };
+	std::array<symmetry_matrix, symmetry_count> matrices{};
+	size_t index{};
+	for (const auto &axes : permutations) {
+		for (uint8_t signs{}; signs < 8; ++signs) {
+			auto &matrix{ matrices[index++] };
+			matrix.axes = axes;
+			for (size_t i{}; i < 3; ++i) {
+				matrix.signs[i] = (signs >> i) & 1 ? -1 : 1;
+			}
+		}
+	}
+	return matrices;
+}
+
+constexpr symmetry_tables make_symmetry_tables() noexcept {
+	symmetry_tables tables{};
+	const auto matrices{ make_matrices() };
+
+	for (size_t s{}; s < symmetry_count; ++s) {
+		const auto &matrix{ matrices[s] };
+		const bool reflection{ matrix.reflection() };
+		tables.reflections[s] = reflection;
+
+		// the cubie `piece` on the position `position` with the `twist` is seen as the cubie
+		// at the image of its home on the image of the position; the twist follows the slots
+		std::array<slot_position, corner_count> corners{};
+		for (size_t i{}; i < corner_count; ++i) {
+			corners[i] = slot_image(matrix, corner_slots, i);
+		}
+		for (size_t piece{}; piece < corner_count; ++piece) {
+			const auto piece_image{ corners[piece] };
+			tables.corner_sources[s][piece_image.target] = static_cast<uint8_t>(piece);
+			for (size_t position{}; position < corner_count; ++position) {
+				const auto image{ corners[position] };
+				for (size_t twist{}; twist < 3; ++twist) {
+					const auto conjugated{ reflection
+						? (image.shift + 6 - piece_image.shift - twist) % 3
+						: (image.shift + 3 - piece_image.shift + twist) % 3 };
+					tables.corners[s][piece_image.target][corner_field(position, twist)] =
+						corner_field(image.target, conjugated);
+				}
+			}
+		}
+
+		std::array<slot_position, edge_count> edges{};
+		for (size_t i{}; i < edge_count; ++i) {
+			edges[i] = slot_image(matrix, edge_slots, i);
+		}
+		for (size_t piece{}; piece < edge_count; ++piece) {
+			const auto piece_image{ edges[piece] };
+			tables.edge_sources[s][piece_image.target] = static_cast<uint8_t>(piece);
+			for (size_t position{}; position < edge_count; ++position) {
+				const auto image{ edges[position] };
+				for (size_t flip{}; flip < 2; ++flip) {
+					const auto conjugated{ (image.shift + piece_image.shift + flip) % 2 };
+					tables.edges[s][piece_image.target][edge_field(position, flip)] =
+						edge_field(image.target, conjugated);
+				}
+			}
+		}
+
+		// a mirror turns the clockwise turns into the counterclockwise ones
+		for (size_t m{}; m < move_count; ++m) {
+			const auto original{ static_cast<move>(m) };
+			const auto power{ power_of(original) };
+			tables.moves[s][m] = make_move(face_image(matrix, face_of(original)),
+				static_cast<uint8_t>(reflection ? 4 - power : power));
+		}
+
+		for (size_t other{}; other < symmetry_count; ++other) {
+			bool identity{ true };
+			for (const auto &normal : face_normals) {
+				identity = identity && matrices[other] * (matrix * normal) == normal;
+			}
+			if (identity) {
+				tables.inverses[s] = static_cast<symmetry>(other);
+			}
+		}
+	}
+	return tables;
+}
+
+constexpr symmetry_tables symmetry_conjugation_tables{ make_symmetry_tables() };
+
+/// @brief Checks that the symmetries act on the moves as a group with 0 as the identity, and
+/// that conjugating a field commutes with every quarter turn (the other turns follow):
+/// `conjugate(state.moved(m), s) == conjugate(state, s).moved(conjugate(m, s))`
+constexpr bool is_conjugation(const symmetry_tables &symmetries, const tables::field_tables &moves) noexcept {
+	const auto commutes{ [](const auto &conjugations, const std::array<cube_state::field_table, move_count> &turns,
+		const move m, const move conjugated, const size_t count, const size_t position_bits, const size_t orientations) {
+		for (size_t target{}; target < count; ++target) {
+			for (size_t position{}; position < count; ++position) {
+				for (size_t orientation{}; orientation < orientations; ++orientation) {
+					const auto field{ (orientation << position_bits) | position };
+					const auto &conjugation{ conjugations[target] };
+					if (conjugation[turns[static_cast<size_t>(m)][field]] !=
+						turns[static_cast<size_t>(conjugated)][conjugation[field]]) return false;
+				}
+			}
+		}
+		return true;
+	} };
+
+	for (size_t m{}; m < move_count; ++m) {
+		if (symmetries.moves[0][m] != static_cast<move>(m)) return false;
+	}
+	for (size_t s{}; s < symmetry_count; ++s) {
+		const auto &back{ symmetries.moves[symmetries.inverses[s]] };
+		for (size_t m{}; m < move_count; ++m) {
+			if (back[static_cast<size_t>(symmetries.moves[s][m])] != static_cast<move>(m)) return false;
+		}
+		for (size_t f{}; f < face_count; ++f) {
+			const auto m{ make_move(static_cast<face>(f), 1) };
+			const auto conjugated{ symmetries.moves[s][static_cast<size_t>(m)] };
+			if (!commutes(symmetries.corners[s], moves.corners, m, conjugated, corner_count, 3, 3)) return false;
+			if (!commutes(symmetries.edges[s], moves.edges, m, conjugated, edge_count, 4, 2)) return false;
+		}
+	}
+	return true;
+}
+
+static_assert(is_conjugation(symmetry_conjugation_tables, tables::field_moves),
+	"The symmetry tables don't commute with the move tables");
+
+template<size_t Count>
+uint64_t conjugate_fields(const uint64_t word, const std::array<cube_state::field_table, Count> &tables,
+	const std::array<uint8_t, Count> &sources) noexcept {
+	uint64_t result{};
+	for (size_t i{}; i < Count; ++i) {
+		const auto field{ (word >> (sources[i] * cube_state::field_bits)) & cube_state::field_mask };
+		result |= uint64_t{ tables[i][field] } << (i * cube_state::field_bits);
+	}
+	return result;
+}
+
+/// @brief Conjugates the fields starting from the most significant one and gives up as soon
+/// as the result is known to be greater than @p bound
+/// @returns false when the conjugate is greater than @p bound
+template<size_t Count>
+bool conjugate_fields_up_to(const uint64_t word, const std::array<cube_state::field_table, Count> &tables,
+	const std::array<uint8_t, Count> &sources, const uint64_t bound, uint64_t &result) noexcept {
+	result = 0;
+	bool less{ false };
+	for (size_t i{ Count }; i-- > 0;) {
+		const auto shift{ i * cube_state::field_bits };
+		const uint64_t field{ tables[i][(word >> (sources[i] * cube_state::field_bits)) & cube_state::field_mask] };
+		if (!less) {
+			const auto bound_field{ (bound >> shift) & cube_state::field_mask };
+			if (field > bound_field) return false;
+			less = field < bound_field;
+		}
+		result |= field << shift;
+	}
+	return true;
+}
+
+} // anonymous namespace
+
+cube_state conjugate(const cube_state &state, const symmetry s) noexcept {
+	const auto &tables{ symmetry_conjugation_tables };
+	return cube_state::from_fields(conjugate_fields(state.corners(), tables.corners[s], tables.corner_sources[s]),
+		conjugate_fields(state.edges(), tables.edges[s], tables.edge_sources[s]));
+}
+
+move conjugate(const move m, const symmetry s) noexcept {
+	return symmetry_conjugation_tables.moves[s][static_cast<size_t>(m)];
+}
+
+symmetry inverse_symmetry(const symmetry s) noexcept {
+	return symmetry_conjugation_tables.inverses[s];
+}
+
+bool is_reflection(const symmetry s) noexcept {
+	return symmetry_conjugation_tables.reflections[s];
+}
+
+canonical_state canonical(const cube_state &state, const bool with_inverse) noexcept {
+	canonical_state best{ state, 0, false };
+
+	const auto search{ [&best](const cube_state &candidate, const bool inverted) {
+		const auto &tables{ symmetry_conjugation_tables };
+		for (symmetry s{}; s < symmetry_count; ++s) {
+			// most of the symmetries are rejected by the first corner or two
+			uint64_t corners{};
+			if (!conjugate_fields_up_to(candidate.corners(), tables.corners[s], tables.corner_sources[s],
+				best.state.corners(), corners)) continue;
+
+			// the edges only have to be at least as small when the corners are equal
+			const auto edge_bound{ corners < best.state.corners() ? ~uint64_t{} : best.state.edges() };
+			uint64_t edges{};
+			if (!conjugate_fields_up_to(candidate.edges(), tables.edges[s], tables.edge_sources[s], edge_bound, edges)) continue;
+
+			if (corners < best.state.corners() || edges < best.state.edges()) {
+				best = { cube_state::from_fields(corners, edges), s, inverted };
+			}
+		}
+	} };
+
+	search(state, false);
+	if (with_inverse) {
+		search(inverse(state), true);
+	}
+	return best;
+}
+
+} // namespace gzn::game::magicube
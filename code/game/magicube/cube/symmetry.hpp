@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cinttypes>
+
+#include "game/magicube/cube/cube_state.hpp"
+
+namespace gzn::game::magicube {
+
+/// 24 rotations of the whole cube and their mirror images
+constexpr size_t symmetry_count{ 48 };
+
+/// @brief Index of a symmetry, 0 is the identity
+using symmetry = uint8_t;
+
+/// @brief The state seen through the symmetry @p s: the cube is rotated or mirrored, and the
+/// stickers are recoloured to match the centers again. Conjugation commutes with the moves:
+/// `conjugate(state.moved(m), s) == conjugate(state, s).moved(conjugate(m, s))`.
+[[nodiscard]] cube_state conjugate(const cube_state &state, const symmetry s) noexcept;
+
+/// @brief The move which does to a conjugated state what @p m does to the original one
+[[nodiscard]] move conjugate(const move m, const symmetry s) noexcept;
+
+[[nodiscard]] symmetry inverse_symmetry(const symmetry s) noexcept;
+[[nodiscard]] bool is_reflection(const symmetry s) noexcept;
+
+struct canonical_state {
+	cube_state state;
+	/// `state == conjugate(original or its inverse, applied)`
+	symmetry applied{};
+	bool inverted{ false };
+};
+
+/// @brief The least of the conjugates of @p state, and of its inverse if @p with_inverse is set.
+/// Every state of an equivalence class has the same canonical state, so the tables keyed by it
+/// need up to 48 (or 96) times fewer entries. The solution of the original is found by
+/// conjugating the moves back, and by reversing and inverting them when `inverted` is set.
+[[nodiscard]] canonical_state canonical(const cube_state &state, const bool with_inverse = false) noexcept;
+
+} // namespace gzn::game::magicube
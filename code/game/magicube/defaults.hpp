@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cinttypes>
+#include <string_view>
+
+namespace gzn::game::magicube::defaults {
+
+namespace solver {
+
+	constexpr std::string_view two_phase_tables_path{ "assets/two_phase.tables" };
+	/// The in-game solver keeps looking for shorter solutions in the background this long
+	constexpr uint8_t background_target_length{ 17 };
+	constexpr std::chrono::milliseconds background_timeout{ 5000 };
+
+	constexpr std::string_view pattern_databases_path{ "assets/pdb" };
+	constexpr size_t transposition_table_mib{ 256 };
+
+	constexpr std::string_view pocket_table_path{ "assets/pocket.table" };
+
+} // namespace solver
+
+namespace scramble {
+
+	constexpr size_t length{ 25 };
+	/// A random-state scramble is the inverse of a solution this short, like the WCA ones
+	constexpr uint8_t random_state_length{ 21 };
+	constexpr std::chrono::milliseconds random_state_timeout{ 10000 };
+
+} // namespace scramble
+
+namespace render {
+
+	/// The sticker colors as 0xAABBGGRR, in the order of the faces: U R F D L B
+	constexpr std::array<uint32_t, 6> sticker_colors{
+		0xFFFFFFFF, 0xFF1A1AC4, 0xFF489B00, 0xFF00D5FF, 0xFF0058FF, 0xFFAD4500,
+	};
+	/// The inner sides of the cubies
+	constexpr uint32_t plastic_color{ 0xFF141414 };
+	/// The part of its cell a cubie fills, the rest is the gap between the cubies
+	constexpr float cubie_fill{ 0.94f };
+	/// The linked programs of this driver, so that the launches after the first one skip the compilation
+	constexpr std::string_view program_cache_path{ "assets/programs" };
+
+	/// The vertical field of view, in degrees
+	constexpr float camera_fov{ 45.0f };
+	constexpr float camera_near{ 0.1f };
+	/// Also the depth 1 of the draw items
+	constexpr float camera_far{ 100.0f };
+
+} // namespace render
+
+} // namespace gzn::game::magicube::defaults
@@ -1,144 +1,70 @@
-#include <optional>
+#include <chrono>
+#include <random>
+#include <string>
+#include <utility>
 
 #include <glm/glm.hpp>
 #include <glm/common.hpp>
-#include <glm/gtc/type_ptr.hpp>
 #include <glm/ext/matrix_transform.hpp>  // translate, rotate
 #include <glm/ext/matrix_clip_space.hpp> // perspective
 
 #define GLFW_INCLUDE_NONE
 #include <GLFW/glfw3.h>
-#include <magic_enum.hpp>
 #include <spdlog/spdlog.h>
-#include <glbinding/gl/gl.h>
 
 #include <core/app/application.hpp>
 #include <core/io/inputs.hpp>
+#include <core/render/program_cache.hpp>
+#include <core/render/gl_counters.hpp>
 
+#include "game/magicube/defaults.hpp"
 #include "game/magicube/instance.hpp"
+#include "game/magicube/solver/two_phase_solver.hpp"
 
 namespace gzn::game::magicube {
 
 void instance::start() {
-	// == == == == == == == == == == SHADERS SOURCES == == == == == == == == == == //
-
-	static constexpr std::string_view vertex_shader_text{ R"glsl(
-		#version 440 core
-
-		layout (location = 0) in vec3 position;
-		layout (location = 1) in vec3 color;
-
-		out vec3 fragment_color;
-
-		uniform mat4 model;
-		uniform mat4 view;
-		uniform mat4 projection;
-
-		void main() {
-			gl_Position = projection * view * model * vec4(position, 1.0);
-
-			fragment_color = color;
-		};
-	)glsl" };
-
-	static constexpr std::string_view fragment_shader_text{ R"glsl(
-		#version 440 core
-
-		in vec3 fragment_color;
-		out vec4 FragColor;
-
-		void main() {
-			FragColor = vec4(fragment_color, 1.0);
-		}
-	)glsl" };
-
-	// == == == == == == == == == == SHADERS PROGRAM == == == == == == == == == == //
-
-	static const auto make_shader{ [](const auto source_code, const auto type) {
-		const uint32_t shader{ gl::glCreateShader(type) };
-		const auto *text{ source_code.data() };
-		const auto text_length{ static_cast<gl::GLint>(source_code.length()) };
-		gl::glShaderSource(shader, 1, &text, &text_length);
-		gl::glCompileShader(shader);
-		int32_t success{};
-		gl::glGetShaderiv(shader, gl::GL_COMPILE_STATUS, &success);
-		if (!success) {
-			char info_log[512];
-			gl::glGetShaderInfoLog(shader, sizeof(info_log), nullptr, info_log);
-			spdlog::error("[instance::start] Failed to compile '{}' shader: {}",
-				magic_enum::enum_name(type), info_log);
-			return std::optional<uint32_t>{};
-		}
-		return std::make_optional(shader);
-	}};
-
-	const auto vertex_shader{ make_shader(vertex_shader_text, gl::GL_VERTEX_SHADER) };
-	const auto fragment_shader{ make_shader(fragment_shader_text, gl::GL_FRAGMENT_SHADER) };
-
-	if (!vertex_shader || !fragment_shader) {
+	using clock = std::chrono::steady_clock;
+	const auto start{ clock::now() };
+	auto phase_start{ start };
+	const auto phase{ [&phase_start] {
+		const auto now{ clock::now() };
+		return std::chrono::duration<double, std::milli>{ now - std::exchange(phase_start, now) }.count();
+	} };
+
+	// The tables are loaded from the disk or generated on the first launch, which takes a while
+	auto solver_tables{ std::async(std::launch::async, [] {
+		return two_phase_tables::load_or_generate(defaults::solver::two_phase_tables_path);
+	}).share() };
+
+	two_phase_options options;
+	options.target_length = defaults::solver::background_target_length;
+	options.timeout = defaults::solver::background_timeout;
+	solver = std::make_unique<solver_service>(std::move(solver_tables), options);
+	const auto solver_time{ phase() };
+
+	core::render::program_cache programs{ defaults::render::program_cache_path };
+	camera = core::render::camera_buffer::create();
+	renderer = cubie_renderer::create(programs);
+	if (!camera || !renderer) {
 		return;
 	}
+	const auto renderer_time{ phase() };
+	show_cube();
 
-	program = gl::glCreateProgram();
-	gl::glAttachShader(program, vertex_shader.value());
-	gl::glAttachShader(program, fragment_shader.value());
-	gl::glLinkProgram(program);
-	int32_t success{};
-	gl::glGetProgramiv(program, gl::GL_LINK_STATUS, &success);
-	if (!success) {
-		char info_log[512];
-		gl::glGetProgramInfoLog(program, sizeof(info_log), nullptr, info_log);
-		spdlog::error("[instance::start] Failed to link program: {}", info_log);
-		return;
-	}
-
-	gl::glDeleteShader(vertex_shader.value());
-	gl::glDeleteShader(fragment_shader.value());
-
-	// == == == == == == == == == == ==  BUFFERS  == == == == == == == == == == == //
-
-	constexpr float vertices[] = {
-		// positions          // color
-		 0.5f,  0.5f, 0.0f,   1.0f, 1.0f, 1.0f, // top right
-		 0.5f, -0.5f, 0.0f,   1.0f, 1.0f, 0.0f, // bottom right
-		-0.5f, -0.5f, 0.0f,   1.0f, 0.0f, 0.0f, // bottom left
-		-0.5f,  0.5f, 0.0f,   1.0f, 0.0f, 1.0f  // top left
-	};
-	constexpr uint32_t indices[] = {
-		0, 1, 3, // first triangle
-		1, 2, 3  // second triangle
-	};
-
-	gl::glGenVertexArrays(1, &VAO);
-	gl::glGenBuffers(1, &VBO);
-	gl::glGenBuffers(1, &EBO);
-
-	gl::glBindVertexArray(VAO);
-
-	gl::glBindBuffer(gl::GL_ARRAY_BUFFER, VBO);
-	gl::glBufferData(gl::GL_ARRAY_BUFFER, sizeof(vertices), vertices, gl::GL_STATIC_DRAW);
-
-	gl::glBindBuffer(gl::GL_ELEMENT_ARRAY_BUFFER, EBO);
-	gl::glBufferData(gl::GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, gl::GL_STATIC_DRAW);
-
-	// position attribute
-	const int32_t vpos_location{ gl::glGetAttribLocation(program, "position") };
-	gl::glVertexAttribPointer(vpos_location, 3, gl::GL_FLOAT, gl::GL_FALSE, 6 * sizeof(float), (void*)0);
-	gl::glEnableVertexAttribArray(vpos_location);
-
-	// color attribute
-	const int32_t vcol_location{ gl::glGetAttribLocation(program, "color") };
-	gl::glVertexAttribPointer(vcol_location, 3, gl::GL_FLOAT, gl::GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-	gl::glEnableVertexAttribArray(vcol_location);
+	// == == == == == == == == == == ==   CAMERA    == == == == == == == == == == //
 
-	// == == == == == == == == == == PROGRAM UNIFORM == == == == == == == == == == //
-
-	view = glm::translate(view, glm::vec3(0.0f, 0.0f, -3.0f));
+	// looking down at the corner of U, F and R
+	view = glm::translate(view, glm::vec3(0.0f, 0.0f, -6.0f));
+	view = glm::rotate(view, glm::radians(30.0f), glm::vec3{ 1.0f, 0.0f, 0.0f });
+	view = glm::rotate(view, glm::radians(-40.0f), glm::vec3{ 0.0f, 1.0f, 0.0f });
 	projection = make_projection();
+	camera->set_view(view);
+	camera->set_projection(projection);
+	const auto scene_time{ phase() };
 
-	set_matrix("model", model);
-	set_matrix("view", view);
-	set_matrix("projection", projection);
+	spdlog::info("[instance::start] Started in {:.2f} ms: solver {:.2f} ms, programs and buffers {:.2f} ms, scene {:.2f} ms",
+		std::chrono::duration<double, std::milli>{ clock::now() - start }.count(), solver_time, renderer_time, scene_time);
 }
 
 void instance::update(const double delta) {
@@ -148,6 +74,17 @@ void instance::update(const double delta) {
 
 	if (paused) return;
 
+	if (core::io::inputs::just_released(core::io::key::r)) {
+		scramble();
+	}
+	if (core::io::inputs::just_released(core::io::key::s)) {
+		solve();
+	}
+	if (core::io::inputs::just_released(core::io::key::i)) {
+		log_frame_stats();
+	}
+	poll_solver();
+
 	static double timer{ 0.0 };
 	timer += delta;
 
@@ -158,22 +95,21 @@ void instance::update(const double delta) {
 	model = glm::translate(model, glm::vec3{ 0.0f, offset, 0.0f });
 }
 
-void instance::draw() {
-	gl::glUseProgram(program);
-	set_matrix("model", model);
-	set_matrix("view", view);
-	set_matrix("projection", projection);
+void instance::draw(core::render::render_queue &queue) {
+	queue_frame = queue.last_frame();
+	queue_streaming = queue.streaming();
+	if (!camera || !renderer) return;
 
-	gl::glBindVertexArray(VAO);
-	gl::glDrawElements(gl::GL_TRIANGLES, 6, gl::GL_UNSIGNED_INT, 0);
+	camera->upload();
+	// the centre of the cube, the view looks down -z
+	const auto distance{ -(view * model)[3].z };
+	renderer->draw(queue, model, distance / defaults::render::camera_far);
 }
 
 void instance::stop() {
-	gl::glDeleteProgram(program);
-
-	gl::glDeleteBuffers(1, &EBO);
-	gl::glDeleteBuffers(1, &VBO);
-	gl::glDeleteVertexArrays(1, &VAO);
+	solver.reset();
+	renderer.reset();
+	camera.reset();
 }
 
 void instance::pause() { paused = true; }
@@ -191,15 +127,91 @@ void instance::notification(const core::notification_type type) {
 
 		case core::notification_type::framebuffer_size_changed:
 			projection = make_projection();
+			if (camera) {
+				camera->set_projection(projection);
+			}
 			break;
 
 		default: break;
 	}
 }
 
-void instance::set_matrix(const std::string_view name, const glm::mat4x4 &value) {
-	const auto location{ gl::glGetUniformLocation(program, name.data()) };
-	gl::glUniformMatrix4fv(location, 1, gl::GL_FALSE, glm::value_ptr(value));
+void instance::scramble() {
+	static std::mt19937 engine{ std::random_device{}() };
+	std::uniform_int_distribution<size_t> distribution{ 0, move_count - 1 };
+
+	// the cube isn't the one being solved anymore
+	if (solver) {
+		solver->cancel();
+	}
+
+	std::string notation;
+	for (size_t i{}; i < defaults::scramble::length; ++i) {
+		const auto m{ static_cast<move>(distribution(engine)) };
+		cube.apply(m);
+		notation.append(to_string(m)).push_back(' ');
+	}
+	spdlog::info("[instance::scramble] Scrambled with: {}", notation);
+	show_cube();
+}
+
+void instance::solve() {
+	if (cube.solved()) {
+		spdlog::info("[instance::solve] The cube is already solved");
+		return;
+	}
+	if (!solver) return;
+
+	solve_request = solver->request(cube);
+	spdlog::info("[instance::solve] Searching in the background");
+}
+
+void instance::poll_solver() {
+	if (!solver) return;
+
+	const auto update{ solver->poll() };
+	if (!update || update->request != solve_request) return;
+
+	if (!update->final) {
+		spdlog::info("[instance::poll_solver] {} moves so far", update->solution->size());
+		return;
+	}
+	if (!update->solution) {
+		spdlog::warn("[instance::poll_solver] No solution found");
+		return;
+	}
+
+	std::string notation;
+	for (const auto m : *update->solution) {
+		notation.append(to_string(m)).push_back(' ');
+	}
+	spdlog::info("[instance::poll_solver] {} moves: {}", update->solution->size(), notation);
+	cube.apply(*update->solution);
+	show_cube();
+}
+
+void instance::show_cube() {
+	if (renderer) {
+		renderer->assign(facelet_cube::from_cubies(cube.to_cubies()));
+	}
+}
+
+void instance::log_frame_stats() const {
+	if (!renderer) return;
+
+	const auto &stats{ renderer->last_frame() };
+	const auto &calls{ core::render::gl_counters::last_frame() };
+	spdlog::info("[instance::log_frame_stats] {} cubies, {} bytes uploaded in {:.3f} ms, "
+		"{} state calls issued and {} saved", stats.instances, stats.uploaded,
+		std::chrono::duration<double, std::milli>{ stats.submit_time }.count(), calls.issued, calls.saved);
+	spdlog::info("[instance::log_frame_stats] {} draw item{} in {} draw call{} with {} state changes, "
+		"sorted in {:.3f} ms and submitted in {:.3f} ms",
+		queue_frame.items, queue_frame.items == 1 ? "" : "s", queue_frame.draw_calls, queue_frame.draw_calls == 1 ? "" : "s",
+		queue_frame.state_changes, std::chrono::duration<double, std::milli>{ queue_frame.sort_time }.count(),
+		std::chrono::duration<double, std::milli>{ queue_frame.submit_time }.count());
+	spdlog::info("[instance::log_frame_stats] The queue waited for a fence in {} of {} frames for {:.3f} ms",
+		queue_streaming.fence_waits, queue_streaming.frames,
+		std::chrono::duration<double, std::milli>{ queue_streaming.wait_time }.count());
 }
 
 glm::mat4x4 instance::make_projection() {
@@ -208,7 +220,8 @@ glm::mat4x4 instance::make_projection() {
 	int32_t height{ 0 };
 	glfwGetWindowSize(window, &width, &height);
 	const float aspect_ratio{ static_cast<float>(width) / static_cast<float>(height) };
-	return glm::perspective(glm::radians(45.0f), aspect_ratio, 0.1f, 100.0f);
+	return glm::perspective(glm::radians(defaults::render::camera_fov), aspect_ratio,
+		defaults::render::camera_near, defaults::render::camera_far);
 }
 
 
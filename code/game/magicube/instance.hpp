@@ -1,8 +1,16 @@
 #pragma once
 
-#include <string_view>
+#include <future>
+#include <memory>
+#include <optional>
 #include <glm/mat4x4.hpp>
 #include <core/app/game_base.hpp>
+#include <core/render/camera_buffer.hpp>
+#include <core/render/render_queue.hpp>
+
+#include "game/magicube/cube/cube_state.hpp"
+#include "game/magicube/render/cubie_renderer.hpp"
+#include "game/magicube/solver/solver_service.hpp"
 
 namespace gzn::game::magicube {
 
@@ -12,7 +20,7 @@ public:
 
 	void start() override;
 	void update(const double delta) override;
-	void draw() override;
+	void draw(core::render::render_queue &queue) override;
 	void stop() override;
 
 	void pause() override;
@@ -23,16 +31,27 @@ public:
 private:
 	bool paused{ false };
 
-	uint32_t VAO{};
-	uint32_t VBO{};
-	uint32_t EBO{};
-	uint32_t program{};
+	std::optional<core::render::camera_buffer> camera;
+	std::unique_ptr<cubie_renderer> renderer;
+	/// What the queue submitted last frame
+	core::render::queue_stats queue_frame{};
+	core::render::stream_stats queue_streaming{};
 
 	glm::mat4x4 model{ 1.0f };
 	glm::mat4x4 view{ 1.0f };
 	glm::mat4x4 projection{ 1.0f };
 
-	void set_matrix(const std::string_view name, const glm::mat4x4 &value);
+	cube_state cube{};
+	std::unique_ptr<solver_service> solver;
+	uint64_t solve_request{};
+
+	void scramble();
+	void solve();
+	void poll_solver();
+	/// @brief The renderer draws the cube as it is now
+	void show_cube();
+	void log_frame_stats() const;
+
 	static glm::mat4x4 make_projection();
 };
 
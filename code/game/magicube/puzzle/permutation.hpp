@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <numeric>
+#include <cinttypes>
+
+namespace gzn::game::magicube {
+
+/// @brief A permutation of `Degree` points, the sticker-level view of a puzzle state
+template<size_t Degree>
+struct permutation {
+	static_assert(Degree > 0 && Degree <= 256, "The points are stored as bytes");
+
+	/// The point that the point `i` goes to
+	std::array<uint8_t, Degree> images{ [] {
+		std::array<uint8_t, Degree> identity{};
+		for (size_t i{}; i < Degree; ++i) identity[i] = static_cast<uint8_t>(i);
+		return identity;
+	}() };
+
+	[[nodiscard]] constexpr uint8_t operator[](const size_t point) const noexcept { return images[point]; }
+	[[nodiscard]] constexpr uint8_t &operator[](const size_t point) noexcept { return images[point]; }
+
+	[[nodiscard]] constexpr bool is_identity() const noexcept {
+		for (size_t i{}; i < Degree; ++i) {
+			if (images[i] != i) return false;
+		}
+		return true;
+	}
+
+	[[nodiscard]] constexpr bool operator==(const permutation &other) const noexcept {
+		for (size_t i{}; i < Degree; ++i) {
+			if (images[i] != other.images[i]) return false;
+		}
+		return true;
+	}
+	[[nodiscard]] constexpr bool operator!=(const permutation &other) const noexcept { return !(*this == other); }
+};
+
+/// @brief Composition: @p lhs and then @p rhs
+template<size_t Degree>
+[[nodiscard]] constexpr permutation<Degree> multiply(const permutation<Degree> &lhs, const permutation<Degree> &rhs) noexcept {
+	permutation<Degree> result;
+	for (size_t i{}; i < Degree; ++i) {
+		result.images[i] = rhs.images[lhs.images[i]];
+	}
+	return result;
+}
+
+template<size_t Degree>
+[[nodiscard]] constexpr permutation<Degree> inverse(const permutation<Degree> &p) noexcept {
+	permutation<Degree> result;
+	for (size_t i{}; i < Degree; ++i) {
+		result.images[p.images[i]] = static_cast<uint8_t>(i);
+	}
+	return result;
+}
+
+/// @brief The least common multiple of the cycle lengths
+template<size_t Degree>
+[[nodiscard]] constexpr uint64_t order(const permutation<Degree> &p) noexcept {
+	std::array<bool, Degree> seen{};
+	uint64_t result{ 1 };
+	for (size_t i{}; i < Degree; ++i) {
+		if (seen[i]) continue;
+		uint64_t length{};
+		for (size_t j{ i }; !seen[j]; j = p.images[j]) {
+			seen[j] = true;
+			++length;
+		}
+		result = std::lcm(result, length);
+	}
+	return result;
+}
+
+} // namespace gzn::game::magicube
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+#include <utility>
+#include <optional>
+#include <cinttypes>
+
+#include <fmt/format.h>
+
+#include "game/magicube/puzzle/permutation.hpp"
+
+namespace gzn::game::magicube {
+
+/// @brief The group generated by some permutations, kept as a stabiliser chain built by the
+/// deterministic Schreier-Sims algorithm. Level `i` fixes the base points before its own and
+/// stores, for every point of the orbit of its base point, an element taking the base point
+/// there. Any element of the group is a product of one such element per level, so its order
+/// is the product of the orbit sizes and a membership test is a single sift down the chain.
+template<size_t Degree>
+class permutation_group {
+public:
+	using element = permutation<Degree>;
+
+	explicit permutation_group(const std::vector<element> &generators) {
+		for (const auto &generator : generators) {
+			if (generator.is_identity()) continue;
+			static_cast<void>(add_generator(generator, 0));
+		}
+		complete();
+	}
+
+	/// @brief Whether @p g is in the group, `Degree` byte lookups per level of the chain
+	[[nodiscard]] bool contains(const element &g) const noexcept {
+		const auto [residue, level]{ sift(g, 0) };
+		return level == m_levels.size() && residue.is_identity();
+	}
+
+	/// @brief The number of elements in decimal, the puzzle groups don't fit in 64 bits
+	[[nodiscard]] std::string order() const {
+		// little-endian digits in the base 10^9
+		std::vector<uint32_t> digits{ 1 };
+		for (const auto &level : m_levels) {
+			uint64_t carry{};
+			for (auto &digit : digits) {
+				const auto value{ uint64_t{ digit } * level.orbit.size() + carry };
+				digit = static_cast<uint32_t>(value % 1000000000);
+				carry = value / 1000000000;
+			}
+			if (carry > 0) digits.push_back(static_cast<uint32_t>(carry));
+		}
+
+		auto result{ fmt::format("{}", digits.back()) };
+		for (size_t i{ digits.size() - 1 }; i-- > 0;) {
+			result += fmt::format("{:09}", digits[i]);
+		}
+		return result;
+	}
+
+	[[nodiscard]] size_t base_length() const noexcept { return m_levels.size(); }
+	[[nodiscard]] uint8_t base_point(const size_t level) const noexcept { return m_levels[level].point; }
+	[[nodiscard]] size_t orbit_size(const size_t level) const noexcept { return m_levels[level].orbit.size(); }
+
+private:
+	static constexpr uint16_t not_in_orbit{ 0xFFFF };
+
+	struct level {
+		uint8_t point{};
+		std::vector<element> generators;
+		std::vector<uint8_t> orbit;
+		/// Where the element taking the base point to the point `i` is, or `not_in_orbit`
+		std::array<uint16_t, Degree> transversal_index{};
+		std::vector<element> transversal;
+		std::vector<element> inverse_transversal;
+	};
+
+	std::vector<level> m_levels;
+
+	/// @brief Divides @p g by the transversals from @p first on; returns what's left and the
+	/// level where it stopped, the length of the chain when it went through all of them
+	[[nodiscard]] std::pair<element, size_t> sift(element g, const size_t first) const noexcept {
+		for (size_t i{ first }; i < m_levels.size(); ++i) {
+			const auto &current{ m_levels[i] };
+			const auto index{ current.transversal_index[g[current.point]] };
+			if (index == not_in_orbit) {
+				return { g, i };
+			}
+			g = multiply(g, current.inverse_transversal[index]);
+		}
+		return { g, m_levels.size() };
+	}
+
+	/// @brief Adds @p g, which fixes the base points before @p first, to the levels from
+	/// @p first down to the first one whose base point it moves, and returns that level
+	size_t add_generator(const element &g, const size_t first) {
+		size_t last{ first };
+		while (last < m_levels.size() && g[m_levels[last].point] == m_levels[last].point) ++last;
+		if (last == m_levels.size()) {
+			uint8_t point{};
+			while (g[point] == point) ++point;
+			m_levels.emplace_back();
+			m_levels.back().point = point;
+		}
+		for (size_t i{ first }; i <= last; ++i) {
+			m_levels[i].generators.push_back(g);
+			build_orbit(m_levels[i]);
+		}
+		return last;
+	}
+
+	static void build_orbit(level &current) {
+		current.orbit.assign(1, current.point);
+		current.transversal_index.fill(not_in_orbit);
+		current.transversal_index[current.point] = 0;
+		current.transversal.assign(1, element{});
+
+		for (size_t i{}; i < current.orbit.size(); ++i) {
+			const auto x{ current.orbit[i] };
+			for (const auto &s : current.generators) {
+				const auto y{ s[x] };
+				if (current.transversal_index[y] != not_in_orbit) continue;
+				current.transversal_index[y] = static_cast<uint16_t>(current.orbit.size());
+				current.orbit.push_back(y);
+				current.transversal.push_back(multiply(current.transversal[current.transversal_index[x]], s));
+			}
+		}
+
+		current.inverse_transversal.resize(current.transversal.size());
+		for (size_t i{}; i < current.transversal.size(); ++i) {
+			current.inverse_transversal[i] = inverse(current.transversal[i]);
+		}
+	}
+
+	/// @brief Sifts the Schreier generators of every level through the levels below it, from the
+	/// deepest level up; a generator that doesn't sift through extends the chain and the check
+	/// restarts where it was added
+	void complete() {
+		size_t i{ m_levels.size() };
+		while (i > 0) {
+			const auto restart{ check_level(i - 1) };
+			i = restart ? *restart + 1 : i - 1;
+		}
+	}
+
+	[[nodiscard]] std::optional<size_t> check_level(const size_t i) {
+		const auto &current{ m_levels[i] };
+		for (size_t x{}; x < current.orbit.size(); ++x) {
+			for (size_t s{}; s < current.generators.size(); ++s) {
+				const auto &generator{ current.generators[s] };
+				const auto y{ current.transversal_index[generator[current.orbit[x]]] };
+				// u_x * s * u_y^-1 fixes the base point of the level
+				const auto schreier{ multiply(multiply(current.transversal[x], generator), current.inverse_transversal[y]) };
+				if (schreier.is_identity()) continue;
+
+				const auto [residue, stopped]{ sift(schreier, i + 1) };
+				if (stopped == m_levels.size() && residue.is_identity()) continue;
+
+				return add_generator(residue, i + 1);
+			}
+		}
+		return std::nullopt;
+	}
+};
+
+} // namespace gzn::game::magicube
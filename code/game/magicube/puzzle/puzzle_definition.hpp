@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <cinttypes>
+#include <string_view>
+
+namespace gzn::game::magicube {
+
+/// @brief Pieces of one kind: they only ever take each other's positions
+struct orbit_definition {
+	uint8_t count{};
+	/// The ways a piece sits on its position, 1 when it doesn't matter
+	uint8_t orientations{ 1 };
+};
+
+/// @brief What a turn does to an orbit: the piece from the position `i` goes to `to[i]`, and
+/// `twist[i]` is added to its orientation
+template<size_t MaxPieces>
+struct orbit_turn {
+	std::array<uint8_t, MaxPieces> to{};
+	std::array<uint8_t, MaxPieces> twist{};
+};
+
+/// @brief A permutation puzzle described by its orbits and the smallest clockwise turn of each
+/// face (or of each corner for the vertex-turning puzzles). Every turn has the same order.
+template<size_t Orbits, size_t Faces, size_t MaxPieces>
+struct puzzle_definition {
+	static constexpr size_t orbit_count{ Orbits };
+	static constexpr size_t face_count{ Faces };
+	static constexpr size_t max_pieces{ MaxPieces };
+
+	std::array<orbit_definition, Orbits> orbits{};
+	std::array<std::array<orbit_turn<MaxPieces>, Orbits>, Faces> turns{};
+	/// How many turns bring a face back: 4 on a cube, 3 on a tetrahedron, 5 on a dodecahedron
+	uint8_t turn_order{ 4 };
+	std::array<std::string_view, Faces> names{};
+};
+
+/// @brief Specialised for every puzzle with `static constexpr puzzle_definition<...> definition`
+template<class Puzzle>
+struct puzzle_traits;
+
+/// @brief Every turn moves each piece to one position and comes back after `turn_order` times
+template<size_t Orbits, size_t Faces, size_t MaxPieces>
+[[nodiscard]] constexpr bool is_valid(const puzzle_definition<Orbits, Faces, MaxPieces> &definition) noexcept {
+	for (size_t o{}; o < Orbits; ++o) {
+		const auto &orbit{ definition.orbits[o] };
+		if (orbit.count == 0 || orbit.count > MaxPieces || orbit.orientations == 0) return false;
+
+		for (size_t f{}; f < Faces; ++f) {
+			const auto &turn{ definition.turns[f][o] };
+			std::array<bool, MaxPieces> hit{};
+			for (size_t i{}; i < orbit.count; ++i) {
+				if (turn.to[i] >= orbit.count || hit[turn.to[i]] || turn.twist[i] >= orbit.orientations) return false;
+				hit[turn.to[i]] = true;
+
+				size_t position{ i };
+				size_t twist{};
+				for (size_t k{}; k < definition.turn_order; ++k) {
+					twist += turn.twist[position];
+					position = turn.to[position];
+				}
+				if (position != i || twist % orbit.orientations != 0) return false;
+			}
+		}
+	}
+	return true;
+}
+
+} // namespace gzn::game::magicube
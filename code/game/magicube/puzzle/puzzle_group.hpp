@@ -0,0 +1,149 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <numeric>
+#include <utility>
+#include <cinttypes>
+
+#include "game/magicube/puzzle/permutation.hpp"
+#include "game/magicube/puzzle/puzzle_state.hpp"
+#include "game/magicube/puzzle/permutation_group.hpp"
+
+namespace gzn::game::magicube {
+
+/// @brief Pieces going around one cycle of positions, twisted by `twist` once they're back
+struct piece_cycle {
+	uint8_t orbit{};
+	uint8_t twist{};
+	std::vector<uint8_t> positions;
+
+	/// @brief How many times the cycle has to be done to bring its pieces back untwisted
+	[[nodiscard]] uint64_t order(const uint8_t orientations) const noexcept {
+		return positions.size() * (orientations / std::gcd(twist, orientations));
+	}
+};
+
+/// @brief The group of a puzzle acting on its stickers: a piece of `n` orientations is `n`
+/// points, and a state moves the point `(piece, a)` to `(position, a + orientation)`. The
+/// states are exactly the elements of the group generated by the face turns, so a state is
+/// reachable when it sifts through the stabiliser chain.
+template<class Puzzle>
+class puzzle_group {
+public:
+	using state_type = puzzle_state<Puzzle>;
+
+	static constexpr auto first_points{ [] {
+		std::array<size_t, state_type::orbit_count + 1> points{};
+		for (size_t o{}; o < state_type::orbit_count; ++o) {
+			const auto &orbit{ state_type::definition.orbits[o] };
+			points[o + 1] = points[o] + size_t{ orbit.count } * orbit.orientations;
+		}
+		return points;
+	}() };
+	static constexpr size_t degree{ first_points.back() };
+
+	using element = permutation<degree>;
+
+	puzzle_group()
+		: m_group{ generators() } {}
+
+	/// @brief Whether every field of @p state is a piece of its orbit, each one at a position of
+	/// its own and in one of its orientations. Anything else isn't a state at all
+	[[nodiscard]] static bool valid(const state_type &state) noexcept {
+		for (size_t o{}; o < state_type::orbit_count; ++o) {
+			const auto &orbit{ state_type::definition.orbits[o] };
+			std::array<bool, state_type::definition.max_pieces> used{};
+			for (size_t i{}; i < orbit.count; ++i) {
+				const auto position{ state.position(o, i) };
+				if (position >= orbit.count || used[position] || state.orientation(o, i) >= orbit.orientations) {
+					return false;
+				}
+				used[position] = true;
+			}
+		}
+		return true;
+	}
+
+	/// @note @p state has to be `valid`
+	[[nodiscard]] static element to_permutation(const state_type &state) noexcept {
+		element result;
+		for (size_t o{}; o < state_type::orbit_count; ++o) {
+			const size_t orientations{ state_type::definition.orbits[o].orientations };
+			for (size_t i{}; i < state_type::definition.orbits[o].count; ++i) {
+				const auto position{ state.position(o, i) };
+				const auto orientation{ state.orientation(o, i) };
+				for (size_t a{}; a < orientations; ++a) {
+					result[point(o, i, a)] = point(o, position, (a + orientation) % orientations);
+				}
+			}
+		}
+		return result;
+	}
+
+	/// @brief The clockwise turn of every face
+	[[nodiscard]] static std::vector<element> generators() {
+		std::vector<element> result;
+		for (size_t f{}; f < state_type::face_count; ++f) {
+			result.push_back(to_permutation(state_type{}.moved(state_type::make_move(f, 1))));
+		}
+		return result;
+	}
+
+	/// @brief Whether the turns can reach @p state, a few microseconds at most. A state which
+	/// isn't `valid` is never reachable
+	[[nodiscard]] bool reachable(const state_type &state) const noexcept {
+		return valid(state) && m_group.contains(to_permutation(state));
+	}
+
+	/// @brief The number of reachable states in decimal
+	[[nodiscard]] std::string order() const { return m_group.order(); }
+
+	[[nodiscard]] const permutation_group<degree> &group() const noexcept { return m_group; }
+
+	/// @brief The pieces that @p state moves or twists, cycle by cycle, none if it isn't `valid`
+	[[nodiscard]] static std::vector<piece_cycle> cycles(const state_type &state) {
+		std::vector<piece_cycle> result;
+		if (!valid(state)) return result;
+		for (size_t o{}; o < state_type::orbit_count; ++o) {
+			const auto &orbit{ state_type::definition.orbits[o] };
+			// the position of the piece is where the piece from that position goes
+			std::array<bool, state_type::definition.max_pieces> seen{};
+			for (size_t i{}; i < orbit.count; ++i) {
+				if (seen[i]) continue;
+
+				piece_cycle cycle{ static_cast<uint8_t>(o), 0, {} };
+				size_t twist{};
+				for (size_t piece{ i }; !seen[piece]; piece = state.position(o, piece)) {
+					seen[piece] = true;
+					cycle.positions.push_back(static_cast<uint8_t>(piece));
+					twist += state.orientation(o, piece);
+				}
+				cycle.twist = static_cast<uint8_t>(twist % orbit.orientations);
+				if (cycle.positions.size() > 1 || cycle.twist != 0) {
+					result.push_back(std::move(cycle));
+				}
+			}
+		}
+		return result;
+	}
+
+	/// @brief How many times the algorithm that leads to @p state has to be repeated to solve
+	/// the puzzle again
+	[[nodiscard]] static uint64_t algorithm_order(const state_type &state) {
+		uint64_t result{ 1 };
+		for (const auto &cycle : cycles(state)) {
+			result = std::lcm(result, cycle.order(state_type::definition.orbits[cycle.orbit].orientations));
+		}
+		return result;
+	}
+
+private:
+	permutation_group<degree> m_group;
+
+	[[nodiscard]] static constexpr uint8_t point(const size_t orbit, const size_t piece, const size_t orientation) noexcept {
+		return static_cast<uint8_t>(first_points[orbit] + piece * state_type::definition.orbits[orbit].orientations + orientation);
+	}
+};
+
+} // namespace gzn::game::magicube
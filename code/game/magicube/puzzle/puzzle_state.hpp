@@ -0,0 +1,299 @@
+#pragma once
+
+#include <array>
+#include <algorithm>
+#include <utility>
+#include <iterator>
+#include <cinttypes>
+#include <type_traits>
+
+#include <core/tools/bits.hpp>
+
+#include "game/magicube/cube/cube_state.hpp"
+#include "game/magicube/puzzle/puzzle_definition.hpp"
+
+namespace gzn::game::magicube {
+
+namespace detail {
+
+struct orbit_layout {
+	uint32_t position_bits{};
+	uint32_t field_bits{};
+	size_t fields_per_word{};
+	size_t first_word{};
+	size_t word_count{};
+};
+
+template<size_t Orbits>
+struct puzzle_layout {
+	std::array<orbit_layout, Orbits> orbits{};
+	size_t word_count{};
+	/// Enough entries for the widest field
+	size_t table_size{};
+};
+
+template<class Definition>
+[[nodiscard]] constexpr auto make_puzzle_layout(const Definition &definition) noexcept {
+	puzzle_layout<Definition::orbit_count> result{};
+	for (size_t o{}; o < Definition::orbit_count; ++o) {
+		const auto &orbit{ definition.orbits[o] };
+		auto &layout{ result.orbits[o] };
+		while ((1u << layout.position_bits) < orbit.count) ++layout.position_bits;
+		uint32_t orientation_bits{};
+		while ((1u << orientation_bits) < orbit.orientations) ++orientation_bits;
+		layout.field_bits = layout.position_bits + orientation_bits;
+		layout.fields_per_word = 64 / layout.field_bits;
+		layout.first_word = result.word_count;
+		layout.word_count = (orbit.count + layout.fields_per_word - 1) / layout.fields_per_word;
+		result.word_count += layout.word_count;
+		result.table_size = std::max<size_t>(result.table_size, size_t{ 1 } << layout.field_bits);
+	}
+	return result;
+}
+
+[[nodiscard]] constexpr uint8_t make_field(const orbit_layout &layout, const size_t position, const size_t orientation) noexcept {
+	return static_cast<uint8_t>((orientation << layout.position_bits) | position);
+}
+
+/// @brief tables[m][orbit][field] is where the field goes after the move `m`, which is the power
+/// `m % (order - 1) + 1` of the face `m / (order - 1)`
+template<size_t MoveCount, size_t TableSize, class Definition, size_t Orbits>
+[[nodiscard]] constexpr auto make_puzzle_move_tables(const Definition &definition, const puzzle_layout<Orbits> &layout) noexcept {
+	std::array<std::array<std::array<uint8_t, TableSize>, Orbits>, MoveCount> tables{};
+	const size_t powers{ definition.turn_order - 1u };
+	for (size_t m{}; m < MoveCount; ++m) {
+		for (size_t o{}; o < Orbits; ++o) {
+			const auto &orbit{ definition.orbits[o] };
+			const auto &turn{ definition.turns[m / powers][o] };
+			for (size_t i{}; i < orbit.count; ++i) {
+				size_t position{ i };
+				size_t twist{};
+				for (size_t k{}; k <= m % powers; ++k) {
+					twist += turn.twist[position];
+					position = turn.to[position];
+				}
+				for (size_t orientation{}; orientation < orbit.orientations; ++orientation) {
+					tables[m][o][make_field(layout.orbits[o], i, orientation)] =
+						make_field(layout.orbits[o], position, (orientation + twist) % orbit.orientations);
+				}
+			}
+		}
+	}
+	return tables;
+}
+
+template<size_t WordCount, class Definition, size_t Orbits>
+[[nodiscard]] constexpr auto make_solved_words(const Definition &definition, const puzzle_layout<Orbits> &layout) noexcept {
+	std::array<uint64_t, WordCount> words{};
+	for (size_t o{}; o < Orbits; ++o) {
+		const auto &orbit_layout{ layout.orbits[o] };
+		for (size_t i{}; i < definition.orbits[o].count; ++i) {
+			words[orbit_layout.first_word + i / orbit_layout.fields_per_word] |=
+				uint64_t{ i } << ((i % orbit_layout.fields_per_word) * orbit_layout.field_bits);
+		}
+	}
+	return words;
+}
+
+} // namespace detail
+
+/// @brief The state of any puzzle of `puzzle_traits<Puzzle>`, laid out like `cube_state`: every
+/// piece is a field `(orientation << position_bits) | position` packed into 64-bit words, and a
+/// move is one lookup per field in a table the compiler builds from the definition. The 3x3
+/// ends up with the very same words and tables as `cube_state`.
+template<class Puzzle>
+class puzzle_state {
+public:
+	static constexpr const auto &definition{ puzzle_traits<Puzzle>::definition };
+	static constexpr size_t orbit_count{ definition.orbit_count };
+	static constexpr size_t face_count{ definition.face_count };
+	static constexpr size_t turn_order{ definition.turn_order };
+	static constexpr size_t move_count{ face_count * (turn_order - 1) };
+
+	static_assert(is_valid(definition), "The turns of the puzzle have to be permutations of the turn order");
+
+	/// @brief `face * (turn_order - 1) + power - 1`
+	using move_type = uint8_t;
+
+	[[nodiscard]] static constexpr move_type make_move(const size_t face, const size_t power) noexcept {
+		return static_cast<move_type>(face * (turn_order - 1) + (power - 1) % (turn_order - 1));
+	}
+	[[nodiscard]] static constexpr size_t face_of(const move_type m) noexcept { return m / (turn_order - 1); }
+	[[nodiscard]] static constexpr size_t power_of(const move_type m) noexcept { return m % (turn_order - 1) + 1; }
+	[[nodiscard]] static constexpr move_type inverse(const move_type m) noexcept {
+		return make_move(face_of(m), turn_order - power_of(m));
+	}
+
+	static constexpr auto memory_layout{ detail::make_puzzle_layout(definition) };
+	static constexpr const auto &layouts{ memory_layout.orbits };
+	static constexpr size_t word_count{ memory_layout.word_count };
+	static constexpr size_t table_size{ memory_layout.table_size };
+
+	using words_type = std::array<uint64_t, word_count>;
+	using field_table = std::array<uint8_t, table_size>;
+
+	/// @brief move_tables[m][orbit][field] is where the field goes after the move `m`
+	static constexpr auto move_tables{ detail::make_puzzle_move_tables<move_count, table_size>(definition, memory_layout) };
+
+	constexpr puzzle_state() noexcept = default;
+
+	[[nodiscard]] static constexpr puzzle_state from_words(const words_type &words) noexcept {
+		puzzle_state state;
+		state.m_words = words;
+		return state;
+	}
+	[[nodiscard]] constexpr const words_type &words() const noexcept { return m_words; }
+
+	void apply(const move_type m) noexcept { apply(m, std::make_index_sequence<orbit_count>{}); }
+
+	template<class Iterator>
+	void apply(Iterator first, const Iterator last) noexcept {
+		for (; first != last; ++first) apply(*first);
+	}
+
+	[[nodiscard]] puzzle_state moved(const move_type m) const noexcept {
+		auto result{ *this };
+		result.apply(m);
+		return result;
+	}
+
+	[[nodiscard]] constexpr bool solved() const noexcept { return m_words == solved_words; }
+
+	/// @brief The field of the piece @p piece of the orbit @p orbit
+	[[nodiscard]] constexpr uint8_t field(const size_t orbit, const size_t piece) const noexcept {
+		const auto &layout{ layouts[orbit] };
+		const auto word{ m_words[layout.first_word + piece / layout.fields_per_word] };
+		const auto shift{ (piece % layout.fields_per_word) * layout.field_bits };
+		return static_cast<uint8_t>((word >> shift) & ((uint64_t{ 1 } << layout.field_bits) - 1));
+	}
+	[[nodiscard]] constexpr uint8_t position(const size_t orbit, const size_t piece) const noexcept {
+		return static_cast<uint8_t>(field(orbit, piece) & ((1u << layouts[orbit].position_bits) - 1));
+	}
+	[[nodiscard]] constexpr uint8_t orientation(const size_t orbit, const size_t piece) const noexcept {
+		return static_cast<uint8_t>(field(orbit, piece) >> layouts[orbit].position_bits);
+	}
+
+	void set_field(const size_t orbit, const size_t piece, const uint8_t value) noexcept {
+		const auto &layout{ layouts[orbit] };
+		auto &word{ m_words[layout.first_word + piece / layout.fields_per_word] };
+		const auto shift{ (piece % layout.fields_per_word) * layout.field_bits };
+		const auto mask{ ((uint64_t{ 1 } << layout.field_bits) - 1) << shift };
+		word = (word & ~mask) | (uint64_t{ value } << shift);
+	}
+
+	[[nodiscard]] constexpr uint64_t hash() const noexcept {
+		uint64_t result{};
+		for (const auto word : m_words) {
+			result = detail::mix(result ^ word);
+		}
+		return result;
+	}
+
+	//===== COORDINATES =====//
+
+	/// @brief count! arrangements; 64 bits hold the orbits of up to 20 pieces, not the megaminx edges
+	[[nodiscard]] static constexpr uint64_t permutation_count(const size_t orbit) noexcept {
+		uint64_t count{ 1 };
+		for (uint64_t i{ 2 }; i <= definition.orbits[orbit].count; ++i) count *= i;
+		return count;
+	}
+	/// @brief orientations^count, every orientation is counted even when the last one follows
+	[[nodiscard]] static constexpr uint64_t orientation_count(const size_t orbit) noexcept {
+		uint64_t count{ 1 };
+		for (size_t i{}; i < definition.orbits[orbit].count; ++i) count *= definition.orbits[orbit].orientations;
+		return count;
+	}
+
+	/// @brief Lehmer code of the positions of the pieces, 0 when they're all home
+	[[nodiscard]] uint64_t permutation_coordinate(const size_t orbit) const noexcept {
+		const size_t count{ definition.orbits[orbit].count };
+		uint64_t result{};
+		uint64_t used{};
+		for (size_t i{}; i < count; ++i) {
+			const auto p{ position(orbit, i) };
+			const auto smaller{ core::tools::popcount(used & ((uint64_t{ 1 } << p) - 1)) };
+			result = result * (count - i) + (p - smaller);
+			used |= uint64_t{ 1 } << p;
+		}
+		return result;
+	}
+
+	/// @brief The orientations of the pieces as a number in base `orientations`
+	[[nodiscard]] uint64_t orientation_coordinate(const size_t orbit) const noexcept {
+		const auto &definition_orbit{ definition.orbits[orbit] };
+		uint64_t result{};
+		for (size_t i{}; i < definition_orbit.count; ++i) {
+			result = result * definition_orbit.orientations + orientation(orbit, i);
+		}
+		return result;
+	}
+
+	/// @brief Places the pieces by the Lehmer code @p value and keeps their orientations
+	void set_permutation_coordinate(const size_t orbit, uint64_t value) noexcept {
+		const size_t count{ definition.orbits[orbit].count };
+		std::array<uint8_t, definition.max_pieces> digits{};
+		for (size_t i{ count }; i-- > 0;) {
+			digits[i] = static_cast<uint8_t>(value % (count - i));
+			value /= count - i;
+		}
+
+		uint64_t free_positions{ (count == 64 ? 0 : uint64_t{ 1 } << count) - 1 };
+		for (size_t i{}; i < count; ++i) {
+			auto left{ free_positions };
+			for (uint8_t skip{}; skip < digits[i]; ++skip) left &= left - 1;
+			const auto p{ core::tools::count_trailing_zeros(left) };
+			free_positions &= ~(uint64_t{ 1 } << p);
+			set_field(orbit, i, detail::make_field(layouts[orbit], p, orientation(orbit, i)));
+		}
+	}
+
+	/// @brief Orients the pieces by @p value and keeps their positions
+	void set_orientation_coordinate(const size_t orbit, uint64_t value) noexcept {
+		const auto &definition_orbit{ definition.orbits[orbit] };
+		for (size_t i{ definition_orbit.count }; i-- > 0;) {
+			set_field(orbit, i, detail::make_field(layouts[orbit], position(orbit, i), value % definition_orbit.orientations));
+			value /= definition_orbit.orientations;
+		}
+	}
+
+	[[nodiscard]] constexpr bool operator==(const puzzle_state &other) const noexcept { return m_words == other.m_words; }
+	[[nodiscard]] constexpr bool operator!=(const puzzle_state &other) const noexcept { return m_words != other.m_words; }
+
+private:
+	static constexpr words_type solved_words{ detail::make_solved_words<word_count>(definition, memory_layout) };
+
+	words_type m_words{ solved_words };
+
+	template<size_t... Orbits>
+	void apply(const move_type m, std::index_sequence<Orbits...>) noexcept {
+		(apply_orbit<Orbits>(move_tables[m][Orbits]), ...);
+	}
+
+	/// The layout is known at compile time, so the loops unroll into the shifts and lookups of
+	/// a hand-written kernel
+	template<size_t Orbit>
+	void apply_orbit(const field_table &table) noexcept {
+		constexpr auto layout{ layouts[Orbit] };
+		constexpr size_t count{ definition.orbits[Orbit].count };
+		constexpr uint64_t mask{ (uint64_t{ 1 } << layout.field_bits) - 1 };
+		for (size_t w{}; w < layout.word_count; ++w) {
+			const auto word{ m_words[layout.first_word + w] };
+			const size_t fields{ std::min(layout.fields_per_word, count - w * layout.fields_per_word) };
+			uint64_t result{};
+			for (size_t i{}; i < fields; ++i) {
+				const auto shift{ i * layout.field_bits };
+				result |= uint64_t{ table[(word >> shift) & mask] } << shift;
+			}
+			m_words[layout.first_word + w] = result;
+		}
+	}
+};
+
+} // namespace gzn::game::magicube
+
+template<class Puzzle>
+struct std::hash<gzn::game::magicube::puzzle_state<Puzzle>> {
+	[[nodiscard]] size_t operator()(const gzn::game::magicube::puzzle_state<Puzzle> &state) const noexcept {
+		return static_cast<size_t>(state.hash());
+	}
+};
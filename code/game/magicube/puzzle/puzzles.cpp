@@ -0,0 +1,29 @@
+#include "game/magicube/puzzle/puzzles.hpp"
+
+#include "game/magicube/cube/move_tables.hpp"
+#include "game/magicube/puzzle/puzzle_state.hpp"
+
+namespace gzn::game::magicube {
+
+namespace {
+
+constexpr bool tables_match_cube_state() noexcept {
+	using state = puzzle_state<puzzles::cube_3x3>;
+	for (size_t m{}; m < move_count; ++m) {
+		for (size_t field{}; field < tables::field_count; ++field) {
+			if (state::move_tables[m][puzzles::cube_3x3::corners][field] != tables::field_moves.corners[m][field]) return false;
+			if (state::move_tables[m][puzzles::cube_3x3::edges][field] != tables::field_moves.edges[m][field]) return false;
+		}
+	}
+	return true;
+}
+
+} // anonymous namespace
+
+static_assert(tables_match_cube_state(), "The engine has to turn the 3x3 like cube_state");
+static_assert(is_valid(puzzle_traits<puzzles::cube_2x2>::definition));
+static_assert(is_valid(puzzle_traits<puzzles::pyraminx>::definition));
+static_assert(is_valid(puzzle_traits<puzzles::skewb>::definition));
+static_assert(is_valid(puzzle_traits<puzzles::megaminx>::definition));
+
+} // namespace gzn::game::magicube
@@ -0,0 +1,224 @@
+#pragma once
+
+#include "game/magicube/cube/cubie.hpp"
+#include "game/magicube/puzzle/puzzle_definition.hpp"
+
+/// @brief The puzzles of the engine. The turns of the cubes come from `cubie_cube`, the others
+/// are generated from the geometry of the solids, pieces in the order of their faces.
+namespace gzn::game::magicube::puzzles {
+
+struct cube_3x3 { enum orbit : size_t { corners, edges }; };
+struct cube_2x2 { enum orbit : size_t { corners }; };
+/// Edges, centres and tips of the vertices U, L, R, B; the faces are opposite the vertices
+struct pyraminx { enum orbit : size_t { edges, centres, tips }; };
+/// Corners in the order of the 3x3, turned around DRB, ULB, DLF and DBL
+struct skewb { enum orbit : size_t { corners, centres }; };
+struct megaminx { enum orbit : size_t { corners, edges }; };
+
+} // namespace gzn::game::magicube::puzzles
+
+namespace gzn::game::magicube {
+
+namespace detail {
+
+/// @brief The quarter turns of `cubie_cube` as seen from the pieces; the 2x2 is the corners alone
+template<size_t Orbits>
+[[nodiscard]] constexpr auto make_cube_definition() noexcept {
+	puzzle_definition<Orbits, face_count, Orbits == 1 ? corner_count : edge_count> definition{};
+	definition.orbits[0] = { corner_count, 3 };
+	if constexpr (Orbits > 1) definition.orbits[1] = { edge_count, 2 };
+	definition.turn_order = 4;
+	definition.names = { "U", "R", "F", "D", "L", "B" };
+
+	for (size_t f{}; f < face_count; ++f) {
+		const auto turn{ face_turn(static_cast<face>(f)) };
+		auto &corners{ definition.turns[f][0] };
+		for (size_t to{}; to < corner_count; ++to) {
+			corners.to[turn.cp[to]] = static_cast<uint8_t>(to);
+			corners.twist[turn.cp[to]] = turn.co[to];
+		}
+		if constexpr (Orbits > 1) {
+			auto &edges{ definition.turns[f][1] };
+			for (size_t to{}; to < edge_count; ++to) {
+				edges.to[turn.ep[to]] = static_cast<uint8_t>(to);
+				edges.twist[turn.ep[to]] = turn.eo[to];
+			}
+		}
+	}
+	return definition;
+}
+
+} // namespace detail
+
+template<>
+struct puzzle_traits<puzzles::cube_3x3> {
+	static constexpr auto definition{ detail::make_cube_definition<2>() };
+};
+
+template<>
+struct puzzle_traits<puzzles::cube_2x2> {
+	static constexpr auto definition{ detail::make_cube_definition<1>() };
+};
+
+template<>
+struct puzzle_traits<puzzles::pyraminx> {
+	static constexpr puzzle_definition<3, 8, 6> definition{
+		{ { { 6, 2 }, { 4, 3 }, { 4, 3 } } },
+		{ {
+			// U
+			{ {
+				orbit_turn<6>{ { 2, 0, 1, 3, 4, 5 }, { 0, 1, 1, 0, 0, 0 } },
+				orbit_turn<6>{ { 0, 1, 2, 3 }, { 2, 0, 0, 0 } },
+				orbit_turn<6>{ { 0, 1, 2, 3 }, { 2, 0, 0, 0 } },
+			} },
+			// L
+			{ {
+				orbit_turn<6>{ { 3, 1, 2, 5, 4, 0 }, { 1, 0, 0, 1, 0, 0 } },
+				orbit_turn<6>{ { 0, 1, 2, 3 }, { 0, 2, 0, 0 } },
+				orbit_turn<6>{ { 0, 1, 2, 3 }, { 0, 2, 0, 0 } },
+			} },
+			// R
+			{ {
+				orbit_turn<6>{ { 0, 4, 2, 1, 3, 5 }, { 0, 0, 0, 1, 1, 0 } },
+				orbit_turn<6>{ { 0, 1, 2, 3 }, { 0, 0, 2, 0 } },
+				orbit_turn<6>{ { 0, 1, 2, 3 }, { 0, 0, 2, 0 } },
+			} },
+			// B
+			{ {
+				orbit_turn<6>{ { 0, 1, 5, 3, 2, 4 }, { 0, 0, 1, 0, 0, 1 } },
+				orbit_turn<6>{ { 0, 1, 2, 3 }, { 0, 0, 0, 2 } },
+				orbit_turn<6>{ { 0, 1, 2, 3 }, { 0, 0, 0, 2 } },
+			} },
+			// u
+			{ {
+				orbit_turn<6>{ { 0, 1, 2, 3, 4, 5 }, { 0, 0, 0, 0, 0, 0 } },
+				orbit_turn<6>{ { 0, 1, 2, 3 }, { 0, 0, 0, 0 } },
+				orbit_turn<6>{ { 0, 1, 2, 3 }, { 2, 0, 0, 0 } },
+			} },
+			// l
+			{ {
+				orbit_turn<6>{ { 0, 1, 2, 3, 4, 5 }, { 0, 0, 0, 0, 0, 0 } },
+				orbit_turn<6>{ { 0, 1, 2, 3 }, { 0, 0, 0, 0 } },
+				orbit_turn<6>{ { 0, 1, 2, 3 }, { 0, 2, 0, 0 } },
+			} },
+			// r
+			{ {
+				orbit_turn<6>{ { 0, 1, 2, 3, 4, 5 }, { 0, 0, 0, 0, 0, 0 } },
+				orbit_turn<6>{ { 0, 1, 2, 3 }, { 0, 0, 0, 0 } },
+				orbit_turn<6>{ { 0, 1, 2, 3 }, { 0, 0, 2, 0 } },
+			} },
+			// b
+			{ {
+				orbit_turn<6>{ { 0, 1, 2, 3, 4, 5 }, { 0, 0, 0, 0, 0, 0 } },
+				orbit_turn<6>{ { 0, 1, 2, 3 }, { 0, 0, 0, 0 } },
+				orbit_turn<6>{ { 0, 1, 2, 3 }, { 0, 0, 0, 2 } },
+			} },
+		} },
+		3,
+		{ { "U", "L", "R", "B", "u", "l", "r", "b" } },
+	};
+};
+
+template<>
+struct puzzle_traits<puzzles::skewb> {
+	static constexpr puzzle_definition<2, 4, 8> definition{
+		{ { { 8, 3 }, { 6, 1 } } },
+		{ {
+			// R
+			{ {
+				orbit_turn<8>{ { 0, 1, 2, 6, 3, 5, 4, 7 }, { 0, 0, 0, 1, 2, 0, 0, 2 } },
+				orbit_turn<8>{ { 0, 5, 2, 1, 4, 3 }, { 0, 0, 0, 0, 0, 0 } },
+			} },
+			// U
+			{ {
+				orbit_turn<8>{ { 0, 6, 2, 1, 4, 5, 3, 7 }, { 0, 1, 2, 1, 0, 0, 1, 0 } },
+				orbit_turn<8>{ { 4, 1, 2, 3, 5, 0 }, { 0, 0, 0, 0, 0, 0 } },
+			} },
+			// L
+			{ {
+				orbit_turn<8>{ { 0, 4, 2, 3, 6, 5, 1, 7 }, { 0, 0, 0, 0, 2, 2, 1, 0 } },
+				orbit_turn<8>{ { 0, 1, 3, 4, 2, 5 }, { 0, 0, 0, 0, 0, 0 } },
+			} },
+			// B
+			{ {
+				orbit_turn<8>{ { 0, 1, 5, 3, 4, 7, 6, 2 }, { 0, 0, 0, 0, 0, 0, 2, 0 } },
+				orbit_turn<8>{ { 0, 1, 2, 5, 3, 4 }, { 0, 0, 0, 0, 0, 0 } },
+			} },
+		} },
+		3,
+		{ { "R", "U", "L", "B" } },
+	};
+};
+
+template<>
+struct puzzle_traits<puzzles::megaminx> {
+	static constexpr puzzle_definition<2, 12, 30> definition{
+		{ { { 20, 3 }, { 30, 2 } } },
+		{ {
+			// U
+			{ {
+				orbit_turn<30>{ { 1, 4, 0, 2, 3, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 } },
+				orbit_turn<30>{ { 4, 0, 1, 2, 3, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 } },
+			} },
+			// F
+			{ {
+				orbit_turn<30>{ { 5, 0, 2, 3, 4, 7, 1, 6, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19 }, { 2, 2, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 } },
+				orbit_turn<30>{ { 5, 1, 2, 3, 4, 7, 0, 8, 6, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29 }, { 1, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 } },
+			} },
+			// R
+			{ {
+				orbit_turn<30>{ { 2, 1, 8, 3, 4, 0, 6, 7, 9, 5, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19 }, { 2, 0, 2, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 } },
+				orbit_turn<30>{ { 0, 9, 2, 3, 4, 1, 6, 7, 8, 11, 5, 10, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29 }, { 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 } },
+			} },
+			// BR
+			{ {
+				orbit_turn<30>{ { 0, 1, 3, 10, 4, 5, 6, 7, 2, 9, 11, 8, 12, 13, 14, 15, 16, 17, 18, 19 }, { 0, 0, 2, 2, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0 } },
+				orbit_turn<30>{ { 0, 1, 12, 3, 4, 5, 6, 7, 8, 2, 10, 11, 14, 9, 13, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29 }, { 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 } },
+			} },
+			// BL
+			{ {
+				orbit_turn<30>{ { 0, 1, 2, 4, 12, 5, 6, 7, 8, 9, 3, 11, 13, 10, 14, 15, 16, 17, 18, 19 }, { 0, 0, 0, 2, 2, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0 } },
+				orbit_turn<30>{ { 0, 1, 2, 15, 4, 5, 6, 7, 8, 9, 10, 11, 3, 13, 14, 17, 12, 16, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29 }, { 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 } },
+			} },
+			// L
+			{ {
+				orbit_turn<30>{ { 0, 6, 2, 3, 1, 5, 14, 7, 8, 9, 10, 11, 4, 13, 12, 15, 16, 17, 18, 19 }, { 0, 0, 0, 0, 2, 0, 2, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0 } },
+				orbit_turn<30>{ { 0, 1, 2, 3, 6, 5, 19, 7, 8, 9, 10, 11, 12, 13, 14, 4, 16, 17, 15, 18, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29 }, { 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 } },
+			} },
+			// DR
+			{ {
+				orbit_turn<30>{ { 0, 1, 2, 3, 4, 9, 6, 5, 8, 15, 10, 11, 12, 13, 14, 16, 7, 17, 18, 19 }, { 0, 0, 0, 0, 0, 0, 0, 2, 0, 2, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0 } },
+				orbit_turn<30>{ { 0, 1, 2, 3, 4, 5, 6, 10, 8, 9, 20, 11, 12, 13, 14, 15, 16, 17, 18, 19, 22, 7, 21, 23, 24, 25, 26, 27, 28, 29 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0 } },
+			} },
+			// DBR
+			{ {
+				orbit_turn<30>{ { 0, 1, 2, 3, 4, 5, 6, 7, 11, 8, 10, 17, 12, 13, 14, 9, 16, 15, 18, 19 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 2, 0, 0, 0, 0, 0, 2, 0, 0 } },
+				orbit_turn<30>{ { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 13, 12, 23, 14, 15, 16, 17, 18, 19, 11, 21, 22, 24, 20, 25, 26, 27, 28, 29 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0 } },
+			} },
+			// B
+			{ {
+				orbit_turn<30>{ { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 13, 10, 12, 18, 14, 15, 16, 11, 17, 19 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 2, 0, 0, 0, 0, 2, 0 } },
+				orbit_turn<30>{ { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 16, 15, 25, 17, 18, 19, 20, 21, 22, 14, 24, 26, 23, 27, 28, 29 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0 } },
+			} },
+			// DBL
+			{ {
+				orbit_turn<30>{ { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 14, 12, 19, 15, 16, 17, 13, 18 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 2, 0, 0, 0, 0, 2 } },
+				orbit_turn<30>{ { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 18, 27, 19, 20, 21, 22, 23, 24, 17, 26, 28, 25, 29 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0 } },
+			} },
+			// DL
+			{ {
+				orbit_turn<30>{ { 0, 1, 2, 3, 4, 5, 7, 16, 8, 9, 10, 11, 12, 13, 6, 15, 19, 17, 18, 14 }, { 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0 } },
+				orbit_turn<30>{ { 0, 1, 2, 3, 4, 5, 6, 7, 21, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 8, 20, 29, 22, 23, 24, 25, 26, 19, 28, 27 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1 } },
+			} },
+			// D
+			{ {
+				orbit_turn<30>{ { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 17, 15, 18, 19, 16 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 1 } },
+				orbit_turn<30>{ { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 24, 23, 26, 25, 28, 27, 29, 22 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 } },
+			} },
+		} },
+		5,
+		{ { "U", "F", "R", "BR", "BL", "L", "DR", "DBR", "B", "DBL", "DL", "D" } },
+	};
+};
+
+} // namespace gzn::game::magicube
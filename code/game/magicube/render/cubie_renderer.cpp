@@ -0,0 +1,266 @@
+#include <string>
+#include <cstddef>
+#include <string_view>
+
+#include <glm/ext/matrix_transform.hpp> // translate, scale
+#include <glbinding/gl/gl.h>
+
+#include "game/magicube/defaults.hpp"
+#include "game/magicube/render/cubie_renderer.hpp"
+
+namespace gzn::game::magicube {
+
+namespace {
+
+using render_clock = std::chrono::steady_clock;
+
+struct cubie_vertex {
+	std::array<float, 3> position;
+	uint32_t face;
+};
+
+/// A frame of `face_frames` in the coordinates of the mesh
+struct cubie_face_frame {
+	glm::vec3 normal;
+	glm::vec3 right;
+	glm::vec3 down;
+};
+
+[[nodiscard]] cubie_face_frame cubie_face_frame_of(const size_t f) noexcept {
+	const auto vector{ [](const std::array<int, 3> &axis) { return glm::vec3(axis[0], axis[1], axis[2]); } };
+	return { vector(face_frames[f].normal), vector(face_frames[f].right), vector(face_frames[f].down) };
+}
+
+/// 6N^2 - 12N + 8: both end layers along x and the ring of every layer between them
+[[nodiscard]] constexpr size_t surface_cubie_count(const size_t size) noexcept {
+	return size < 2 ? size : 2 * size * size + (size - 2) * (4 * size - 4);
+}
+
+/// The index of the surface cell `(x, y, z)` in the order of `surface_cubie_count`
+[[nodiscard]] constexpr size_t surface_cubie_index(const size_t size, const size_t x, const size_t y, const size_t z) noexcept {
+	const auto last{ size - 1 };
+	if (x == 0 || x == last) {
+		return (x == 0 ? 0 : size * size) + y * size + z;
+	}
+	const auto ring_offset{ 2 * size * size + (x - 1) * (4 * size - 4) };
+	if (y == 0 || y == last) {
+		return ring_offset + (y == 0 ? 0 : size) + z;
+	}
+	return ring_offset + 2 * size + (z == 0 ? 0 : size - 2) + y - 1;
+}
+
+constexpr size_t cubie_vertex_count{ face_count * 4 };
+constexpr size_t cubie_index_count{ face_count * 6 };
+
+/// The attribute locations, a matrix takes four of them
+constexpr uint32_t position_location{ 0 };
+constexpr uint32_t face_location{ 1 };
+constexpr uint32_t transform_location{ 2 };
+constexpr uint32_t colors_location{ transform_location + 4 };
+
+constexpr std::string_view cubie_shader_version{ "#version 440 core\n" };
+
+/// `draw_model()` is declared between the version and this
+constexpr std::string_view cubie_vertex_shader_text{ R"glsl(
+	layout (location = 0) in vec3 position;
+	layout (location = 1) in uint face;
+	layout (location = 2) in mat4 transform;
+	layout (location = 6) in uvec3 colors_urf;
+	layout (location = 7) in uvec3 colors_dlb;
+
+	out vec3 fragment_color;
+
+	layout (std140) uniform camera {
+		mat4 view;
+		mat4 projection;
+		mat4 view_projection;
+	};
+
+	// a fixed light, so that the sides of a cubie stand out from each other
+	const float shades[6] = float[6](1.0, 0.85, 0.95, 0.6, 0.8, 0.7);
+
+	void main() {
+		gl_Position = view_projection * draw_model() * transform * vec4(position, 1.0);
+
+		uint color = face < 3u ? colors_urf[face] : colors_dlb[face - 3u];
+		fragment_color = unpackUnorm4x8(color).rgb * shades[face];
+	}
+)glsl" };
+
+constexpr std::string_view cubie_fragment_shader_text{ R"glsl(
+	#version 440 core
+
+	in vec3 fragment_color;
+	out vec4 FragColor;
+
+	void main() {
+		FragColor = vec4(fragment_color, 1.0);
+	}
+)glsl" };
+
+} // anonymous namespace
+
+std::unique_ptr<cubie_renderer> cubie_renderer::create(core::render::program_cache &programs) {
+	std::unique_ptr<cubie_renderer> renderer{ new cubie_renderer{} };
+	if (!renderer->initialize(programs)) {
+		return nullptr;
+	}
+	return renderer;
+}
+
+cubie_renderer::~cubie_renderer() {
+	gl::glDeleteBuffers(1, &m_instance_vbo);
+	gl::glDeleteBuffers(1, &m_mesh_ebo);
+	gl::glDeleteBuffers(1, &m_mesh_vbo);
+	gl::glDeleteVertexArrays(1, &m_vao);
+}
+
+bool cubie_renderer::initialize(core::render::program_cache &programs) {
+	// == == == == == == == == == == SHADERS PROGRAM == == == == == == == == == == //
+
+	// the same choice as the render queue, which asks the same driver
+	const auto draw_parameters{ core::render::render_queue::draw_parameters_supported() };
+	std::string vertex_source{ cubie_shader_version };
+	vertex_source += core::render::render_queue::model_source(draw_parameters);
+	vertex_source += cubie_vertex_shader_text;
+	m_program = programs.load_or_build("cubie", vertex_source, cubie_fragment_shader_text);
+	if (!m_program) {
+		return false;
+	}
+
+	// == == == == == == == == == == ==   MESH    == == == == == == == == == == == //
+
+	// a cube of [-1, 1], its sides scaled down to the cubies by their transforms
+	std::array<cubie_vertex, cubie_vertex_count> vertices{};
+	std::array<uint32_t, cubie_index_count> indices{};
+	for (uint32_t f{}; f < face_count; ++f) {
+		const auto [normal, right, down]{ cubie_face_frame_of(f) };
+		constexpr std::array<std::array<float, 2>, 4> corners{ { { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 } } };
+		for (uint32_t c{}; c < corners.size(); ++c) {
+			const auto corner{ normal + right * corners[c][0] + down * corners[c][1] };
+			vertices[f * 4 + c] = { { corner.x, corner.y, corner.z }, f };
+		}
+		// counterclockwise as seen from the outside, the rows grow down
+		constexpr std::array<uint32_t, 6> quad{ 0, 2, 1, 0, 3, 2 };
+		for (size_t i{}; i < quad.size(); ++i) {
+			indices[f * quad.size() + i] = f * 4 + quad[i];
+		}
+	}
+
+	gl::glGenVertexArrays(1, &m_vao);
+	gl::glGenBuffers(1, &m_mesh_vbo);
+	gl::glGenBuffers(1, &m_mesh_ebo);
+	gl::glGenBuffers(1, &m_instance_vbo);
+
+	gl::glBindVertexArray(m_vao);
+
+	gl::glBindBuffer(gl::GL_ARRAY_BUFFER, m_mesh_vbo);
+	gl::glBufferData(gl::GL_ARRAY_BUFFER, sizeof(vertices), vertices.data(), gl::GL_STATIC_DRAW);
+	gl::glVertexAttribPointer(position_location, 3, gl::GL_FLOAT, gl::GL_FALSE, sizeof(cubie_vertex),
+		reinterpret_cast<const void *>(offsetof(cubie_vertex, position)));
+	gl::glEnableVertexAttribArray(position_location);
+	gl::glVertexAttribIPointer(face_location, 1, gl::GL_UNSIGNED_INT, sizeof(cubie_vertex),
+		reinterpret_cast<const void *>(offsetof(cubie_vertex, face)));
+	gl::glEnableVertexAttribArray(face_location);
+
+	gl::glBindBuffer(gl::GL_ELEMENT_ARRAY_BUFFER, m_mesh_ebo);
+	gl::glBufferData(gl::GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices.data(), gl::GL_STATIC_DRAW);
+
+	// the instances are uploaded by the first draw, once the size of the cube is known
+	gl::glBindBuffer(gl::GL_ARRAY_BUFFER, m_instance_vbo);
+	for (uint32_t column{}; column < 4; ++column) {
+		gl::glVertexAttribPointer(transform_location + column, 4, gl::GL_FLOAT, gl::GL_FALSE, sizeof(cubie_instance),
+			reinterpret_cast<const void *>(offsetof(cubie_instance, transform) + column * sizeof(glm::vec4)));
+		gl::glEnableVertexAttribArray(transform_location + column);
+		gl::glVertexAttribDivisor(transform_location + column, 1);
+	}
+	for (uint32_t half{}; half < 2; ++half) {
+		gl::glVertexAttribIPointer(colors_location + half, 3, gl::GL_UNSIGNED_INT, sizeof(cubie_instance),
+			reinterpret_cast<const void *>(offsetof(cubie_instance, colors) + half * 3 * sizeof(uint32_t)));
+		gl::glEnableVertexAttribArray(colors_location + half);
+		gl::glVertexAttribDivisor(colors_location + half, 1);
+	}
+
+	gl::glBindVertexArray(0);
+	return true;
+}
+
+void cubie_renderer::assign(const big_cube &cube) {
+	assign(cube.size(), [&cube](const face f, const size_t row, const size_t column) {
+		return cube.at(f, row, column);
+	});
+}
+
+void cubie_renderer::assign(const facelet_cube &cube) {
+	assign(3, [&cube](const face f, const size_t row, const size_t column) {
+		return cube.at(static_cast<size_t>(f) * facelets_per_face + row * 3 + column);
+	});
+}
+
+template<class StickerGetter>
+void cubie_renderer::assign(const size_t size, StickerGetter &&sticker) {
+	// the lattice counts half cells from the centre, so the cubies sit on the odd points of an
+	// even size and the even points of an odd one
+	const auto side{ static_cast<int32_t>(size) };
+	const auto cell_of{ [side](const int32_t lattice) { return static_cast<size_t>((lattice + side - 1) / 2); } };
+	const auto scale{ defaults::render::cubie_fill / static_cast<float>(size) };
+
+	// every cubie is rewritten, only the capacity survives a change of the cube
+	m_instances.resize(surface_cubie_count(size));
+	for (auto &cubie : m_instances) {
+		cubie.colors.fill(defaults::render::plastic_color);
+	}
+	for (size_t f{}; f < face_count; ++f) {
+		const auto [normal, right, down]{ cubie_face_frame_of(f) };
+		for (size_t row{}; row < size; ++row) {
+			for (size_t column{}; column < size; ++column) {
+				const auto across{ static_cast<float>(2 * static_cast<int32_t>(column) - side + 1) };
+				const auto below{ static_cast<float>(2 * static_cast<int32_t>(row) - side + 1) };
+				const auto centre{ normal * static_cast<float>(side - 1) + right * across + down * below };
+				auto &cubie{ m_instances[surface_cubie_index(size, cell_of(static_cast<int32_t>(centre.x)),
+					cell_of(static_cast<int32_t>(centre.y)), cell_of(static_cast<int32_t>(centre.z)))] };
+
+				// a corner is reached from three faces and an edge from two, each writes the same transform
+				cubie.transform = glm::scale(glm::translate(glm::mat4x4{ 1.0f }, centre / static_cast<float>(side)), glm::vec3{ scale });
+				const auto color{ static_cast<size_t>(sticker(static_cast<face>(f), row, column)) };
+				cubie.colors[f] = defaults::render::sticker_colors[color];
+			}
+		}
+	}
+	m_dirty = true;
+}
+
+void cubie_renderer::draw(core::render::render_queue &queue, const glm::mat4x4 &model, const float depth) {
+	const auto start{ render_clock::now() };
+	render_stats stats{};
+
+	if (m_dirty) {
+		const auto bytes{ m_instances.size() * sizeof(cubie_instance) };
+		gl::glBindBuffer(gl::GL_ARRAY_BUFFER, m_instance_vbo);
+		if (m_instances.size() > m_capacity) {
+			gl::glBufferData(gl::GL_ARRAY_BUFFER, static_cast<gl::GLsizeiptr>(bytes), m_instances.data(), gl::GL_DYNAMIC_DRAW);
+			m_capacity = m_instances.size();
+		} else {
+			gl::glBufferSubData(gl::GL_ARRAY_BUFFER, 0, static_cast<gl::GLsizeiptr>(bytes), m_instances.data());
+		}
+		stats.uploaded = bytes;
+		m_dirty = false;
+	}
+
+	if (!m_instances.empty()) {
+		core::render::draw_item item{};
+		item.shader = &*m_program;
+		item.vao = m_vao;
+		item.depth = depth;
+		item.model = model;
+		item.index_count = static_cast<uint32_t>(cubie_index_count);
+		item.instance_count = static_cast<uint32_t>(m_instances.size());
+		queue.submit(item);
+		stats.instances = item.instance_count;
+	}
+
+	stats.submit_time = render_clock::now() - start;
+	m_last_frame = stats;
+}
+
+} // namespace gzn::game::magicube
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <optional>
+#include <cinttypes>
+#include <glm/mat4x4.hpp>
+#include <core/render/program.hpp>
+#include <core/render/program_cache.hpp>
+#include <core/render/render_queue.hpp>
+
+#include "game/magicube/cube/big_cube.hpp"
+#include "game/magicube/cube/facelet_cube.hpp"
+
+namespace gzn::game::magicube {
+
+/// @brief What one frame cost the CPU, the draw itself is counted by the render queue
+struct render_stats {
+	uint32_t instances{};
+	/// Bytes of the instance buffer uploaded, 0 when the cube didn't change
+	size_t uploaded{};
+	std::chrono::nanoseconds submit_time{};
+};
+
+/// @brief One shared mesh of a cubie drawn once per cubie of the surface in a single
+/// instanced draw item. Every instance carries its transform and the colors of its six sides,
+/// so the draw calls don't grow with the cube. The instances are uploaded only when the cube
+/// changes, the model of the cube goes with the draw item, see `render_queue::model_source`.
+class cubie_renderer {
+public:
+	struct cubie_instance {
+		/// In the cube, the model of the draw is applied by the shader
+		glm::mat4x4 transform;
+		/// 0xAABBGGRR in the order of the faces, the inner sides are the plastic
+		std::array<uint32_t, face_count> colors;
+	};
+
+	/// @returns nullptr if the program fails to compile or to link
+	/// @note The camera comes from the `core::render::camera_buffer` block
+	[[nodiscard]] static std::unique_ptr<cubie_renderer> create(core::render::program_cache &programs);
+
+	~cubie_renderer();
+
+	cubie_renderer(const cubie_renderer &other) = delete;
+	cubie_renderer &operator=(const cubie_renderer &other) = delete;
+
+	/// @brief The cubies of @p cube, uploaded by the next draw
+	void assign(const big_cube &cube);
+	void assign(const facelet_cube &cube);
+
+	/// @brief Uploads the instances if the cube changed and submits their draw to @p queue
+	/// @param depth Of the cube in the view, 0 at the camera and 1 at the far plane
+	void draw(core::render::render_queue &queue, const glm::mat4x4 &model, const float depth);
+
+	[[nodiscard]] const render_stats &last_frame() const noexcept { return m_last_frame; }
+
+private:
+	std::optional<core::render::program> m_program;
+	uint32_t m_vao{};
+	uint32_t m_mesh_vbo{};
+	uint32_t m_mesh_ebo{};
+	uint32_t m_instance_vbo{};
+
+	std::vector<cubie_instance> m_instances;
+	/// Instances the buffer holds, it's reallocated only to grow
+	size_t m_capacity{};
+	bool m_dirty{ false };
+	render_stats m_last_frame{};
+
+	cubie_renderer() = default;
+
+	[[nodiscard]] bool initialize(core::render::program_cache &programs);
+
+	template<class StickerGetter>
+	void assign(const size_t size, StickerGetter &&sticker);
+};
+
+} // namespace gzn::game::magicube
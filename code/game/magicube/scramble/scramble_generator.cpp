@@ -0,0 +1,298 @@
+#include <array>
+#include <cstdio>
+#include <string>
+#include <memory>
+#include <utility>
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <core/tools/task_pool.hpp>
+
+#if defined(_WIN32)
+	#include <io.h>
+	#include <fcntl.h>
+#endif
+
+#include "game/magicube/cube/notation.hpp"
+#include "game/magicube/scramble/scramble_generator.hpp"
+
+namespace gzn::game::magicube {
+
+namespace {
+
+using scramble_clock = std::chrono::steady_clock;
+
+/// Scrambles generated by one task
+constexpr uint64_t scramble_chunk_size{ 256 };
+/// Chunks per thread generated before they're written, which bounds the memory
+constexpr size_t chunks_per_thread{ 4 };
+constexpr uint32_t packed_move_bits{ 5 };
+
+struct scramble_chunk {
+	std::vector<uint8_t> bytes;
+	uint64_t failed{};
+};
+
+struct scramble_file_closer {
+	void operator()(std::FILE *file) const noexcept { std::fclose(file); }
+};
+
+} // anonymous namespace
+
+cubie_cube random_cubies(core::tools::philox4x32 &random) noexcept {
+	cubie_cube cube;
+	const auto shuffle{ [&random](auto &values) {
+		for (auto i{ static_cast<uint32_t>(values.size()) - 1 }; i > 0; --i) {
+			std::swap(values[i], values[random.below(i + 1)]);
+		}
+	} };
+	shuffle(cube.cp);
+	shuffle(cube.ep);
+	// swapping two edges is a bijection between the odd and the even permutations
+	if (odd_permutation(cube.cp) != odd_permutation(cube.ep)) {
+		std::swap(cube.ep[0], cube.ep[1]);
+	}
+
+	uint32_t twist{};
+	for (size_t i{}; i + 1 < corner_count; ++i) {
+		cube.co[i] = static_cast<uint8_t>(random.below(3));
+		twist += cube.co[i];
+	}
+	cube.co[corner_count - 1] = static_cast<uint8_t>((3 - twist % 3) % 3);
+
+	const auto flips{ random() };
+	uint32_t flip{};
+	for (size_t i{}; i + 1 < edge_count; ++i) {
+		cube.eo[i] = static_cast<uint8_t>((flips >> i) & 1u);
+		flip += cube.eo[i];
+	}
+	cube.eo[edge_count - 1] = static_cast<uint8_t>(flip % 2);
+	return cube;
+}
+
+cube_state random_scramble_state(const uint64_t seed, const uint64_t index) noexcept {
+	core::tools::philox4x32 random{ seed, index };
+	for (;;) {
+		const auto state{ cube_state::from_cubies(random_cubies(random)) };
+		bool near{ state.solved() };
+		for (size_t m{}; m < move_count && !near; ++m) {
+			near = state.moved(static_cast<move>(m)).solved();
+		}
+		if (!near) {
+			return state;
+		}
+	}
+}
+
+void pack_scramble(const move_sequence &moves, std::vector<uint8_t> &output) {
+	const auto length{ std::min<size_t>(moves.size(), 255) };
+	const auto start{ output.size() };
+	output.resize(start + packed_scramble_size(length));
+	output[start] = static_cast<uint8_t>(length);
+	for (size_t i{}; i < length; ++i) {
+		const auto bit{ i * packed_move_bits };
+		const auto value{ static_cast<uint32_t>(moves[i]) << (bit % 8) };
+		output[start + 1 + bit / 8] |= static_cast<uint8_t>(value);
+		if (bit % 8 + packed_move_bits > 8) {
+			output[start + 2 + bit / 8] |= static_cast<uint8_t>(value >> 8);
+		}
+	}
+}
+
+size_t unpack_scramble(const uint8_t *data, const size_t size, move_sequence &moves) {
+	if (size == 0 || size < packed_scramble_size(data[0])) {
+		return 0;
+	}
+	const size_t length{ data[0] };
+	moves.resize(length);
+	for (size_t i{}; i < length; ++i) {
+		const auto bit{ i * packed_move_bits };
+		uint32_t value{ data[1 + bit / 8] };
+		if (bit % 8 + packed_move_bits > 8) {
+			value |= uint32_t{ data[2 + bit / 8] } << 8;
+		}
+		value = (value >> (bit % 8)) & ((1u << packed_move_bits) - 1);
+		if (value >= move_count) {
+			return 0;
+		}
+		moves[i] = static_cast<move>(value);
+	}
+	return packed_scramble_size(length);
+}
+
+//===== scramble_options =====//
+
+std::optional<scramble_options> scramble_options::parse(const int argc, const char *const *argv) {
+	scramble_options options;
+	for (int i{}; i < argc; ++i) {
+		const std::string_view argument{ argv[i] };
+		const bool has_value{ i + 1 < argc };
+		const std::string_view value{ has_value ? argv[i + 1] : "" };
+		const auto number{ [&value] { return std::strtoull(std::string{ value }.c_str(), nullptr, 10); } };
+
+		if (argument == "--text") {
+			options.text = true;
+			continue;
+		}
+		if (argument == "--count" && has_value) {
+			options.count = number();
+		} else if (argument == "--seed" && has_value) {
+			options.seed = number();
+		} else if (argument == "--first" && has_value) {
+			options.first = number();
+		} else if (argument == "--output" && has_value) {
+			options.output = value;
+		} else if (argument == "--tables" && has_value) {
+			options.tables_path = value;
+		} else if (argument == "--threads" && has_value) {
+			options.threads = number();
+		} else if (argument == "--report" && has_value) {
+			options.report_interval = std::chrono::seconds{ std::max<unsigned long long>(1, number()) };
+		} else if (argument == "--length" && has_value) {
+			options.solver.target_length = static_cast<uint8_t>(std::min<unsigned long long>(number(), 30));
+		} else {
+			spdlog::error("[scramble_options::parse] Unexpected argument '{}'\n{}", argument, usage());
+			return std::nullopt;
+		}
+		++i;
+	}
+	return options;
+}
+
+std::string_view scramble_options::usage() noexcept {
+	return "Usage: magicube --scramble [options]\n"
+		"  --count <count>     Scrambles to generate, 1000 by default\n"
+		"  --seed <number>     The same seed gives the same scrambles, 0 by default\n"
+		"  --first <index>     The index of the first scramble of the seed, 0 by default\n"
+		"  --output <path>     The standard output by default\n"
+		"  --text              One scramble per line instead of the binary records\n"
+		"  --tables <path>     Two-phase tables, generated when missing\n"
+		"  --threads <count>   0 (default) uses every hardware thread\n"
+		"  --report <seconds>  Progress report interval, 10 by default\n"
+		"  --length <moves>    Stop at the first solution this short, 21 by default\n";
+}
+
+//===== scramble_generator =====//
+
+scramble_generator::scramble_generator(const scramble_options &options)
+	: m_options{ options } {}
+
+std::optional<move_sequence> scramble_generator::scramble(const two_phase_solver &solver,
+	const cube_state &state, const two_phase_options &options) {
+	auto moves{ solver.solve(state, options) };
+	if (moves) {
+		std::reverse(moves->begin(), moves->end());
+		for (auto &m : *moves) {
+			m = inverse(m);
+		}
+	}
+	return moves;
+}
+
+int scramble_generator::run() {
+	std::unique_ptr<std::FILE, scramble_file_closer> output_file;
+	std::FILE *output{ stdout };
+	if (!m_options.output.empty() && m_options.output != "-") {
+		output_file.reset(std::fopen(m_options.output.string().c_str(), "wb"));
+		if (!output_file) {
+			spdlog::error("[scramble_generator::run] Failed to open '{}'", m_options.output.string());
+			return EXIT_FAILURE;
+		}
+		output = output_file.get();
+	} else {
+		// the scrambles own the standard output
+		spdlog::set_default_logger(spdlog::stderr_color_mt("scramble"));
+#if defined(_WIN32)
+		// the CRT would write every 0x0A byte of the records as 0x0D 0x0A
+		if (!m_options.text && _setmode(_fileno(stdout), _O_BINARY) == -1) {
+			spdlog::error("[scramble_generator::run] Failed to switch the standard output to binary");
+			return EXIT_FAILURE;
+		}
+#endif
+	}
+
+	const auto tables{ two_phase_tables::load_or_generate(m_options.tables_path) };
+	if (!tables) {
+		return EXIT_FAILURE;
+	}
+	const two_phase_solver solver{ tables };
+
+	if (!m_options.text) {
+		const scramble_file_header header{ scramble_file_header::file_magic, scramble_file_header::file_version,
+			m_options.seed, m_options.first, m_options.count };
+		if (std::fwrite(&header, sizeof(header), 1, output) != 1) {
+			spdlog::error("[scramble_generator::run] Failed to write the header");
+			return EXIT_FAILURE;
+		}
+	}
+
+	core::tools::task_pool pool{ m_options.threads };
+	spdlog::info("[scramble_generator::run] Generating {} scrambles of the seed {} from {} on {} threads",
+		m_options.count, m_options.seed, m_options.first, pool.size());
+
+	const auto start{ scramble_clock::now() };
+	auto next_report{ start + m_options.report_interval };
+	std::vector<scramble_chunk> chunks(pool.size() * chunks_per_thread);
+	uint64_t written{};
+	uint64_t failed{};
+	uint64_t bytes{};
+	while (written < m_options.count) {
+		const auto round_first{ written };
+		size_t round_chunks{};
+		core::tools::task_group round;
+		for (; round_chunks < chunks.size(); ++round_chunks) {
+			const auto first{ round_first + round_chunks * scramble_chunk_size };
+			if (first >= m_options.count) break;
+			const auto count{ std::min(scramble_chunk_size, m_options.count - first) };
+
+			pool.submit(round, [this, &solver, &chunk = chunks[round_chunks], first, count] {
+				chunk.bytes.clear();
+				chunk.failed = 0;
+				std::array<char, 30 * max_turn_length> line;
+				for (auto index{ first }; index < first + count; ++index) {
+					const auto state{ random_scramble_state(m_options.seed, m_options.first + index) };
+					const auto scramble{ scramble_generator::scramble(solver, state, m_options.solver) };
+					chunk.failed += !scramble;
+					if (!m_options.text) {
+						// a record of no moves is a state which wasn't solved
+						pack_scramble(scramble.value_or(move_sequence{}), chunk.bytes);
+						continue;
+					}
+					const auto length{ scramble
+						? format_notation(scramble->data(), scramble->size(), line.data(), line.size())
+						: fmt::format_to_n(line.data(), line.size(), "# no solution").size };
+					chunk.bytes.insert(chunk.bytes.end(), line.data(), line.data() + std::min(length, line.size()));
+					chunk.bytes.push_back('\n');
+				}
+			});
+		}
+		pool.wait(round);
+
+		for (size_t i{}; i < round_chunks; ++i) {
+			// a full disk or a closed pipe, the header would claim records which aren't there
+			if (std::fwrite(chunks[i].bytes.data(), 1, chunks[i].bytes.size(), output) != chunks[i].bytes.size()) {
+				spdlog::error("[scramble_generator::run] Failed to write the scrambles after {} bytes", bytes);
+				return EXIT_FAILURE;
+			}
+			failed += chunks[i].failed;
+			bytes += chunks[i].bytes.size();
+		}
+		written = std::min(m_options.count, round_first + round_chunks * scramble_chunk_size);
+
+		if (const auto now{ scramble_clock::now() }; now >= next_report || written == m_options.count) {
+			const std::chrono::duration<double> elapsed{ now - start };
+			spdlog::info("[scramble_generator::run] {} {} of {} scrambles, {:.1f}/s, {} bytes, {} not solved",
+				written == m_options.count ? "Done:" : "Progress:", written, m_options.count,
+				static_cast<double>(written) / std::max(elapsed.count(), 1e-9), bytes, failed);
+			next_report = now + m_options.report_interval;
+		}
+	}
+	if (std::fflush(output) != 0 || std::ferror(output) != 0) {
+		spdlog::error("[scramble_generator::run] Failed to write the last scrambles");
+		return EXIT_FAILURE;
+	}
+	return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+} // namespace gzn::game::magicube
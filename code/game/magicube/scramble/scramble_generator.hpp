@@ -0,0 +1,90 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+#include <optional>
+#include <cinttypes>
+#include <filesystem>
+#include <string_view>
+
+#include <core/tools/philox.hpp>
+
+#include "game/magicube/defaults.hpp"
+#include "game/magicube/cube/cube_state.hpp"
+#include "game/magicube/solver/two_phase_solver.hpp"
+
+namespace gzn::game::magicube {
+
+/// @brief A state drawn uniformly from the 43252003274489856000 reachable ones: any permutation
+/// of the corners, an edge permutation of the same parity, the last twist and the last flip
+/// following the others
+[[nodiscard]] cubie_cube random_cubies(core::tools::philox4x32 &random) noexcept;
+
+/// @brief The state of the scramble @p index of @p seed. It's drawn from its own stream, so
+/// it's the same whatever thread draws it and whichever scrambles are drawn before it. The
+/// states a move or less away from solved are drawn again, as the WCA scrambles do.
+[[nodiscard]] cube_state random_scramble_state(const uint64_t seed, const uint64_t index) noexcept;
+
+/// @brief A record of the binary output: the length in a byte, then the moves 5 bits each,
+/// the first one in the low bits of the first byte
+[[nodiscard]] constexpr size_t packed_scramble_size(const size_t length) noexcept {
+	return 1 + (length * 5 + 7) / 8;
+}
+/// @brief Appends the record of @p moves, which are 255 at most, to @p output
+void pack_scramble(const move_sequence &moves, std::vector<uint8_t> &output);
+/// @returns The size of the record read from @p data, 0 if it's cut or holds no valid moves
+[[nodiscard]] size_t unpack_scramble(const uint8_t *data, const size_t size, move_sequence &moves);
+
+/// @brief The binary output starts with this header, followed by `count` records
+struct scramble_file_header {
+	static constexpr uint32_t file_magic{ 0x5243534D }; // "MSCR"
+	static constexpr uint32_t file_version{ 1 };
+
+	uint32_t magic{ file_magic };
+	uint32_t version{ file_version };
+	uint64_t seed{};
+	/// The index of the first scramble, so that runs over parts of a seed can be joined
+	uint64_t first{};
+	uint64_t count{};
+};
+static_assert(sizeof(scramble_file_header) == 32);
+
+struct scramble_options {
+	uint64_t count{ 1000 };
+	uint64_t seed{ 0 };
+	uint64_t first{ 0 };
+	/// Empty or "-" writes to the standard output
+	std::filesystem::path output{};
+	/// One scramble in the notation per line instead of the binary records
+	bool text{ false };
+	std::filesystem::path tables_path{ defaults::solver::two_phase_tables_path };
+	/// 0 means every hardware thread
+	size_t threads{ 0 };
+	std::chrono::seconds report_interval{ 10 };
+	/// A timeout makes the scrambles depend on the speed of the machine; a long one is never hit
+	two_phase_options solver{ defaults::scramble::random_state_length, 30, defaults::scramble::random_state_timeout };
+
+	/// @brief Parses the arguments which follow `--scramble`
+	[[nodiscard]] static std::optional<scramble_options> parse(const int argc, const char *const *argv);
+	[[nodiscard]] static std::string_view usage() noexcept;
+};
+
+/// @brief Writes random-state scrambles without any window: every state is solved with the
+/// two-phase algorithm and the scramble is the solution undone. The scrambles are generated in
+/// chunks on a thread pool and written in the order of their indices.
+class scramble_generator {
+public:
+	explicit scramble_generator(const scramble_options &options);
+
+	/// @brief The scramble of @p state, the inverse of its solution
+	[[nodiscard]] static std::optional<move_sequence> scramble(const two_phase_solver &solver,
+		const cube_state &state, const two_phase_options &options);
+
+	/// @returns The exit code: 0 when every scramble was written
+	[[nodiscard]] int run();
+
+private:
+	scramble_options m_options;
+};
+
+} // namespace gzn::game::magicube
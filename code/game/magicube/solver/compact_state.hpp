@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cinttypes>
+
+#include "game/magicube/cube/cube_state.hpp"
+
+namespace gzn::game::magicube {
+
+/// @brief Unpacked twin of `cube_state` for the search hot loops: one byte per cubie holding the
+/// same field as `cube_state` does. Pattern database indices are computed straight from the
+/// bytes without extracting the fields from the packed words.
+struct compact_state {
+	std::array<uint8_t, corner_count> corners;
+	std::array<uint8_t, edge_count> edges;
+
+	[[nodiscard]] static compact_state from(const cube_state &state) noexcept {
+		compact_state result;
+		for (size_t i{}; i < corner_count; ++i) {
+			result.corners[i] = static_cast<uint8_t>((state.corners() >> (i * cube_state::field_bits)) & cube_state::field_mask);
+		}
+		for (size_t i{}; i < edge_count; ++i) {
+			result.edges[i] = static_cast<uint8_t>((state.edges() >> (i * cube_state::field_bits)) & cube_state::field_mask);
+		}
+		return result;
+	}
+
+	[[nodiscard]] cube_state packed() const noexcept {
+		uint64_t packed_corners{};
+		for (size_t i{}; i < corner_count; ++i) {
+			packed_corners |= uint64_t{ corners[i] } << (i * cube_state::field_bits);
+		}
+		uint64_t packed_edges{};
+		for (size_t i{}; i < edge_count; ++i) {
+			packed_edges |= uint64_t{ edges[i] } << (i * cube_state::field_bits);
+		}
+		return cube_state::from_fields(packed_corners, packed_edges);
+	}
+
+	void apply(const move m) noexcept {
+		const auto &corner_moves{ cube_state::corner_moves(m) };
+		for (auto &field : corners) field = corner_moves[field];
+
+		const auto &edge_moves{ cube_state::edge_moves(m) };
+		for (auto &field : edges) field = edge_moves[field];
+	}
+
+	[[nodiscard]] compact_state moved(const move m) const noexcept {
+		auto result{ *this };
+		result.apply(m);
+		return result;
+	}
+
+	[[nodiscard]] bool solved() const noexcept {
+		for (size_t i{}; i < corner_count; ++i) {
+			if (corners[i] != i) return false;
+		}
+		for (size_t i{}; i < edge_count; ++i) {
+			if (edges[i] != i) return false;
+		}
+		return true;
+	}
+};
+
+} // namespace gzn::game::magicube
@@ -0,0 +1,147 @@
+#include <array>
+
+#include "game/magicube/solver/coordinates.hpp"
+
+namespace gzn::game::magicube::coordinates {
+
+namespace {
+
+constexpr uint8_t first_slice_edge{ static_cast<uint8_t>(edge::FR) };
+
+constexpr uint32_t binomial(const uint32_t n, const uint32_t k) noexcept {
+	if (k > n) return 0;
+	uint32_t result{ 1 };
+	for (uint32_t i{}; i < k; ++i) {
+		result = result * (n - i) / (i + 1);
+	}
+	return result;
+}
+
+/// Lehmer code of the permutation, the identity is 0. Only the relative order matters.
+template<size_t Size>
+uint16_t rank(const uint8_t *values) noexcept {
+	uint32_t result{};
+	for (size_t i{}; i < Size; ++i) {
+		uint32_t smaller{};
+		for (size_t j{ i + 1 }; j < Size; ++j) {
+			smaller += values[j] < values[i];
+		}
+		result = result * static_cast<uint32_t>(Size - i) + smaller;
+	}
+	return static_cast<uint16_t>(result);
+}
+
+/// Permutation of the values [offset, offset + Size) by its Lehmer code
+template<size_t Size>
+void unrank(uint8_t *values, uint32_t value, const uint8_t offset = 0) noexcept {
+	std::array<uint8_t, Size> digits{};
+	for (size_t i{ Size }; i-- > 0;) {
+		digits[i] = static_cast<uint8_t>(value % (Size - i));
+		value /= static_cast<uint32_t>(Size - i);
+	}
+
+	std::array<uint8_t, Size> unused{};
+	for (size_t i{}; i < Size; ++i) {
+		unused[i] = static_cast<uint8_t>(i);
+	}
+	size_t unused_count{ Size };
+	for (size_t i{}; i < Size; ++i) {
+		values[i] = static_cast<uint8_t>(unused[digits[i]] + offset);
+		for (size_t j{ digits[i] }; j + 1 < unused_count; ++j) {
+			unused[j] = unused[j + 1];
+		}
+		--unused_count;
+	}
+}
+
+} // anonymous namespace
+
+uint16_t twist(const cubie_cube &cube) noexcept {
+	uint16_t result{};
+	for (size_t i{}; i + 1 < corner_count; ++i) {
+		result = static_cast<uint16_t>(3 * result + cube.co[i]);
+	}
+	return result;
+}
+
+uint16_t flip(const cubie_cube &cube) noexcept {
+	uint16_t result{};
+	for (size_t i{}; i + 1 < edge_count; ++i) {
+		result = static_cast<uint16_t>(2 * result + cube.eo[i]);
+	}
+	return result;
+}
+
+uint16_t slice(const cubie_cube &cube) noexcept {
+	uint32_t result{};
+	uint32_t found{};
+	for (size_t j{ edge_count }; j-- > 0;) {
+		if (cube.ep[j] >= first_slice_edge) {
+			result += binomial(static_cast<uint32_t>(edge_count - 1 - j), ++found);
+		}
+	}
+	return static_cast<uint16_t>(result);
+}
+
+uint16_t corner_permutation(const cubie_cube &cube) noexcept {
+	return rank<corner_count>(cube.cp.data());
+}
+
+uint16_t ud_edge_permutation(const cubie_cube &cube) noexcept {
+	return rank<8>(cube.ep.data());
+}
+
+uint16_t slice_permutation(const cubie_cube &cube) noexcept {
+	return rank<4>(cube.ep.data() + first_slice_edge);
+}
+
+void set_twist(cubie_cube &cube, uint16_t value) noexcept {
+	uint32_t sum{};
+	for (size_t i{ corner_count - 1 }; i-- > 0;) {
+		cube.co[i] = static_cast<uint8_t>(value % 3);
+		sum += cube.co[i];
+		value /= 3;
+	}
+	cube.co[corner_count - 1] = static_cast<uint8_t>((3 - sum % 3) % 3);
+}
+
+void set_flip(cubie_cube &cube, uint16_t value) noexcept {
+	uint32_t sum{};
+	for (size_t i{ edge_count - 1 }; i-- > 0;) {
+		cube.eo[i] = static_cast<uint8_t>(value & 1);
+		sum += cube.eo[i];
+		value >>= 1;
+	}
+	cube.eo[edge_count - 1] = static_cast<uint8_t>(sum & 1);
+}
+
+void set_slice(cubie_cube &cube, uint16_t value) noexcept {
+	uint32_t left{ value };
+	uint32_t remaining{ 4 };
+	uint8_t next_slice{ first_slice_edge };
+	uint8_t next_other{ 0 };
+	for (size_t j{}; j < edge_count; ++j) {
+		const auto count{ binomial(static_cast<uint32_t>(edge_count - 1 - j), remaining) };
+		if (remaining > 0 && left >= count) {
+			left -= count;
+			--remaining;
+			cube.ep[j] = next_slice++;
+		} else {
+			cube.ep[j] = next_other++;
+		}
+	}
+}
+
+void set_corner_permutation(cubie_cube &cube, uint16_t value) noexcept {
+	unrank<corner_count>(cube.cp.data(), value);
+}
+
+void set_ud_edge_permutation(cubie_cube &cube, uint16_t value) noexcept {
+	unrank<8>(cube.ep.data(), value);
+}
+
+void set_slice_permutation(cubie_cube &cube, uint16_t value) noexcept {
+	unrank<4>(cube.ep.data() + first_slice_edge, value, first_slice_edge);
+}
+
+} // namespace gzn::game::magicube::coordinates
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cinttypes>
+
+#include "game/magicube/cube/cubie.hpp"
+
+namespace gzn::game::magicube::coordinates {
+
+// Phase 1: the cube is brought into the <U, D, R2, L2, F2, B2> subgroup
+constexpr uint32_t twist_count{ 2187 };  // 3^7 corner orientations
+constexpr uint32_t flip_count{ 2048 };   // 2^11 edge orientations
+constexpr uint32_t slice_count{ 495 };   // C(12, 4) locations of the FR, FL, BL, BR edges
+
+// Phase 2: only the permutations are left
+constexpr uint32_t corner_permutation_count{ 40320 };  // 8!
+constexpr uint32_t ud_edge_permutation_count{ 40320 }; // 8! of the U and D layer edges
+constexpr uint32_t slice_permutation_count{ 24 };      // 4! of the slice edges
+
+[[nodiscard]] uint16_t twist(const cubie_cube &cube) noexcept;
+[[nodiscard]] uint16_t flip(const cubie_cube &cube) noexcept;
+[[nodiscard]] uint16_t slice(const cubie_cube &cube) noexcept;
+[[nodiscard]] uint16_t corner_permutation(const cubie_cube &cube) noexcept;
+
+/// @warning Defined only when the slice edges are in the slice (i.e. `slice(cube) == 0`)
+[[nodiscard]] uint16_t ud_edge_permutation(const cubie_cube &cube) noexcept;
+/// @warning Defined only when the slice edges are in the slice (i.e. `slice(cube) == 0`)
+[[nodiscard]] uint16_t slice_permutation(const cubie_cube &cube) noexcept;
+
+void set_twist(cubie_cube &cube, uint16_t value) noexcept;
+void set_flip(cubie_cube &cube, uint16_t value) noexcept;
+/// @brief Places the slice edges (and the rest of the edges) in their natural order
+void set_slice(cubie_cube &cube, uint16_t value) noexcept;
+void set_corner_permutation(cubie_cube &cube, uint16_t value) noexcept;
+void set_ud_edge_permutation(cubie_cube &cube, uint16_t value) noexcept;
+void set_slice_permutation(cubie_cube &cube, uint16_t value) noexcept;
+
+} // namespace gzn::game::magicube::coordinates
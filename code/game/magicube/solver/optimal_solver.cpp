@@ -0,0 +1,359 @@
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+#include <core/tools/bits.hpp>
+
+#include "game/magicube/solver/optimal_solver.hpp"
+
+namespace gzn::game::magicube {
+
+namespace {
+
+constexpr size_t max_optimal_length{ 26 };
+constexpr size_t max_databases{ 8 };
+
+/// The exact distance for every database. A mod-3 database needs the distance of the parent.
+using pattern_distances = std::array<uint8_t, max_databases>;
+
+/// Nodes closer to the leaves are cheaper to search again than to look up
+constexpr uint8_t min_cached_budget{ 7 };
+
+/// The tree is cut into tasks at this depth, a few thousand subtrees for the worker threads
+constexpr size_t split_depth{ 3 };
+
+/// Nodes searched between two looks at the clock
+constexpr uint32_t deadline_check_interval{ 4096 };
+
+/// The timeout and the cancel flag of `optimal_options`, shared by the workers of one solve
+class search_limit {
+public:
+	explicit search_limit(const optimal_options &options) noexcept
+		: m_cancel{ options.cancel }
+		, m_deadline{ options.timeout.count() > 0 ? std::chrono::steady_clock::now() + options.timeout
+			: std::chrono::steady_clock::time_point::max() } {}
+
+	/// @returns true once the search was cancelled or has run out of time, and ever after
+	bool reached() const noexcept {
+		if (m_reached.load(std::memory_order_relaxed)) return true;
+		const bool cancelled{ m_cancel != nullptr && m_cancel->load(std::memory_order_relaxed) };
+		if (cancelled || std::chrono::steady_clock::now() > m_deadline) {
+			m_reached.store(true, std::memory_order_relaxed);
+			return true;
+		}
+		return false;
+	}
+
+private:
+	const std::atomic<bool> *m_cancel{ nullptr };
+	const std::chrono::steady_clock::time_point m_deadline;
+	mutable std::atomic<bool> m_reached{ false };
+};
+
+/// A node at `split_depth`, the root of one parallel subtree
+struct search_task {
+	compact_state state;
+	pattern_distances distances{};
+	std::array<move, split_depth> moves{};
+};
+
+class optimal_search {
+public:
+	optimal_search(const std::vector<pattern_database> &databases, search_statistics &statistics,
+		transposition_table *table, const search_limit &limit, const std::atomic<bool> *stop = nullptr) noexcept
+		: m_databases{ databases }, m_statistics{ statistics }, m_table{ table }, m_limit{ limit }, m_stop{ stop } {
+		m_statistics.patterns.assign(databases.size(), pattern_statistics{});
+	}
+
+	/// @returns true when there is a solution of @p bound moves or less
+	bool run(const compact_state &state, const pattern_distances &distances, const uint8_t bound) {
+		return search(state, distances, 0, bound);
+	}
+
+	/// @brief Searches the subtree of @p task
+	bool run(const search_task &task, const uint8_t bound) {
+		std::copy(task.moves.begin(), task.moves.end(), m_moves.begin());
+		return search(task.state, task.distances, split_depth, bound);
+	}
+
+	/// @brief Every node at `split_depth` which is within @p bound
+	void split(const compact_state &state, const pattern_distances &distances, const uint8_t bound,
+		std::vector<search_task> &tasks, const size_t depth = 0) {
+		if (depth == split_depth) {
+			auto &task{ tasks.emplace_back() };
+			task.state = state;
+			task.distances = distances;
+			std::copy(m_moves.begin(), m_moves.begin() + split_depth, task.moves.begin());
+			return;
+		}
+		++m_statistics.nodes;
+		expand(state, distances, depth, bound, [&](const compact_state &next, const pattern_distances &next_distances) {
+			split(next, next_distances, bound, tasks, depth + 1);
+			return false;
+		});
+	}
+
+	[[nodiscard]] move_sequence solution() const {
+		return move_sequence{ m_moves.begin(), m_moves.begin() + m_length };
+	}
+
+	[[nodiscard]] pattern_distances root_distances(const compact_state &state) const noexcept {
+		pattern_distances distances{};
+		for (size_t i{}; i < m_databases.size(); ++i) {
+			distances[i] = m_databases[i].distance(state);
+		}
+		return distances;
+	}
+
+	[[nodiscard]] uint8_t estimate(const pattern_distances &distances) const noexcept {
+		return *std::max_element(distances.begin(), distances.begin() + m_databases.size());
+	}
+
+private:
+	const std::vector<pattern_database> &m_databases;
+	search_statistics &m_statistics;
+	transposition_table *m_table{ nullptr };
+	const search_limit &m_limit;
+	const std::atomic<bool> *m_stop{ nullptr };
+	bool m_limited{ false };
+	std::array<move, max_optimal_length> m_moves{};
+	size_t m_length{};
+
+	/// @brief Once it's true, it stays true, so that no unfinished subtree gets into the table
+	[[nodiscard]] bool stopped() noexcept {
+		if (!m_limited && m_statistics.nodes % deadline_check_interval == 0) {
+			m_limited = m_limit.reached();
+		}
+		return m_limited || (m_stop != nullptr && m_stop->load(std::memory_order_relaxed));
+	}
+
+	/// @returns false when one of the databases puts @p state beyond @p budget
+	bool lookup(const compact_state &state, const pattern_distances &parent,
+		const uint8_t budget, pattern_distances &distances) noexcept {
+		for (size_t i{}; i < m_databases.size(); ++i) {
+			auto &statistics{ m_statistics.patterns[i] };
+			++statistics.lookups;
+
+			distances[i] = m_databases[i].distance(state, parent[i]);
+			if (distances[i] > budget) {
+				++statistics.cutoffs;
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/// @brief Calls @p visit for every child within the bound until it returns true
+	template<class Visit>
+	bool expand(const compact_state &state, const pattern_distances &distances,
+		const size_t depth, const uint8_t bound, Visit &&visit) {
+		const auto budget{ static_cast<uint8_t>(bound - depth - 1) };
+		const auto last{ depth > 0 ? static_cast<size_t>(face_of(m_moves[depth - 1])) : face_count };
+		for (auto moves{ canonical_successors(last) }; moves != 0; moves &= moves - 1) {
+			const auto m{ static_cast<move>(core::tools::count_trailing_zeros(moves)) };
+			const auto next{ state.moved(m) };
+			pattern_distances next_distances;
+			if (!lookup(next, distances, budget, next_distances)) continue;
+
+			m_moves[depth] = m;
+			if (visit(next, next_distances)) return true;
+		}
+		return false;
+	}
+
+	bool search(const compact_state &state, const pattern_distances &distances,
+		const size_t depth, const uint8_t bound) {
+		++m_statistics.nodes;
+		// a shorter solution is accepted too, so a failed search proves a lower bound
+		if (estimate(distances) == 0 && state.solved()) {
+			m_length = depth;
+			return true;
+		}
+		// another worker has found a solution of this length already, or the time is over
+		if (depth == bound || stopped()) return false;
+
+		const auto budget{ static_cast<uint8_t>(bound - depth) };
+		const bool cached{ m_table != nullptr && budget >= min_cached_budget };
+		cube_state packed;
+		uint8_t context{ transposition_table::no_context };
+		if (cached) {
+			packed = state.packed();
+			if (depth > 0) {
+				context = static_cast<uint8_t>(face_of(m_moves[depth - 1]));
+			}
+			if (m_table->lower_bound(packed, context) > budget) return false;
+		}
+
+		const bool found{ expand(state, distances, depth, bound, [&](const compact_state &next, const pattern_distances &next_distances) {
+			return search(next, next_distances, depth + 1, bound);
+		}) };
+		if (!found && cached && !stopped()) {
+			m_table->store(packed, context, static_cast<uint8_t>(budget + 1));
+		}
+		return found;
+	}
+};
+
+void merge(search_statistics &to, const search_statistics &from) noexcept {
+	to.nodes += from.nodes;
+	for (size_t i{}; i < from.patterns.size(); ++i) {
+		to.patterns[i].lookups += from.patterns[i].lookups;
+		to.patterns[i].cutoffs += from.patterns[i].cutoffs;
+	}
+}
+
+} // anonymous namespace
+
+std::vector<optimal_solver::database_file> optimal_solver::standard_databases() {
+	return {
+		database_file{ "corners.pdb", pattern_layout::corners() },
+		database_file{ "edges_low.pdb", pattern_layout::edges(edge::UR, 6) },
+		database_file{ "edges_high.pdb", pattern_layout::edges(edge::DL, 6) },
+	};
+}
+
+optimal_solver::optimal_solver(std::vector<pattern_database> &&databases, const size_t threads,
+	const size_t transposition_mib)
+	: m_databases{ std::move(databases) }
+	, m_pool{ threads == 1 ? nullptr : std::make_unique<core::tools::task_pool>(threads) }
+	, m_table{ transposition_mib == 0 ? nullptr : transposition_table::create(transposition_mib) } {}
+
+std::optional<optimal_solver> optimal_solver::open(const std::filesystem::path &directory, const size_t threads,
+	const size_t transposition_mib) {
+	std::vector<pattern_database> databases;
+	for (const auto &[name, layout] : standard_databases()) {
+		auto database{ pattern_database::open(directory / name) };
+		if (!database) {
+			spdlog::error("[optimal_solver::open] Failed to open '{}'", (directory / name).string());
+			return std::nullopt;
+		}
+		if (database->layout() != layout) {
+			spdlog::error("[optimal_solver::open] '{}' has unexpected layout", (directory / name).string());
+			return std::nullopt;
+		}
+		databases.push_back(std::move(*database));
+	}
+	return optimal_solver{ std::move(databases), threads, transposition_mib };
+}
+
+bool optimal_solver::generate(const std::filesystem::path &directory, const pattern_generator_options &options) {
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+	if (error) {
+		spdlog::error("[optimal_solver::generate] Failed to create '{}': {}", directory.string(), error.message());
+		return false;
+	}
+
+	for (const auto &[name, layout] : standard_databases()) {
+		const auto path{ directory / name };
+		if (std::filesystem::exists(path)) {
+			if (const auto database{ pattern_database::open(path) }; database && database->layout() == layout) {
+				spdlog::info("[optimal_solver::generate] '{}' is complete already", path.string());
+				continue;
+			}
+			spdlog::warn("[optimal_solver::generate] Generating '{}' again", path.string());
+		}
+
+		if (!pattern_generator{ layout, options }.run(path)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+optimal_result optimal_solver::solve(const cube_state &state, const optimal_options &options) const {
+	using clock = std::chrono::steady_clock;
+	const auto start{ clock::now() };
+
+	optimal_result result;
+	if (m_databases.empty() || m_databases.size() > max_databases) {
+		spdlog::error("[optimal_solver::solve] Expected 1 to {} databases, got {}", max_databases, m_databases.size());
+		return result;
+	}
+	// the databases give a finite estimate to an unsolvable state too, and every bound up to
+	// `max_length` would be searched in full
+	if (!is_solvable(state.to_cubies())) {
+		spdlog::warn("[optimal_solver::solve] The cube state isn't solvable");
+		return result;
+	}
+	const search_limit limit{ options };
+	optimal_search search{ m_databases, result.statistics, m_table.get(), limit };
+	const auto transpositions{ m_table ? m_table->statistics() : transposition_statistics{} };
+
+	const auto compact{ compact_state::from(state) };
+	const auto distances{ search.root_distances(compact) };
+	const auto max_bound{ std::min<size_t>(options.max_length, max_optimal_length - 1) };
+	for (uint8_t bound{ search.estimate(distances) }; bound <= max_bound && !result.solution; ++bound) {
+		if (limit.reached()) {
+			result.interrupted = true;
+			break;
+		}
+		if (!m_pool || bound <= split_depth) {
+			if (search.run(compact, distances, bound)) {
+				result.solution = search.solution();
+			}
+			continue;
+		}
+
+		std::vector<search_task> tasks;
+		search.split(compact, distances, bound, tasks);
+		result.statistics.tasks += tasks.size();
+
+		std::atomic<bool> found{ false };
+		std::mutex mutex;
+		core::tools::task_group iteration;
+		for (const auto &task : tasks) {
+			m_pool->submit(iteration, [&, bound] {
+				if (found.load(std::memory_order_relaxed) || limit.reached()) return;
+
+				search_statistics statistics;
+				optimal_search worker{ m_databases, statistics, m_table.get(), limit, &found };
+				const bool solved{ worker.run(task, bound) };
+
+				std::lock_guard lock{ mutex };
+				merge(result.statistics, statistics);
+				if (solved && !result.solution) {
+					result.solution = worker.solution();
+					found.store(true, std::memory_order_relaxed);
+				}
+			});
+		}
+		m_pool->wait(iteration);
+	}
+	// the last bound was cut short
+	if (!result.solution && limit.reached()) {
+		result.interrupted = true;
+	}
+	result.statistics.elapsed = clock::now() - start;
+	if (m_table) {
+		const auto total{ m_table->statistics() };
+		auto &solve{ result.statistics.transpositions };
+		solve.hits = total.hits - transpositions.hits;
+		solve.misses = total.misses - transpositions.misses;
+		solve.collisions = total.collisions - transpositions.collisions;
+		solve.stores = total.stores - transpositions.stores;
+	}
+
+	const auto &statistics{ result.statistics };
+	spdlog::info("[optimal_solver::solve] {} in {:.3f} s: {} nodes, {:.2f} M nodes/s, {} tasks on {} threads",
+		result.solution ? fmt::format("{} moves", result.solution->size())
+			: result.interrupted ? "interrupted" : "no solution",
+		statistics.elapsed.count(), statistics.nodes, statistics.nodes_per_second() / 1e6,
+		statistics.tasks, m_pool ? m_pool->size() : 1);
+	for (size_t i{}; i < statistics.patterns.size(); ++i) {
+		const auto &pattern{ statistics.patterns[i] };
+		spdlog::info("[optimal_solver::solve]    Database #{}: {:>14} lookups, {:>14} cutoffs ({:.1f}%)",
+			i, pattern.lookups, pattern.cutoffs,
+			pattern.lookups > 0 ? 100.0 * static_cast<double>(pattern.cutoffs) / static_cast<double>(pattern.lookups) : 0.0);
+	}
+	if (m_table) {
+		const auto &table{ statistics.transpositions };
+		spdlog::info("[optimal_solver::solve]    Transpositions: {:>10} hits, {:>14} misses ({:.1f}%), "
+			"{} stores, {} collisions", table.hits, table.misses, 100.0 * table.hit_rate(), table.stores, table.collisions);
+	}
+	return result;
+}
+
+} // namespace gzn::game::magicube
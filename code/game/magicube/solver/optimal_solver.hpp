@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <optional>
+#include <filesystem>
+
+#include <core/tools/task_pool.hpp>
+
+#include "game/magicube/defaults.hpp"
+#include "game/magicube/cube/cube_state.hpp"
+#include "game/magicube/solver/pattern_database.hpp"
+#include "game/magicube/solver/pattern_generator.hpp"
+#include "game/magicube/solver/transposition_table.hpp"
+
+namespace gzn::game::magicube {
+
+struct pattern_statistics {
+	uint64_t lookups{};
+	/// How many times this database alone proved that a node exceeds the bound
+	uint64_t cutoffs{};
+};
+
+struct search_statistics {
+	uint64_t nodes{};
+	/// Subtrees searched by the thread pool
+	uint64_t tasks{};
+	transposition_statistics transpositions{};
+	std::chrono::duration<double> elapsed{};
+	std::vector<pattern_statistics> patterns;
+
+	[[nodiscard]] double nodes_per_second() const noexcept {
+		return elapsed.count() > 0.0 ? static_cast<double>(nodes) / elapsed.count() : 0.0;
+	}
+};
+
+struct optimal_options {
+	uint8_t max_length{ 20 };
+	/// The search gives up when it runs out, zero lets it run until it is done
+	std::chrono::milliseconds timeout{};
+	/// Another thread sets it to stop the search early, like the timeout does
+	const std::atomic<bool> *cancel{ nullptr };
+};
+
+struct optimal_result {
+	std::optional<move_sequence> solution;
+	/// Cancelled or out of time before a solution was found or ruled out
+	bool interrupted{ false };
+	search_statistics statistics;
+};
+
+/// @brief IDA* with the maximum of pattern database distances as the heuristic. It finds the
+/// shortest solution in the face turn metric. Each iteration is cut into subtrees a few moves
+/// deep which the workers of a work-stealing pool search until one of them finds a solution.
+class optimal_solver {
+public:
+	struct database_file {
+		std::string_view name;
+		pattern_layout layout;
+	};
+
+	/// @brief Corners and two halves of the edges (Korf's layout)
+	[[nodiscard]] static std::vector<database_file> standard_databases();
+
+	/// @param threads Workers of the search, 0 means every hardware thread
+	/// @param transposition_mib Size of the transposition table shared by the workers, 0 disables it
+	explicit optimal_solver(std::vector<pattern_database> &&databases, const size_t threads = 0,
+		const size_t transposition_mib = defaults::solver::transposition_table_mib);
+
+	/// @brief Maps every database of `standard_databases()` from @p directory
+	[[nodiscard]] static std::optional<optimal_solver> open(
+		const std::filesystem::path &directory = defaults::solver::pattern_databases_path, const size_t threads = 0,
+		const size_t transposition_mib = defaults::solver::transposition_table_mib);
+	/// @brief Generates the files of `standard_databases()` missing in @p directory, the complete
+	/// ones of the right layout are kept
+	[[nodiscard]] static bool generate(
+		const std::filesystem::path &directory = defaults::solver::pattern_databases_path,
+		const pattern_generator_options &options = {});
+
+	[[nodiscard]] optimal_result solve(const cube_state &state, const optimal_options &options = {}) const;
+
+	[[nodiscard]] const std::vector<pattern_database> &databases() const noexcept { return m_databases; }
+
+private:
+	std::vector<pattern_database> m_databases;
+	std::unique_ptr<core::tools::task_pool> m_pool;
+	/// Lower bounds stay true for every scramble, so the table lives as long as the solver
+	std::unique_ptr<transposition_table> m_table;
+};
+
+} // namespace gzn::game::magicube
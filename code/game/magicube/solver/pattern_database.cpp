@@ -0,0 +1,226 @@
+#include <cstring>
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+#include <core/tools/bits.hpp>
+
+#include "game/magicube/solver/pattern_database.hpp"
+#include "game/magicube/solver/pattern_generator.hpp"
+
+namespace gzn::game::magicube {
+
+//========================================= PATTERN LAYOUT =========================================//
+
+pattern_layout::pattern_layout(const pattern_pieces pieces, const uint8_t first, const uint8_t count) noexcept
+	: m_pieces{ pieces }, m_count{ count } {
+	const uint64_t n{ positions() };
+	for (uint8_t i{}; i < m_count; ++i) {
+		m_tracked[i] = static_cast<uint8_t>(first + i);
+
+		// (n - 1 - i)! / (n - count)!
+		uint64_t weight{ 1 };
+		for (uint64_t j{ n - m_count + 1 }; j <= n - 1 - i; ++j) {
+			weight *= j;
+		}
+		m_weights[i] = weight;
+	}
+
+	// when every piece is tracked, the orientation of the last one follows from the others
+	m_orientation_digits = m_count == n ? m_count - 1u : m_count;
+	for (uint32_t i{}; i < m_orientation_digits; ++i) {
+		m_orientation_count *= orientations();
+	}
+}
+
+pattern_layout pattern_layout::corners() noexcept {
+	return pattern_layout{ pattern_pieces::corners, 0, static_cast<uint8_t>(corner_count) };
+}
+
+pattern_layout pattern_layout::edges(const edge first, const uint8_t count) noexcept {
+	const auto start{ static_cast<uint8_t>(first) };
+	return pattern_layout{ pattern_pieces::edges, start, std::min<uint8_t>(count, static_cast<uint8_t>(edge_count - start)) };
+}
+
+uint64_t pattern_layout::size() const noexcept {
+	return m_count == 0 ? 1 : positions() * m_weights[0] * m_orientation_count;
+}
+
+uint64_t pattern_layout::index(const compact_state &state) const noexcept {
+	const auto *source{ m_pieces == pattern_pieces::corners ? state.corners.data() : state.edges.data() };
+	std::array<uint8_t, max_pieces> tracked_fields;
+	for (size_t i{}; i < m_count; ++i) {
+		tracked_fields[i] = source[m_tracked[i]];
+	}
+	return index(tracked_fields.data());
+}
+
+uint64_t pattern_layout::index(const uint8_t *fields) const noexcept {
+	const auto mask{ position_mask() };
+	const auto shift{ orientation_shift() };
+
+	uint64_t permutation{};
+	uint64_t orientation{};
+	uint32_t used{};
+	for (size_t i{}; i < m_count; ++i) {
+		const auto position{ static_cast<uint32_t>(fields[i] & mask) };
+		const auto smaller{ core::tools::popcount(used & ((1u << position) - 1)) };
+		permutation += (position - smaller) * m_weights[i];
+		used |= 1u << position;
+
+		if (i < m_orientation_digits) {
+			orientation = orientation * orientations() + (fields[i] >> shift);
+		}
+	}
+	return permutation * m_orientation_count + orientation;
+}
+
+void pattern_layout::fields(uint64_t index, uint8_t *fields) const noexcept {
+	const auto shift{ orientation_shift() };
+	const auto base{ orientations() };
+
+	uint64_t orientation{ index % m_orientation_count };
+	uint64_t permutation{ index / m_orientation_count };
+
+	std::array<uint8_t, max_pieces> twists{};
+	uint32_t sum{};
+	for (size_t i{ m_orientation_digits }; i-- > 0;) {
+		twists[i] = static_cast<uint8_t>(orientation % base);
+		sum += twists[i];
+		orientation /= base;
+	}
+	if (m_orientation_digits < m_count) {
+		twists[m_count - 1] = static_cast<uint8_t>((base - sum % base) % base);
+	}
+
+	uint32_t used{};
+	for (size_t i{}; i < m_count; ++i) {
+		auto skip{ permutation / m_weights[i] };
+		permutation %= m_weights[i];
+
+		uint32_t free_positions{ ~used };
+		while (skip-- > 0) {
+			free_positions &= free_positions - 1;
+		}
+		const auto position{ core::tools::count_trailing_zeros(free_positions) };
+		used |= 1u << position;
+		fields[i] = static_cast<uint8_t>((twists[i] << shift) | position);
+	}
+}
+
+void pattern_layout::move_fields(const uint8_t *fields, const move m, uint8_t *result) const noexcept {
+	const auto &table{ m_pieces == pattern_pieces::corners ? cube_state::corner_moves(m) : cube_state::edge_moves(m) };
+	for (size_t i{}; i < m_count; ++i) {
+		result[i] = table[fields[i]];
+	}
+}
+
+uint64_t pattern_layout::goal() const noexcept {
+	// solved pieces are at their own positions without twist, so the field is the piece itself
+	return index(m_tracked.data());
+}
+
+bool pattern_layout::operator==(const pattern_layout &other) const noexcept {
+	return m_pieces == other.m_pieces && m_count == other.m_count && m_tracked == other.m_tracked;
+}
+
+//====================================== PATTERN FILE HEADER =======================================//
+
+pattern_file_header pattern_file_header::make(const pattern_layout &layout, const pattern_encoding encoding) noexcept {
+	pattern_file_header header;
+	header.pieces = static_cast<uint8_t>(layout.pieces());
+	header.count = layout.count();
+	header.encoding = encoding;
+	for (size_t i{}; i < layout.count(); ++i) {
+		header.tracked[i] = layout.piece(i);
+	}
+	header.entries = layout.size();
+	return header;
+}
+
+std::optional<pattern_layout> pattern_file_header::layout() const noexcept {
+	if (magic != file_magic || version != file_version || pieces > static_cast<uint8_t>(pattern_pieces::edges)
+		|| encoding > pattern_encoding::mod3 || count == 0 || count > pattern_layout::max_pieces) {
+		return std::nullopt;
+	}
+
+	const auto result{ pieces == static_cast<uint8_t>(pattern_pieces::corners)
+		? pattern_layout::corners()
+		: pattern_layout::edges(static_cast<edge>(tracked[0]), count) };
+	const auto expected{ make(result, encoding) };
+	if (expected.tracked != tracked || expected.entries != entries) {
+		return std::nullopt;
+	}
+	return result;
+}
+
+//======================================== PATTERN DATABASE ========================================//
+
+pattern_database::pattern_database(core::tools::mapped_file &&file, const pattern_layout &layout,
+	const pattern_encoding encoding) noexcept
+	: m_file{ std::move(file) }
+	, m_distances{ reinterpret_cast<const uint8_t *>(m_file.data() + sizeof(pattern_file_header)) }
+	, m_layout{ layout }
+	, m_encoding{ encoding } {}
+
+std::optional<pattern_database> pattern_database::open(const std::filesystem::path &path) {
+	auto file{ core::tools::mapped_file::open(path) };
+	if (!file) {
+		return std::nullopt;
+	}
+	if (file->size() < sizeof(pattern_file_header)) {
+		spdlog::error("[pattern_database::open] '{}' is too small", path.string());
+		return std::nullopt;
+	}
+
+	pattern_file_header header;
+	std::memcpy(&header, file->data(), sizeof(header));
+	const auto layout{ header.layout() };
+	if (!layout) {
+		spdlog::error("[pattern_database::open] '{}' isn't a pattern database of version {} or its layout is unsupported",
+			path.string(), pattern_file_header::file_version);
+		return std::nullopt;
+	}
+	if (file->size() < sizeof(header) + pattern_packing::bytes(header.encoding, header.entries)) {
+		spdlog::error("[pattern_database::open] '{}' is truncated", path.string());
+		return std::nullopt;
+	}
+
+	return pattern_database{ std::move(*file), *layout, header.encoding };
+}
+
+bool pattern_database::generate(const pattern_layout &layout, const std::filesystem::path &path,
+	const pattern_encoding encoding) {
+	pattern_generator_options options;
+	options.encoding = encoding;
+	return pattern_generator{ layout, options }.run(path);
+}
+
+uint8_t pattern_database::distance(const compact_state &state) const noexcept {
+	if (m_encoding == pattern_encoding::nibble) {
+		return raw(m_layout.index(state));
+	}
+
+	// there's always a neighbour one move closer to the goal until the goal is reached
+	const auto goal{ m_layout.goal() };
+	auto current{ state };
+	uint8_t distance{};
+	for (auto index{ m_layout.index(current) }; index != goal; ++distance) {
+		const auto closer{ static_cast<uint8_t>((raw(index) + 2) % 3) };
+		bool stepped{ false };
+		for (size_t m{}; m < move_count && !stepped; ++m) {
+			const auto neighbour{ current.moved(static_cast<move>(m)) };
+			if (const auto next{ m_layout.index(neighbour) }; raw(next) == closer) {
+				current = neighbour;
+				index = next;
+				stepped = true;
+			}
+		}
+		if (!stepped) {
+			spdlog::error("[pattern_database::distance] The database is corrupted: no way to the goal");
+			break;
+		}
+	}
+	return distance;
+}
+
+} // namespace gzn::game::magicube
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <array>
+#include <optional>
+#include <cinttypes>
+#include <filesystem>
+
+#include <core/tools/mapped_file.hpp>
+
+#include "game/magicube/solver/compact_state.hpp"
+
+namespace gzn::game::magicube {
+
+enum class pattern_pieces : uint8_t { corners, edges };
+
+/// @brief A subset of the cubies of one kind. Only their locations and orientations are kept,
+/// which maps every cube state onto an index of the pattern database.
+class pattern_layout {
+public:
+	static constexpr size_t max_pieces{ edge_count };
+
+	[[nodiscard]] static pattern_layout corners() noexcept;
+	/// @brief Tracks @p count edges starting from @p first
+	[[nodiscard]] static pattern_layout edges(const edge first, const uint8_t count) noexcept;
+
+	[[nodiscard]] pattern_pieces pieces() const noexcept { return m_pieces; }
+	[[nodiscard]] uint8_t count() const noexcept { return m_count; }
+	[[nodiscard]] uint8_t piece(const size_t index) const noexcept { return m_tracked[index]; }
+
+	[[nodiscard]] uint8_t positions() const noexcept {
+		return static_cast<uint8_t>(m_pieces == pattern_pieces::corners ? corner_count : edge_count);
+	}
+	[[nodiscard]] uint8_t orientations() const noexcept { return m_pieces == pattern_pieces::corners ? 3 : 2; }
+
+	/// @brief Number of the pattern states
+	[[nodiscard]] uint64_t size() const noexcept;
+
+	[[nodiscard]] uint64_t index(const compact_state &state) const noexcept;
+	/// @param fields The fields of the tracked pieces, `count()` of them
+	[[nodiscard]] uint64_t index(const uint8_t *fields) const noexcept;
+	/// @brief The fields of the tracked pieces for the pattern @p index
+	void fields(uint64_t index, uint8_t *fields) const noexcept;
+	/// @brief Applies @p m to the fields of the tracked pieces
+	void move_fields(const uint8_t *fields, const move m, uint8_t *result) const noexcept;
+
+	/// @brief Index of the solved pattern
+	[[nodiscard]] uint64_t goal() const noexcept;
+
+	[[nodiscard]] bool operator==(const pattern_layout &other) const noexcept;
+	[[nodiscard]] bool operator!=(const pattern_layout &other) const noexcept { return !(*this == other); }
+
+private:
+	pattern_pieces m_pieces{ pattern_pieces::corners };
+	uint8_t m_count{};
+	std::array<uint8_t, max_pieces> m_tracked{};
+
+	/// m_weights[i] is the number of arrangements of the pieces after i-th
+	std::array<uint64_t, max_pieces> m_weights{};
+	uint32_t m_orientation_digits{};
+	uint64_t m_orientation_count{ 1 };
+
+	pattern_layout(const pattern_pieces pieces, const uint8_t first, const uint8_t count) noexcept;
+
+	[[nodiscard]] uint8_t position_mask() const noexcept { return m_pieces == pattern_pieces::corners ? 0x07 : 0x0F; }
+	[[nodiscard]] uint8_t orientation_shift() const noexcept { return m_pieces == pattern_pieces::corners ? 3 : 4; }
+};
+
+/// @brief How the distances are packed
+enum class pattern_encoding : uint8_t {
+	nibble, ///< The exact distance in 4 bits
+	mod3,   ///< The distance modulo 3 in 2 bits. Neighbours differ by one move at most,
+	        ///< so the exact value follows from the distance of the parent
+};
+
+namespace pattern_packing {
+
+constexpr uint8_t unknown_nibble{ 0x0F };
+constexpr uint8_t unknown_mod3{ 0x03 };
+
+[[nodiscard]] constexpr uint64_t bytes(const pattern_encoding encoding, const uint64_t entries) noexcept {
+	return encoding == pattern_encoding::nibble ? (entries + 1) / 2 : (entries + 3) / 4;
+}
+
+[[nodiscard]] inline uint8_t get(const uint8_t *data, const pattern_encoding encoding, const uint64_t index) noexcept {
+	return encoding == pattern_encoding::nibble
+		? (data[index >> 1] >> ((index & 1) << 2)) & 0x0F
+		: (data[index >> 2] >> ((index & 3) << 1)) & 0x03;
+}
+
+inline void set(uint8_t *data, const pattern_encoding encoding, const uint64_t index, const uint8_t value) noexcept {
+	if (encoding == pattern_encoding::nibble) {
+		const auto shift{ (index & 1) << 2 };
+		data[index >> 1] = static_cast<uint8_t>((data[index >> 1] & ~(0x0F << shift)) | (value << shift));
+	} else {
+		const auto shift{ (index & 3) << 1 };
+		data[index >> 2] = static_cast<uint8_t>((data[index >> 2] & ~(0x03 << shift)) | ((value % 3) << shift));
+	}
+}
+
+} // namespace pattern_packing
+
+/// @brief The header of a pattern database file, followed by the packed distances
+struct pattern_file_header {
+	static constexpr uint32_t file_magic{ 0x4244504D }; // "MPDB"
+	static constexpr uint32_t file_version{ 1 };
+
+	uint32_t magic{ file_magic };
+	uint32_t version{ file_version };
+	uint8_t pieces{};
+	uint8_t count{};
+	pattern_encoding encoding{ pattern_encoding::nibble };
+	uint8_t reserved_flags{};
+	std::array<uint8_t, pattern_layout::max_pieces> tracked{};
+	uint64_t entries{};
+	uint8_t reserved[32]{};
+
+	[[nodiscard]] static pattern_file_header make(const pattern_layout &layout, const pattern_encoding encoding) noexcept;
+
+	/// @returns The layout when the header is valid
+	[[nodiscard]] std::optional<pattern_layout> layout() const noexcept;
+};
+static_assert(sizeof(pattern_file_header) == 64);
+
+/// @brief Distances to the solved pattern, mapped straight from the disk
+class pattern_database {
+public:
+	[[nodiscard]] static std::optional<pattern_database> open(const std::filesystem::path &path);
+
+	/// @brief Generates the database with all the hardware threads. Takes minutes for large layouts.
+	[[nodiscard]] static bool generate(const pattern_layout &layout, const std::filesystem::path &path,
+		const pattern_encoding encoding = pattern_encoding::nibble);
+
+	/// @brief Exact distance of @p state. For mod-3 databases it's found by descending to the goal,
+	/// so it's meant for the root of a search only.
+	[[nodiscard]] uint8_t distance(const compact_state &state) const noexcept;
+
+	/// @brief Exact distance of @p state which is one move away from a state at @p parent_distance
+	[[nodiscard]] uint8_t distance(const compact_state &state, const uint8_t parent_distance) const noexcept {
+		const auto value{ raw(m_layout.index(state)) };
+		if (m_encoding == pattern_encoding::nibble) {
+			return value;
+		}
+		// 0: the same distance, 1: one more, 2: one less
+		const auto difference{ (value + 3 - parent_distance % 3) % 3 };
+		return static_cast<uint8_t>(parent_distance + (difference == 2 ? -1 : difference));
+	}
+
+	[[nodiscard]] uint8_t raw(const uint64_t index) const noexcept {
+		return pattern_packing::get(m_distances, m_encoding, index);
+	}
+
+	[[nodiscard]] const pattern_layout &layout() const noexcept { return m_layout; }
+	[[nodiscard]] pattern_encoding encoding() const noexcept { return m_encoding; }
+
+private:
+	core::tools::mapped_file m_file;
+	const uint8_t *m_distances{ nullptr };
+	pattern_layout m_layout;
+	pattern_encoding m_encoding;
+
+	pattern_database(core::tools::mapped_file &&file, const pattern_layout &layout,
+		const pattern_encoding encoding) noexcept;
+};
+
+} // namespace gzn::game::magicube
@@ -0,0 +1,290 @@
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <fstream>
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+#include <core/tools/bits.hpp>
+
+#include "game/magicube/solver/pattern_generator.hpp"
+
+namespace gzn::game::magicube {
+
+namespace {
+
+constexpr uint64_t bits_per_word{ 64 };
+
+struct checkpoint_header {
+	static constexpr uint32_t file_magic{ 0x4344504D }; // "MPDC"
+	static constexpr uint32_t file_version{ 1 };
+
+	uint32_t magic{ file_magic };
+	uint32_t version{ file_version };
+	pattern_file_header pattern{};
+	uint64_t done{};
+	uint64_t frontier_size{};
+	uint8_t depth{};
+	uint8_t reserved[7]{};
+};
+
+template<class T>
+bool write_array(std::ofstream &file, const T *data, const size_t count) {
+	return static_cast<bool>(file.write(reinterpret_cast<const char *>(data),
+		static_cast<std::streamsize>(count * sizeof(T))));
+}
+
+template<class T>
+bool read_array(std::ifstream &file, T *data, const size_t count) {
+	return static_cast<bool>(file.read(reinterpret_cast<char *>(data),
+		static_cast<std::streamsize>(count * sizeof(T))));
+}
+
+std::filesystem::path checkpoint_path(const std::filesystem::path &output) {
+	auto path{ output };
+	return path.concat(".checkpoint");
+}
+
+} // anonymous namespace
+
+pattern_generator::pattern_generator(const pattern_layout &layout, const pattern_generator_options &options)
+	: m_layout{ layout }
+	, m_options{ options }
+	, m_size{ layout.size() }
+	, m_words{ (layout.size() + bits_per_word - 1) / bits_per_word } {
+	if (m_options.threads == 0) {
+		m_options.threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	m_options.chunk_words = std::max<size_t>(1, m_options.chunk_words);
+}
+
+bool pattern_generator::run(const std::filesystem::path &output) {
+	using clock = std::chrono::steady_clock;
+	const auto start{ clock::now() };
+	const auto checkpoint{ checkpoint_path(output) };
+
+	if (!(m_options.resume && load_checkpoint(checkpoint))) {
+		reset();
+	}
+	spdlog::info("[pattern_generator::run] {} states, {} threads, {} encoding, starting at depth {}",
+		m_size, m_options.threads, m_options.encoding == pattern_encoding::nibble ? "nibble" : "mod-3", m_depth);
+
+	while (m_done < m_size && m_frontier_size > 0) {
+		const auto depth_start{ clock::now() };
+		const auto unvisited{ m_size - m_done };
+		const bool backward{ unvisited < m_frontier_size };
+
+		const auto processed{ backward
+			? parallel([this](const uint64_t first, const uint64_t last) { return expand_backward(first, last); })
+			: parallel([this](const uint64_t first, const uint64_t last) { return expand_forward(first, last); }) };
+		m_frontier_size = parallel([this](const uint64_t first, const uint64_t last) { return commit(first, last); });
+		m_done += m_frontier_size;
+		++m_depth;
+
+		const std::chrono::duration<double> elapsed{ clock::now() - depth_start };
+		spdlog::info("[pattern_generator::run] Depth {:>2}: {:>12} new, {:>12} of {} done, "
+			"{} {} states in {:.2f} s ({:.2f} M states/s)",
+			m_depth, m_frontier_size, m_done, m_size, backward ? "scanned" : "expanded", processed,
+			elapsed.count(), static_cast<double>(processed) / std::max(elapsed.count(), 1e-9) / 1e6);
+
+		if (m_options.checkpoints && m_done < m_size && !save_checkpoint(checkpoint)) {
+			spdlog::warn("[pattern_generator::run] Failed to save the checkpoint '{}'", checkpoint.string());
+		}
+	}
+
+	std::ofstream file{ output, std::ios::binary | std::ios::trunc };
+	const auto header{ pattern_file_header::make(m_layout, m_options.encoding) };
+	if (!write_array(file, &header, 1) || !write_array(file, m_distances.data(), m_distances.size())) {
+		spdlog::error("[pattern_generator::run] Failed to write '{}'", output.string());
+		return false;
+	}
+	file.close();
+
+	std::error_code error;
+	std::filesystem::remove(checkpoint, error);
+
+	const std::chrono::duration<double> elapsed{ clock::now() - start };
+	spdlog::info("[pattern_generator::run] Wrote '{}' in {:.1f} s", output.string(), elapsed.count());
+	return true;
+}
+
+void pattern_generator::reset() {
+	m_visited.assign(m_words, 0);
+	m_frontier.assign(m_words, 0);
+	m_next = std::vector<std::atomic<uint64_t>>(m_words);
+	m_distances.assign(pattern_packing::bytes(m_options.encoding, m_size), 0xFF);
+
+	// bits past the last state are never expanded
+	if (const auto tail{ m_size % bits_per_word }; tail != 0) {
+		m_visited.back() = ~((uint64_t{ 1 } << tail) - 1);
+	}
+
+	const auto goal{ m_layout.goal() };
+	m_visited[goal / bits_per_word] |= uint64_t{ 1 } << (goal % bits_per_word);
+	m_frontier[goal / bits_per_word] |= uint64_t{ 1 } << (goal % bits_per_word);
+	pattern_packing::set(m_distances.data(), m_options.encoding, goal, 0);
+
+	m_depth = 0;
+	m_done = 1;
+	m_frontier_size = 1;
+}
+
+bool pattern_generator::load_checkpoint(const std::filesystem::path &path) {
+	std::ifstream file{ path, std::ios::binary };
+	if (!file) {
+		return false;
+	}
+
+	checkpoint_header header;
+	const auto expected{ pattern_file_header::make(m_layout, m_options.encoding) };
+	if (!read_array(file, &header, 1) || header.magic != checkpoint_header::file_magic
+		|| header.version != checkpoint_header::file_version
+		|| std::memcmp(&header.pattern, &expected, sizeof(expected)) != 0) {
+		spdlog::warn("[pattern_generator::load_checkpoint] '{}' doesn't match the layout, starting over", path.string());
+		return false;
+	}
+
+	m_visited.resize(m_words);
+	m_frontier.resize(m_words);
+	m_next = std::vector<std::atomic<uint64_t>>(m_words);
+	m_distances.resize(pattern_packing::bytes(m_options.encoding, m_size));
+	if (!read_array(file, m_visited.data(), m_visited.size())
+		|| !read_array(file, m_frontier.data(), m_frontier.size())
+		|| !read_array(file, m_distances.data(), m_distances.size())) {
+		spdlog::warn("[pattern_generator::load_checkpoint] '{}' is truncated, starting over", path.string());
+		return false;
+	}
+
+	m_depth = header.depth;
+	m_done = header.done;
+	m_frontier_size = header.frontier_size;
+	spdlog::info("[pattern_generator::load_checkpoint] Resuming '{}' after depth {}", path.string(), m_depth);
+	return true;
+}
+
+bool pattern_generator::save_checkpoint(const std::filesystem::path &path) const {
+	auto temporary{ path };
+	temporary.concat(".tmp");
+
+	{
+		std::ofstream file{ temporary, std::ios::binary | std::ios::trunc };
+		checkpoint_header header;
+		header.pattern = pattern_file_header::make(m_layout, m_options.encoding);
+		header.done = m_done;
+		header.frontier_size = m_frontier_size;
+		header.depth = m_depth;
+		if (!write_array(file, &header, 1)
+			|| !write_array(file, m_visited.data(), m_visited.size())
+			|| !write_array(file, m_frontier.data(), m_frontier.size())
+			|| !write_array(file, m_distances.data(), m_distances.size())) {
+			return false;
+		}
+	}
+
+	// the previous checkpoint stays valid until the new one is complete
+	std::error_code error;
+	std::filesystem::rename(temporary, path, error);
+	return !error;
+}
+
+uint64_t pattern_generator::expand_forward(const uint64_t first_word, const uint64_t last_word) {
+	std::array<uint8_t, pattern_layout::max_pieces> fields{};
+	std::array<uint8_t, pattern_layout::max_pieces> moved{};
+
+	uint64_t expanded{};
+	for (auto word{ first_word }; word < last_word; ++word) {
+		for (auto bits{ m_frontier[word] }; bits != 0; bits &= bits - 1) {
+			++expanded;
+			m_layout.fields(word * bits_per_word + core::tools::count_trailing_zeros(bits), fields.data());
+
+			for (size_t m{}; m < move_count; ++m) {
+				m_layout.move_fields(fields.data(), static_cast<move>(m), moved.data());
+				const auto next{ m_layout.index(moved.data()) };
+				const auto mask{ uint64_t{ 1 } << (next % bits_per_word) };
+				if (m_visited[next / bits_per_word] & mask) continue;
+
+				auto &target{ m_next[next / bits_per_word] };
+				if ((target.load(std::memory_order_relaxed) & mask) == 0) {
+					target.fetch_or(mask, std::memory_order_relaxed);
+				}
+			}
+		}
+	}
+	return expanded;
+}
+
+uint64_t pattern_generator::expand_backward(const uint64_t first_word, const uint64_t last_word) {
+	std::array<uint8_t, pattern_layout::max_pieces> fields{};
+	std::array<uint8_t, pattern_layout::max_pieces> moved{};
+
+	uint64_t scanned{};
+	for (auto word{ first_word }; word < last_word; ++word) {
+		uint64_t found{};
+		for (auto bits{ ~m_visited[word] }; bits != 0; bits &= bits - 1) {
+			++scanned;
+			const auto bit{ core::tools::count_trailing_zeros(bits) };
+			m_layout.fields(word * bits_per_word + bit, fields.data());
+
+			// the move set is closed under inversion, so the neighbours are the predecessors too
+			for (size_t m{}; m < move_count; ++m) {
+				m_layout.move_fields(fields.data(), static_cast<move>(m), moved.data());
+				const auto previous{ m_layout.index(moved.data()) };
+				if (m_frontier[previous / bits_per_word] & (uint64_t{ 1 } << (previous % bits_per_word))) {
+					found |= uint64_t{ 1 } << bit;
+					break;
+				}
+			}
+		}
+		m_next[word].store(found, std::memory_order_relaxed);
+	}
+	return scanned;
+}
+
+uint64_t pattern_generator::commit(const uint64_t first_word, const uint64_t last_word) {
+	// a word covers a whole number of bytes of both encodings, so the chunks never share a byte
+	const auto distance{ static_cast<uint8_t>(m_depth + 1) };
+
+	uint64_t found{};
+	for (auto word{ first_word }; word < last_word; ++word) {
+		const auto bits{ m_next[word].exchange(0, std::memory_order_relaxed) };
+		m_frontier[word] = bits;
+		m_visited[word] |= bits;
+		found += core::tools::popcount(bits);
+
+		for (auto left{ bits }; left != 0; left &= left - 1) {
+			const auto index{ word * bits_per_word + core::tools::count_trailing_zeros(left) };
+			pattern_packing::set(m_distances.data(), m_options.encoding, index, distance);
+		}
+	}
+	return found;
+}
+
+template<class Function>
+uint64_t pattern_generator::parallel(Function &&function) {
+	std::atomic<uint64_t> next_word{ 0 };
+	std::atomic<uint64_t> total{ 0 };
+
+	const auto worker{ [this, &function, &next_word, &total] {
+		uint64_t local{};
+		for (;;) {
+			const auto first{ next_word.fetch_add(m_options.chunk_words, std::memory_order_relaxed) };
+			if (first >= m_words) break;
+			local += function(first, std::min<uint64_t>(first + m_options.chunk_words, m_words));
+		}
+		total.fetch_add(local, std::memory_order_relaxed);
+	} };
+
+	std::vector<std::thread> threads;
+	threads.reserve(m_options.threads - 1);
+	for (size_t i{ 1 }; i < m_options.threads; ++i) {
+		threads.emplace_back(worker);
+	}
+	worker();
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	return total.load();
+}
+
+} // namespace gzn::game::magicube
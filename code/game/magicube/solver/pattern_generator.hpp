@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <cinttypes>
+#include <filesystem>
+
+#include "game/magicube/solver/pattern_database.hpp"
+
+namespace gzn::game::magicube {
+
+struct pattern_generator_options {
+	pattern_encoding encoding{ pattern_encoding::nibble };
+	/// 0 means every hardware thread
+	size_t threads{ 0 };
+	/// The unit of work: how many 64-state bitmap words a thread takes at once
+	size_t chunk_words{ 4096 };
+	/// Saves the progress to `<output>.checkpoint` after every depth
+	bool checkpoints{ true };
+	/// Continues from the checkpoint when there's a matching one
+	bool resume{ true };
+};
+
+/// @brief Parallel breadth-first search over a pattern layout. Each depth is a bitmap of
+/// frontier states, split into chunks which the threads pick up one by one. While the frontier
+/// is smaller than the unvisited part, the frontier states are expanded; later on every
+/// unvisited state looks for a neighbour in the frontier instead.
+class pattern_generator {
+public:
+	pattern_generator(const pattern_layout &layout, const pattern_generator_options &options);
+
+	[[nodiscard]] bool run(const std::filesystem::path &output);
+
+private:
+	pattern_layout m_layout;
+	pattern_generator_options m_options;
+	uint64_t m_size{};
+	uint64_t m_words{};
+
+	std::vector<uint64_t> m_visited;
+	std::vector<uint64_t> m_frontier;
+	std::vector<std::atomic<uint64_t>> m_next;
+	std::vector<uint8_t> m_distances;
+
+	uint8_t m_depth{};
+	uint64_t m_done{};
+	uint64_t m_frontier_size{};
+
+	void reset();
+	[[nodiscard]] bool load_checkpoint(const std::filesystem::path &path);
+	[[nodiscard]] bool save_checkpoint(const std::filesystem::path &path) const;
+
+	[[nodiscard]] uint64_t expand_forward(const uint64_t first_word, const uint64_t last_word);
+	[[nodiscard]] uint64_t expand_backward(const uint64_t first_word, const uint64_t last_word);
+	[[nodiscard]] uint64_t commit(const uint64_t first_word, const uint64_t last_word);
+
+	template<class Function>
+	uint64_t parallel(Function &&function);
+};
+
+} // namespace gzn::game::magicube
@@ -0,0 +1,325 @@
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+#include "game/magicube/solver/pocket_table.hpp"
+
+namespace gzn::game::magicube {
+
+namespace {
+
+struct pocket_file_header {
+	static constexpr uint32_t file_magic{ 0x5443504D }; // "MPCT"
+	static constexpr uint32_t file_version{ 1 };
+
+	uint32_t magic{ file_magic };
+	uint32_t version{ file_version };
+	uint64_t entries{ pocket_table::state_count };
+};
+static_assert(sizeof(pocket_file_header) == 16);
+
+/// U, R and F turn the corners around DBL; they're the first moves of every face order
+constexpr size_t pocket_move_count{ 9 };
+constexpr auto fixed_corner{ static_cast<size_t>(corner::DBL) };
+constexpr uint64_t pocket_table_bytes{ pattern_packing::bytes(pattern_encoding::mod3, pocket_table::state_count) };
+
+/// The positions of the corners which move, DBL is skipped
+constexpr std::array<uint8_t, 7> moving_positions{ 0, 1, 2, 3, 4, 5, 7 };
+
+constexpr size_t rotation_count{ 24 };
+
+[[nodiscard]] constexpr bool same_corners(const cubie_cube &lhs, const cubie_cube &rhs) noexcept {
+	for (size_t i{}; i < corner_count; ++i) {
+		if (lhs.cp[i] != rhs.cp[i] || lhs.co[i] != rhs.co[i]) return false;
+	}
+	return true;
+}
+
+struct pocket_rotations {
+	/// The whole cube turned: `multiply(cube, cubes[r])` is `cube` held differently
+	std::array<cubie_cube, rotation_count> cubes{};
+	/// normalizers[position][twist] turns the DBL corner found there back home
+	std::array<std::array<uint8_t, 3>, corner_count> normalizers{};
+	/// moves[r][m]: the move of the original cube doing what `m` does after the rotation `r`
+	std::array<std::array<move, pocket_move_count>, rotation_count> moves{};
+};
+
+constexpr pocket_rotations make_pocket_rotations() noexcept {
+	pocket_rotations rotations{};
+	std::array<cubie_cube, move_count> turns{};
+	for (size_t m{}; m < move_count; ++m) {
+		turns[m] = apply(cubie_cube{}, static_cast<move>(m));
+	}
+
+	// x is R L' and y is U D' for the corners
+	const std::array<cubie_cube, 2> generators{
+		multiply(turns[static_cast<size_t>(move::R1)], turns[static_cast<size_t>(move::L3)]),
+		multiply(turns[static_cast<size_t>(move::U1)], turns[static_cast<size_t>(move::D3)]),
+	};
+	size_t count{ 1 };
+	for (size_t i{}; i < count; ++i) {
+		for (const auto &generator : generators) {
+			const auto next{ multiply(rotations.cubes[i], generator) };
+			bool known{ false };
+			for (size_t j{}; j < count && !known; ++j) {
+				known = same_corners(rotations.cubes[j], next);
+			}
+			if (!known && count < rotation_count) rotations.cubes[count++] = next;
+		}
+	}
+
+	for (size_t r{}; r < rotation_count; ++r) {
+		const auto &rotation{ rotations.cubes[r] };
+		rotations.normalizers[rotation.cp[fixed_corner]][(3 - rotation.co[fixed_corner]) % 3] = static_cast<uint8_t>(r);
+
+		for (size_t m{}; m < pocket_move_count; ++m) {
+			// `m' rotation == rotation m`
+			const auto conjugated{ multiply(multiply(rotation, turns[m]), inverse(rotation)) };
+			for (size_t original{}; original < move_count; ++original) {
+				if (same_corners(turns[original], conjugated)) {
+					rotations.moves[r][m] = static_cast<move>(original);
+				}
+			}
+		}
+	}
+	return rotations;
+}
+
+constexpr pocket_rotations rotations{ make_pocket_rotations() };
+
+static_assert(rotations.normalizers[fixed_corner][0] == 0 && rotations.moves[0][8] == move::F3,
+	"The identity has to come first");
+
+/// Lehmer code of the corners on the moving positions, the identity is 0
+[[nodiscard]] uint16_t pocket_permutation(const cubie_cube &cube) noexcept {
+	uint32_t result{};
+	for (size_t i{}; i < moving_positions.size(); ++i) {
+		uint32_t smaller{};
+		for (size_t j{ i + 1 }; j < moving_positions.size(); ++j) {
+			smaller += cube.cp[moving_positions[j]] < cube.cp[moving_positions[i]];
+		}
+		result = result * static_cast<uint32_t>(moving_positions.size() - i) + smaller;
+	}
+	return static_cast<uint16_t>(result);
+}
+
+void set_pocket_permutation(cubie_cube &cube, uint32_t value) noexcept {
+	std::array<uint8_t, moving_positions.size()> digits{};
+	for (size_t i{ digits.size() }; i-- > 0;) {
+		digits[i] = static_cast<uint8_t>(value % (digits.size() - i));
+		value /= static_cast<uint32_t>(digits.size() - i);
+	}
+
+	auto unused{ moving_positions };
+	size_t unused_count{ unused.size() };
+	for (size_t i{}; i < digits.size(); ++i) {
+		cube.cp[moving_positions[i]] = unused[digits[i]];
+		for (size_t j{ digits[i] }; j + 1 < unused_count; ++j) {
+			unused[j] = unused[j + 1];
+		}
+		--unused_count;
+	}
+	cube.cp[fixed_corner] = static_cast<uint8_t>(fixed_corner);
+}
+
+[[nodiscard]] uint16_t pocket_twist(const cubie_cube &cube) noexcept {
+	uint16_t result{};
+	for (size_t i{}; i + 1 < moving_positions.size(); ++i) {
+		result = static_cast<uint16_t>(result * 3 + cube.co[moving_positions[i]]);
+	}
+	return result;
+}
+
+void set_pocket_twist(cubie_cube &cube, uint32_t value) noexcept {
+	uint32_t sum{};
+	for (size_t i{ moving_positions.size() - 1 }; i-- > 0;) {
+		cube.co[moving_positions[i]] = static_cast<uint8_t>(value % 3);
+		sum += value % 3;
+		value /= 3;
+	}
+	cube.co[moving_positions.back()] = static_cast<uint8_t>((3 - sum % 3) % 3);
+	cube.co[fixed_corner] = 0;
+}
+
+/// The coordinates stay separate under the moves: the permutation never depends on the twists
+/// and the twists on the positions only
+struct pocket_move_tables {
+	std::array<std::array<uint16_t, pocket_move_count>, pocket_table::permutation_count> permutations{};
+	std::array<std::array<uint16_t, pocket_move_count>, pocket_table::twist_count> twists{};
+
+	pocket_move_tables() noexcept {
+		for (uint32_t value{}; value < pocket_table::permutation_count; ++value) {
+			cubie_cube cube;
+			set_pocket_permutation(cube, value);
+			for (size_t m{}; m < pocket_move_count; ++m) {
+				permutations[value][m] = pocket_permutation(apply(cube, static_cast<move>(m)));
+			}
+		}
+		for (uint32_t value{}; value < pocket_table::twist_count; ++value) {
+			cubie_cube cube;
+			set_pocket_twist(cube, value);
+			for (size_t m{}; m < pocket_move_count; ++m) {
+				twists[value][m] = pocket_twist(apply(cube, static_cast<move>(m)));
+			}
+		}
+	}
+
+	[[nodiscard]] uint32_t next(const uint32_t index, const size_t m) const noexcept {
+		return uint32_t{ permutations[index / pocket_table::twist_count][m] } * pocket_table::twist_count
+			+ twists[index % pocket_table::twist_count][m];
+	}
+};
+
+[[nodiscard]] const pocket_move_tables &pocket_moves() {
+	static const pocket_move_tables tables;
+	return tables;
+}
+
+/// @brief The corners of @p state held with DBL solved, and the rotation which did it
+[[nodiscard]] std::pair<cubie_cube, uint8_t> normalized(const cube_state &state) noexcept {
+	const auto cube{ state.to_cubies() };
+	size_t position{};
+	while (cube.cp[position] != fixed_corner) ++position;
+	const auto rotation{ rotations.normalizers[position][cube.co[position]] };
+	return { multiply(cube, rotations.cubes[rotation]), rotation };
+}
+
+} // anonymous namespace
+
+pocket_table::pocket_table(std::vector<uint8_t> &&distances) noexcept
+	: m_owned{ std::move(distances) }
+	, m_distances{ m_owned.data() } {}
+
+pocket_table::pocket_table(core::tools::mapped_file &&file) noexcept
+	: m_file{ std::move(file) }
+	, m_distances{ reinterpret_cast<const uint8_t *>(m_file->data() + sizeof(pocket_file_header)) } {}
+
+pocket_table pocket_table::generate() {
+	const auto &moves{ pocket_moves() };
+
+	// the exact depths are needed to tell the frontier apart, the table keeps them modulo 3
+	constexpr uint8_t unknown{ 0xFF };
+	std::vector<uint8_t> depths(state_count, unknown);
+	depths[0] = 0;
+	uint32_t found{ 1 };
+	for (uint8_t depth{}; found > 0; ++depth) {
+		found = 0;
+		for (uint32_t index{}; index < state_count; ++index) {
+			if (depths[index] != depth) continue;
+			for (size_t m{}; m < pocket_move_count; ++m) {
+				if (const auto next{ moves.next(index, m) }; depths[next] == unknown) {
+					depths[next] = static_cast<uint8_t>(depth + 1);
+					++found;
+				}
+			}
+		}
+		if (found > 0) {
+			spdlog::debug("[pocket_table::generate] Depth {:>2}: {:>8} states", depth + 1, found);
+		}
+	}
+
+	std::vector<uint8_t> distances(pocket_table_bytes, 0xFF);
+	for (uint32_t index{}; index < state_count; ++index) {
+		pattern_packing::set(distances.data(), pattern_encoding::mod3, index, depths[index]);
+	}
+	return pocket_table{ std::move(distances) };
+}
+
+std::optional<pocket_table> pocket_table::open(const std::filesystem::path &path) {
+	auto file{ core::tools::mapped_file::open(path) };
+	if (!file) {
+		return std::nullopt;
+	}
+
+	pocket_file_header header;
+	if (file->size() >= sizeof(header)) {
+		std::memcpy(&header, file->data(), sizeof(header));
+	}
+	if (file->size() < sizeof(header) + pocket_table_bytes || header.magic != pocket_file_header::file_magic
+		|| header.version != pocket_file_header::file_version || header.entries != state_count) {
+		spdlog::warn("[pocket_table::open] '{}' isn't a 2x2 table of version {} or it's truncated",
+			path.string(), pocket_file_header::file_version);
+		return std::nullopt;
+	}
+	return pocket_table{ std::move(*file) };
+}
+
+bool pocket_table::save(const std::filesystem::path &path) const {
+	std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+	if (!file) {
+		spdlog::error("[pocket_table::save] Failed to open '{}' for writing", path.string());
+		return false;
+	}
+
+	const pocket_file_header header;
+	file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char *>(m_distances), static_cast<std::streamsize>(pocket_table_bytes));
+	return static_cast<bool>(file);
+}
+
+std::optional<pocket_table> pocket_table::load_or_generate(const std::filesystem::path &path) {
+	using clock = std::chrono::steady_clock;
+	const auto start{ clock::now() };
+	const auto elapsed{ [&start] {
+		return std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - start).count();
+	} };
+
+	// a missing table is expected on the first run
+	std::error_code error;
+	if (auto table{ std::filesystem::exists(path, error) ? open(path) : std::nullopt }; table) {
+		spdlog::info("[pocket_table::load_or_generate] Mapped '{}' in {} ms", path.string(), elapsed());
+		return table;
+	}
+
+	auto table{ generate() };
+	spdlog::info("[pocket_table::load_or_generate] Generated the table in {} ms", elapsed());
+	if (table.save(path)) {
+		spdlog::info("[pocket_table::load_or_generate] Saved the table to '{}'", path.string());
+	}
+	return table;
+}
+
+uint32_t pocket_table::index(const cube_state &state) noexcept {
+	const auto cube{ normalized(state).first };
+	return uint32_t{ pocket_permutation(cube) } * twist_count + pocket_twist(cube);
+}
+
+std::optional<uint8_t> pocket_table::distance(const cube_state &state) const noexcept {
+	return walk(state, nullptr);
+}
+
+std::optional<move_sequence> pocket_table::solve(const cube_state &state) const {
+	move_sequence solution;
+	solution.reserve(max_distance);
+	if (!walk(state, &solution)) {
+		return std::nullopt;
+	}
+	return solution;
+}
+
+std::optional<uint8_t> pocket_table::walk(const cube_state &state, move_sequence *output) const noexcept {
+	const auto &moves{ pocket_moves() };
+	const auto [cube, rotation] = normalized(state);
+
+	// a neighbour one move closer is always there, and it's the only one with this remainder
+	uint32_t index{ uint32_t{ pocket_permutation(cube) } * twist_count + pocket_twist(cube) };
+	uint8_t distance{};
+	for (; index != 0; ++distance) {
+		const auto closer{ static_cast<uint8_t>((raw(index) + 2) % 3) };
+		size_t m{};
+		while (m < pocket_move_count && raw(moves.next(index, m)) != closer) ++m;
+		if (m == pocket_move_count || distance == max_distance) {
+			spdlog::error("[pocket_table::walk] The table is corrupted: no way to the goal");
+			return std::nullopt;
+		}
+		index = moves.next(index, m);
+		if (output != nullptr) output->push_back(rotations.moves[rotation][m]);
+	}
+	return distance;
+}
+
+} // namespace gzn::game::magicube
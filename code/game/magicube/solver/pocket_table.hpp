@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+#include <optional>
+#include <cinttypes>
+#include <filesystem>
+
+#include <core/tools/mapped_file.hpp>
+
+#include "game/magicube/cube/cube_state.hpp"
+#include "game/magicube/solver/pattern_database.hpp"
+
+namespace gzn::game::magicube {
+
+/// @brief Distances of every 2x2 state, 2 bits each. A 2x2 is the corners of a 3x3 without the
+/// centres, so the cube is turned until the DBL corner is solved and only U, R and F are left:
+/// 7! * 3^6 states, 918540 bytes. Every move changes the distance by one at most, which makes
+/// the distance modulo 3 enough to walk to the goal greedily along an optimal solution.
+class pocket_table {
+public:
+	static constexpr uint32_t permutation_count{ 5040 }; // 7! of the corners around DBL
+	static constexpr uint32_t twist_count{ 729 };        // 3^6, the last twist follows
+	static constexpr uint32_t state_count{ permutation_count * twist_count };
+	/// God's number of the 2x2 in the half turn metric
+	static constexpr uint8_t max_distance{ 11 };
+
+	/// @brief Breadth-first search over all the states, takes a fraction of a second
+	[[nodiscard]] static pocket_table generate();
+	/// @brief Maps the table from the disk
+	[[nodiscard]] static std::optional<pocket_table> open(const std::filesystem::path &path);
+	[[nodiscard]] bool save(const std::filesystem::path &path) const;
+
+	/// @brief Maps the table from @p path or generates it and saves to @p path
+	[[nodiscard]] static std::optional<pocket_table> load_or_generate(const std::filesystem::path &path);
+
+	/// @brief The index of the corners of @p state however the cube is held; the edges are
+	/// ignored. 0 is the solved 2x2.
+	[[nodiscard]] static uint32_t index(const cube_state &state) noexcept;
+	[[nodiscard]] static bool solved(const cube_state &state) noexcept { return index(state) == 0; }
+
+	/// @brief The optimal number of face turns solving the corners of @p state
+	[[nodiscard]] std::optional<uint8_t> distance(const cube_state &state) const noexcept;
+	/// @brief An optimal solution of the corners of @p state, in the turns of any face
+	[[nodiscard]] std::optional<move_sequence> solve(const cube_state &state) const;
+
+	/// @brief The distance of the state @p index modulo 3
+	[[nodiscard]] uint8_t raw(const uint32_t index) const noexcept {
+		return pattern_packing::get(m_distances, pattern_encoding::mod3, index);
+	}
+
+private:
+	std::optional<core::tools::mapped_file> m_file;
+	std::vector<uint8_t> m_owned;
+	const uint8_t *m_distances{ nullptr };
+
+	explicit pocket_table(std::vector<uint8_t> &&distances) noexcept;
+	explicit pocket_table(core::tools::mapped_file &&file) noexcept;
+
+	/// @brief Descends from @p state to the goal, appending the moves to @p output when it's set
+	[[nodiscard]] std::optional<uint8_t> walk(const cube_state &state, move_sequence *output) const noexcept;
+};
+
+} // namespace gzn::game::magicube
@@ -0,0 +1,664 @@
+#include <map>
+#include <atomic>
+#include <mutex>
+#include <array>
+#include <string>
+#include <utility>
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+
+#include "game/magicube/cube/facelet_cube.hpp"
+#include "game/magicube/solver/reduction_solver.hpp"
+
+namespace gzn::game::magicube {
+
+namespace {
+
+using reduction_clock = std::chrono::steady_clock;
+
+/// Twice the coordinates in the cube, so that the centres of the stickers and the cubies are on
+/// the lattice: the origin is the centre of the cube and the stickers of a face are N away
+using lattice_point = std::array<int, 3>;
+
+constexpr std::string_view facelet_letters{ "URFDLB" };
+
+[[nodiscard]] constexpr int dot(const lattice_point &lhs, const lattice_point &rhs) noexcept {
+	return lhs[0] * rhs[0] + lhs[1] * rhs[1] + lhs[2] * rhs[2];
+}
+
+[[nodiscard]] constexpr lattice_point cross(const lattice_point &lhs, const lattice_point &rhs) noexcept {
+	return { lhs[1] * rhs[2] - lhs[2] * rhs[1], lhs[2] * rhs[0] - lhs[0] * rhs[2], lhs[0] * rhs[1] - lhs[1] * rhs[0] };
+}
+
+/// A centre orbit is four stickers of every face, a wing orbit the two wings of every edge at
+/// the same depth
+constexpr size_t orbit_slots{ 24 };
+constexpr size_t cycle_index_count{ orbit_slots * orbit_slots * orbit_slots };
+constexpr uint16_t no_entry{ 0xFFFF };
+constexpr uint8_t no_slot{ 0xFF };
+
+using sticker_permutation = std::vector<uint16_t>;
+using orbit_homes = std::array<uint8_t, orbit_slots>;
+using commutator_turns = std::array<turn, 8>;
+
+/// The 3-cycle of the slots `a -> b -> c` indexed from the smallest slot
+[[nodiscard]] constexpr uint32_t cycle_index(const uint8_t a, const uint8_t b, const uint8_t c) noexcept {
+	if (b < a && b < c) return cycle_index(b, c, a);
+	if (c < a && c < b) return cycle_index(c, a, b);
+	return (static_cast<uint32_t>(a) * orbit_slots + b) * orbit_slots + c;
+}
+
+/// The turns of a layer are grouped by three powers, so the inverse is in the same group
+[[nodiscard]] constexpr size_t inverse_turn(const size_t index) noexcept {
+	return index - index % 3 + 2 - index % 3;
+}
+
+/// A 3-cycle is either a commutator or the conjugate of the `parent` cycle by a layer turn:
+/// `setup`, the parent, and the setup undone
+struct cycle_entry {
+	uint32_t parent{};
+	uint16_t commutator{ no_entry };
+	uint16_t setup{ no_entry };
+
+	[[nodiscard]] bool known() const noexcept { return commutator != no_entry || setup != no_entry; }
+};
+
+struct piece_orbit {
+	bool wings{};
+	/// The inner layer whose quarter turn flips the parity of a wing orbit
+	uint8_t depth{};
+	/// The stickers of every slot. The wings are ordered by the hand: the cross product of the
+	/// normals points to the wing from the middle of its edge.
+	std::array<std::array<uint16_t, 2>, orbit_slots> stickers{};
+	/// The slot a layer turn takes the piece of every slot to, by the index of the turn
+	std::vector<orbit_homes> moved;
+	/// The slot of a wing by the faces its stickers belong to, first and second
+	std::array<uint8_t, face_count * face_count> wing_slots{};
+	std::vector<commutator_turns> commutators;
+	/// By `cycle_index`
+	std::vector<cycle_entry> cycles;
+};
+
+struct reduction_tables {
+	size_t size{};
+	/// Every face turn and every inner layer of U, R and F, each with the three powers
+	std::vector<turn> turns;
+	/// The centre orbits first
+	std::vector<piece_orbit> orbits;
+};
+
+[[nodiscard]] sticker_permutation compose(const sticker_permutation &first, const sticker_permutation &second) {
+	sticker_permutation result(first.size());
+	for (size_t i{}; i < first.size(); ++i) {
+		result[i] = second[first[i]];
+	}
+	return result;
+}
+
+[[nodiscard]] reduction_tables make_reduction_tables(const size_t size) {
+	const auto side{ static_cast<int>(size) };
+	const size_t area{ size * size };
+	const size_t sticker_count{ face_count * area };
+
+	std::vector<lattice_point> points(sticker_count);
+	for (size_t f{}; f < face_count; ++f) {
+		const auto &frame{ face_frames[f] };
+		for (size_t row{}; row < size; ++row) {
+			for (size_t column{}; column < size; ++column) {
+				const auto across{ 2 * static_cast<int>(column) - side + 1 };
+				const auto down{ 2 * static_cast<int>(row) - side + 1 };
+				auto &point{ points[f * area + row * size + column] };
+				for (size_t axis{}; axis < 3; ++axis) {
+					point[axis] = frame.normal[axis] * side + frame.right[axis] * across + frame.down[axis] * down;
+				}
+			}
+		}
+	}
+	const auto sticker_at{ [&](const lattice_point &point) {
+		size_t f{};
+		while (dot(point, face_frames[f].normal) != side) {
+			++f;
+		}
+		const auto column{ static_cast<size_t>((dot(point, face_frames[f].right) + side - 1) / 2) };
+		const auto row{ static_cast<size_t>((dot(point, face_frames[f].down) + side - 1) / 2) };
+		return static_cast<uint16_t>(f * area + row * size + column);
+	} };
+
+	reduction_tables tables;
+	tables.size = size;
+	for (size_t f{}; f < face_count; ++f) {
+		for (uint8_t power{ 1 }; power <= 3; ++power) {
+			tables.turns.push_back(turn{ turn_kind::face, static_cast<face>(f), power, 1 });
+		}
+	}
+	const size_t outer_count{ tables.turns.size() };
+	for (const auto f : { face::U, face::R, face::F }) {
+		for (size_t layer{ 1 }; layer + 1 < size; ++layer) {
+			for (uint8_t power{ 1 }; power <= 3; ++power) {
+				tables.turns.push_back(turn{ turn_kind::face, f, power, static_cast<uint8_t>(layer + 1) });
+			}
+		}
+	}
+
+	std::vector<sticker_permutation> permutations;
+	for (const auto &t : tables.turns) {
+		const auto &axis{ face_frames[static_cast<size_t>(t.direction)].normal };
+		const auto level{ side + 1 - 2 * t.layers };
+		auto &permutation{ permutations.emplace_back(sticker_count) };
+		for (size_t i{}; i < sticker_count; ++i) {
+			permutation[i] = static_cast<uint16_t>(i);
+			// the stickers of the turning face are a step further out than their cubies
+			const auto along{ dot(points[i], axis) };
+			const auto cubie{ along == side ? side - 1 : along == -side ? 1 - side : along };
+			if (cubie != level) continue;
+
+			auto point{ points[i] };
+			for (uint8_t q{}; q < t.power; ++q) {
+				const auto turned{ cross(axis, point) };
+				const auto height{ dot(axis, point) };
+				for (size_t k{}; k < 3; ++k) {
+					point[k] = axis[k] * height - turned[k];
+				}
+			}
+			permutation[i] = sticker_at(point);
+		}
+	}
+
+	// the slots of the orbits, the corners, the middle edges and the core centres left out
+	std::map<std::pair<bool, size_t>, std::vector<uint16_t>> orbit_stickers;
+	for (size_t i{}; i < sticker_count; ++i) {
+		auto row{ (i % area) / size };
+		auto column{ i % size };
+		const bool edge_row{ row == 0 || row == size - 1 };
+		const bool edge_column{ column == 0 || column == size - 1 };
+		if (edge_row && edge_column) continue;
+		if (edge_row || edge_column) {
+			const auto depth{ edge_row ? column : row };
+			if (2 * depth + 1 != size) {
+				orbit_stickers[{ true, std::min(depth, size - 1 - depth) }].push_back(static_cast<uint16_t>(i));
+			}
+			continue;
+		}
+		if (2 * row + 1 == size && 2 * column + 1 == size) continue;
+		auto key{ row * size + column };
+		for (size_t q{}; q < 3; ++q) {
+			std::tie(row, column) = std::pair{ column, size - 1 - row };
+			key = std::min(key, row * size + column);
+		}
+		orbit_stickers[{ false, key }].push_back(static_cast<uint16_t>(i));
+	}
+
+	std::vector<uint8_t> orbit_of(sticker_count, no_slot);
+	std::vector<uint8_t> slot_of(sticker_count, no_slot);
+	for (const auto &[key, stickers] : orbit_stickers) {
+		const auto index{ static_cast<uint8_t>(tables.orbits.size()) };
+		auto &orbit{ tables.orbits.emplace_back() };
+		orbit.wings = key.first;
+		orbit.depth = static_cast<uint8_t>(key.second);
+		orbit.wing_slots.fill(no_slot);
+		orbit.cycles.resize(cycle_index_count);
+
+		std::map<lattice_point, uint8_t> cubie_slots;
+		uint8_t slots{};
+		for (const auto sticker : stickers) {
+			uint8_t slot{ slots };
+			if (orbit.wings) {
+				auto cubie{ points[sticker] };
+				const auto &normal{ face_frames[sticker / area].normal };
+				for (size_t k{}; k < 3; ++k) {
+					cubie[k] -= normal[k];
+				}
+				const auto [found, inserted]{ cubie_slots.try_emplace(cubie, slots) };
+				slot = found->second;
+				orbit.stickers[slot][inserted ? 0 : 1] = sticker;
+				if (!inserted) {
+					auto &pair{ orbit.stickers[slot] };
+					const auto hand{ cross(face_frames[pair[0] / area].normal, face_frames[pair[1] / area].normal) };
+					if (dot(hand, cubie) < 0) {
+						std::swap(pair[0], pair[1]);
+					}
+					orbit.wing_slots[(pair[0] / area) * face_count + pair[1] / area] = slot;
+				}
+			} else {
+				orbit.stickers[slot] = { sticker, sticker };
+			}
+			if (slot == slots) {
+				++slots;
+			}
+			orbit_of[sticker] = index;
+			slot_of[sticker] = slot;
+		}
+
+		for (const auto &permutation : permutations) {
+			auto &moved{ orbit.moved.emplace_back() };
+			for (size_t slot{}; slot < orbit_slots; ++slot) {
+				moved[slot] = slot_of[permutation[orbit.stickers[slot][0]]];
+			}
+		}
+	}
+
+	// the commutators moving three slots of one orbit and nothing else
+	const auto add_commutator{ [&](const sticker_permutation &permutation, const commutator_turns &sequence) {
+		size_t moved{};
+		uint16_t first{};
+		for (size_t i{}; i < sticker_count; ++i) {
+			if (permutation[i] == i) continue;
+			if (orbit_of[i] == no_slot || (moved > 0 && orbit_of[i] != orbit_of[first])) return;
+			first = static_cast<uint16_t>(i);
+			++moved;
+		}
+		if (moved == 0) return;
+		auto &orbit{ tables.orbits[orbit_of[first]] };
+		if (moved != (orbit.wings ? 6u : 3u)) return;
+
+		const auto a{ slot_of[first] };
+		const auto b{ slot_of[permutation[first]] };
+		const auto c{ slot_of[permutation[permutation[first]]] };
+		auto &entry{ orbit.cycles[cycle_index(a, b, c)] };
+		if (!entry.known()) {
+			entry.commutator = static_cast<uint16_t>(orbit.commutators.size());
+			orbit.commutators.push_back(sequence);
+		}
+	} };
+	const auto inverse_of{ [&](const sticker_permutation &permutation) {
+		sticker_permutation result(permutation.size());
+		for (size_t i{}; i < permutation.size(); ++i) {
+			result[permutation[i]] = static_cast<uint16_t>(i);
+		}
+		return result;
+	} };
+
+	for (size_t s{ outer_count }; s < tables.turns.size(); s += 3) {
+		for (size_t x{}; x < outer_count; ++x) {
+			const auto x_inverse{ inverse_turn(x) };
+			// centres: [X s X', t] with the inner layers s and t on different axes
+			const auto setup{ compose(compose(permutations[x], permutations[s]), permutations[x_inverse]) };
+			const auto setup_inverse{ inverse_of(setup) };
+			for (size_t t{ outer_count }; t < tables.turns.size(); t += 3) {
+				if (tables.turns[t].direction == tables.turns[s].direction) continue;
+				const auto cycle{ compose(compose(compose(setup, permutations[t]), setup_inverse), permutations[inverse_turn(t)]) };
+				add_commutator(cycle, { tables.turns[x], tables.turns[s], tables.turns[x_inverse], tables.turns[t],
+					tables.turns[x], tables.turns[inverse_turn(s)], tables.turns[x_inverse], tables.turns[inverse_turn(t)] });
+			}
+
+			// wings: [s, X m X'] with the face turns X and m of different faces
+			for (size_t m{}; m < outer_count; m += 3) {
+				if (tables.turns[m].direction == tables.turns[x].direction) continue;
+				const auto swap{ compose(compose(permutations[x], permutations[m]), permutations[x_inverse]) };
+				const auto cycle{ compose(compose(compose(permutations[s], swap), permutations[inverse_turn(s)]), inverse_of(swap)) };
+				add_commutator(cycle, { tables.turns[s], tables.turns[x], tables.turns[m], tables.turns[x_inverse],
+					tables.turns[inverse_turn(s)], tables.turns[x], tables.turns[inverse_turn(m)], tables.turns[x_inverse] });
+			}
+		}
+	}
+
+	// conjugating a known cycle by a turn reaches the cycle of the slots the turn brings there
+	for (size_t index{}; index < tables.orbits.size(); ++index) {
+		auto &orbit{ tables.orbits[index] };
+		std::vector<uint32_t> queue;
+		for (uint32_t cycle{}; cycle < cycle_index_count; ++cycle) {
+			if (orbit.cycles[cycle].known()) {
+				queue.push_back(cycle);
+			}
+		}
+		for (size_t head{}; head < queue.size(); ++head) {
+			const auto cycle{ queue[head] };
+			const auto a{ static_cast<uint8_t>(cycle / (orbit_slots * orbit_slots)) };
+			const auto b{ static_cast<uint8_t>(cycle / orbit_slots % orbit_slots) };
+			const auto c{ static_cast<uint8_t>(cycle % orbit_slots) };
+			for (size_t t{}; t < tables.turns.size(); ++t) {
+				const auto &back{ orbit.moved[inverse_turn(t)] };
+				const auto conjugate{ cycle_index(back[a], back[b], back[c]) };
+				auto &entry{ orbit.cycles[conjugate] };
+				if (!entry.known()) {
+					entry.parent = cycle;
+					entry.setup = static_cast<uint16_t>(t);
+					queue.push_back(conjugate);
+				}
+			}
+		}
+		if (queue.size() != orbit_slots * (orbit_slots - 1) * (orbit_slots - 2) / 3) {
+			spdlog::warn("[reduction_solver::prepare] The orbit {} of the {}x{} cube has {} 3-cycles only",
+				index, size, size, queue.size());
+		}
+	}
+	return tables;
+}
+
+struct reduction_table_slot {
+	std::once_flag generated;
+	std::unique_ptr<const reduction_tables> tables;
+};
+
+std::array<reduction_table_slot, reduction_solver::max_size + 1> reduction_table_slots;
+
+[[nodiscard]] const reduction_tables &reduction_tables_of(const size_t size) {
+	auto &slot{ reduction_table_slots[size] };
+	std::call_once(slot.generated, [&slot, size] {
+		const auto start{ reduction_clock::now() };
+		slot.tables = std::make_unique<const reduction_tables>(make_reduction_tables(size));
+		spdlog::info("[reduction_solver::prepare] Generated the 3-cycles of the {}x{} cube in {} ms", size, size,
+			std::chrono::duration_cast<std::chrono::milliseconds>(reduction_clock::now() - start).count());
+	});
+	return *slot.tables;
+}
+
+[[nodiscard]] std::chrono::microseconds elapsed_since(const reduction_clock::time_point start) noexcept {
+	return std::chrono::duration_cast<std::chrono::microseconds>(reduction_clock::now() - start);
+}
+
+/// @brief Appends @p t merged with the turn before it when they turn the same layer
+void append_turn(std::vector<turn> &output, const turn &t) {
+	if (!output.empty() && output.back().direction == t.direction && output.back().layers == t.layers) {
+		const auto power{ static_cast<uint8_t>((output.back().power + t.power) % 4) };
+		if (power == 0) {
+			output.pop_back();
+		} else {
+			output.back().power = power;
+		}
+		return;
+	}
+	output.push_back(t);
+}
+
+void append_cycle(const reduction_tables &tables, const piece_orbit &orbit, const uint32_t index, std::vector<turn> &output) {
+	const auto &entry{ orbit.cycles[index] };
+	if (entry.commutator != no_entry) {
+		for (const auto &t : orbit.commutators[entry.commutator]) {
+			append_turn(output, t);
+		}
+		return;
+	}
+	append_turn(output, tables.turns[entry.setup]);
+	append_cycle(tables, orbit, entry.parent, output);
+	append_turn(output, tables.turns[inverse_turn(entry.setup)]);
+}
+
+[[nodiscard]] bool odd_permutation(const orbit_homes &homes) noexcept {
+	uint32_t visited{};
+	bool odd{};
+	for (uint8_t start{}; start < orbit_slots; ++start) {
+		for (auto slot{ start }; (visited & (1u << slot)) == 0; slot = homes[slot]) {
+			visited |= 1u << slot;
+			odd ^= slot != start;
+		}
+	}
+	return odd;
+}
+
+/// @brief The slots the wings belong to, found by their colours
+/// @param colour_faces The face every colour belongs to
+[[nodiscard]] std::optional<orbit_homes> wing_homes(const big_cube &cube, const piece_orbit &orbit,
+	const std::array<uint8_t, face_count> &colour_faces) noexcept {
+	const auto area{ cube.size() * cube.size() };
+	const auto colour_of{ [&cube, &colour_faces, area](const uint16_t sticker) {
+		return colour_faces[cube.face_data(static_cast<face>(sticker / area))[sticker % area]];
+	} };
+
+	orbit_homes homes{};
+	uint32_t seen{};
+	for (size_t slot{}; slot < orbit_slots; ++slot) {
+		const auto &stickers{ orbit.stickers[slot] };
+		const auto home{ orbit.wing_slots[colour_of(stickers[0]) * face_count + colour_of(stickers[1])] };
+		if (home == no_slot || (seen & (1u << home)) != 0) {
+			return std::nullopt;
+		}
+		homes[slot] = home;
+		seen |= 1u << home;
+	}
+	return homes;
+}
+
+/// @brief The slots the centres go to. The four centres of a colour are alike, so every
+/// misplaced one is given a free slot of its colour, and when the cycles come out odd two of
+/// the centres of a colour trade their slots.
+[[nodiscard]] std::optional<orbit_homes> centre_homes(const big_cube &cube, const piece_orbit &orbit,
+	const std::array<uint8_t, face_count> &colour_faces) noexcept {
+	const auto area{ cube.size() * cube.size() };
+	std::array<uint8_t, orbit_slots> colours{};
+	std::array<std::array<uint8_t, orbit_slots>, face_count> free_slots{};
+	std::array<uint8_t, face_count> free_count{};
+	for (size_t slot{}; slot < orbit_slots; ++slot) {
+		const auto sticker{ orbit.stickers[slot][0] };
+		colours[slot] = colour_faces[cube.face_data(static_cast<face>(sticker / area))[sticker % area]];
+		const auto home_face{ sticker / area };
+		if (colours[slot] != home_face) {
+			free_slots[home_face][free_count[home_face]++] = static_cast<uint8_t>(slot);
+		}
+	}
+
+	orbit_homes homes{};
+	std::array<uint8_t, face_count> taken{};
+	for (size_t slot{}; slot < orbit_slots; ++slot) {
+		const auto colour{ colours[slot] };
+		if (colour == orbit.stickers[slot][0] / area) {
+			homes[slot] = static_cast<uint8_t>(slot);
+		} else if (taken[colour] < free_count[colour]) {
+			homes[slot] = free_slots[colour][taken[colour]++];
+		} else {
+			return std::nullopt;
+		}
+	}
+
+	if (odd_permutation(homes)) {
+		size_t misplaced{};
+		while (homes[misplaced] == misplaced) {
+			++misplaced;
+		}
+		for (size_t slot{}; slot < orbit_slots; ++slot) {
+			if (slot != misplaced && colours[slot] == colours[misplaced]) {
+				std::swap(homes[slot], homes[misplaced]);
+				break;
+			}
+		}
+	}
+	return homes;
+}
+
+/// @brief Brings every piece of the orbit to its slot by 3-cycles; two of the pieces trading
+/// places take one more cycle through a third misplaced one
+/// @returns false if the permutation is odd
+[[nodiscard]] bool solve_orbit(const reduction_tables &tables, const piece_orbit &orbit, orbit_homes homes,
+	std::vector<turn> &output) {
+	// the pieces at a, b and c go to b, c and a
+	const auto cycle{ [&](const uint8_t a, const uint8_t b, const uint8_t c) {
+		append_cycle(tables, orbit, cycle_index(a, b, c), output);
+		const auto last{ homes[c] };
+		homes[c] = homes[b];
+		homes[b] = homes[a];
+		homes[a] = last;
+	} };
+
+	for (uint8_t a{}; a < orbit_slots; ++a) {
+		while (homes[a] != a) {
+			const auto b{ homes[a] };
+			if (const auto c{ homes[b] }; c != a) {
+				cycle(a, b, c);
+				continue;
+			}
+			uint8_t third{ 0 };
+			while (third < orbit_slots && (homes[third] == third || third == a || third == b)) {
+				++third;
+			}
+			if (third == orbit_slots) {
+				return false;
+			}
+			cycle(a, b, third);
+		}
+	}
+	return true;
+}
+
+} // anonymous namespace
+
+reduction_solver::reduction_solver(std::shared_ptr<const two_phase_tables> tables,
+	std::shared_ptr<const pocket_table> pocket, const size_t threads)
+	: m_pocket{ std::move(pocket) } {
+	if (tables) {
+		m_solver.emplace(std::move(tables));
+	}
+	if (threads != 1) {
+		m_pool = std::make_unique<core::tools::task_pool>(threads);
+	}
+}
+
+std::optional<move_sequence> reduction_solver::solve_outer(const cube_state &state,
+	const two_phase_options &options) const {
+	if (!m_pool) {
+		return m_solver->solve(state, options);
+	}
+
+	// a search per thread, each one interleaving its variants like a single search does; the
+	// first solution short enough stops all of them
+	const auto deadline{ reduction_clock::now() + options.timeout };
+	std::atomic<uint8_t> shortest{ static_cast<uint8_t>(options.max_length + 1) };
+	std::mutex best_mutex;
+	std::optional<move_sequence> best;
+	core::tools::task_group searches;
+	const auto search_count{ std::min(m_pool->size(), two_phase_solver::variant_count) };
+	for (size_t search{}; search < search_count; ++search) {
+		uint8_t variants{};
+		for (auto variant{ search }; variant < two_phase_solver::variant_count; variant += search_count) {
+			variants |= static_cast<uint8_t>(1u << variant);
+		}
+		m_pool->submit(searches, [&, variants] {
+			auto variant_options{ options };
+			variant_options.variants = static_cast<uint8_t>(options.variants & variants);
+			variant_options.shared_length = &shortest;
+			// the searches share the deadline of the stage, however late one of them starts
+			variant_options.timeout = std::max(std::chrono::milliseconds{ 0 },
+				std::chrono::duration_cast<std::chrono::milliseconds>(deadline - reduction_clock::now()));
+			auto solution{ m_solver->solve(state, variant_options) };
+
+			std::lock_guard lock{ best_mutex };
+			if (solution && (!best || solution->size() < best->size())) {
+				best = std::move(solution);
+			}
+		});
+	}
+	m_pool->wait(searches);
+	return best;
+}
+
+bool reduction_solver::prepare(const size_t size) {
+	if (size < min_size || size > max_size) {
+		return false;
+	}
+	static_cast<void>(reduction_tables_of(size));
+	return true;
+}
+
+std::optional<reduction_solution> reduction_solver::solve(const big_cube &scrambled,
+	const reduction_options &options) const {
+	const auto start{ reduction_clock::now() };
+	const auto size{ scrambled.size() };
+	if (!prepare(size)) {
+		spdlog::error("[reduction_solver::solve] The {}x{} cube isn't supported", size, size);
+		return std::nullopt;
+	}
+	const bool odd{ size % 2 == 1 };
+	if (odd ? !m_solver : !m_pocket) {
+		spdlog::error("[reduction_solver::solve] No {} table to solve the {}x{} cube", odd ? "two-phase" : "2x2", size, size);
+		return std::nullopt;
+	}
+	const auto &tables{ reduction_tables_of(size) };
+
+	auto cube{ scrambled };
+	reduction_solution solution;
+
+	// the outer layers as a 3x3, the colours named by the core centres; an even cube has no
+	// middle edges and centres, they're made up solved and only the corners count
+	auto stage_start{ reduction_clock::now() };
+	std::array<uint8_t, face_count> colour_faces{ 0, 1, 2, 3, 4, 5 };
+	const auto middle{ size / 2 };
+	if (odd) {
+		for (size_t f{}; f < face_count; ++f) {
+			colour_faces[static_cast<size_t>(cube.at(static_cast<face>(f), middle, middle))] = static_cast<uint8_t>(f);
+		}
+	}
+	std::string facelets(facelet_count, ' ');
+	for (size_t f{}; f < face_count; ++f) {
+		for (size_t i{}; i < facelets_per_face; ++i) {
+			const auto row{ i / 3 };
+			const auto column{ i % 3 };
+			auto colour{ static_cast<uint8_t>(f) };
+			if (odd || (row != 1 && column != 1)) {
+				const auto to_layer{ [middle, size](const size_t index) { return index == 0 ? 0 : index == 2 ? size - 1 : middle; } };
+				colour = colour_faces[static_cast<size_t>(cube.at(static_cast<face>(f), to_layer(row), to_layer(column)))];
+			}
+			facelets[f * facelets_per_face + i] = facelet_letters[colour];
+		}
+	}
+	const auto outer_facelets{ facelet_cube::from_string(facelets) };
+	const auto cubies{ outer_facelets ? outer_facelets->to_cubies() : std::nullopt };
+	if (!cubies || (odd && !is_solvable(*cubies))) {
+		spdlog::error("[reduction_solver::solve] The corners and edges of the {}x{} cube aren't valid", size, size);
+		return std::nullopt;
+	}
+	const auto state{ cube_state::from_cubies(*cubies) };
+	const auto outer{ odd ? solve_outer(state, options.outer) : m_pocket->solve(state) };
+	if (!outer) {
+		spdlog::error("[reduction_solver::solve] The outer layers of the {}x{} cube weren't solved", size, size);
+		return std::nullopt;
+	}
+	for (const auto m : *outer) {
+		cube.apply(m);
+		append_turn(solution.turns, to_turn(m));
+	}
+	if (!odd) {
+		// the corners of a 2x2 are solved however the cube is held
+		for (size_t f{}; f < face_count; ++f) {
+			colour_faces[static_cast<size_t>(cube.at(static_cast<face>(f), 0, 0))] = static_cast<uint8_t>(f);
+		}
+	}
+	solution.timings.outer = elapsed_since(stage_start);
+
+	// a quarter turn of an inner layer is a 4-cycle of its wing orbit; the face turns are two
+	stage_start = reduction_clock::now();
+	for (const auto &orbit : tables.orbits) {
+		if (!orbit.wings) continue;
+		const auto homes{ wing_homes(cube, orbit, colour_faces) };
+		if (!homes) {
+			spdlog::error("[reduction_solver::solve] The wings of the {}x{} cube aren't valid", size, size);
+			return std::nullopt;
+		}
+		if (odd_permutation(*homes)) {
+			const turn parity{ turn_kind::face, face::R, 1, static_cast<uint8_t>(orbit.depth + 1) };
+			cube.turn_layer(parity.direction, orbit.depth, parity.power);
+			append_turn(solution.turns, parity);
+		}
+	}
+	solution.timings.parity = elapsed_since(stage_start);
+
+	// the 3-cycles of an orbit move nothing else, so every orbit is solved on its own. An orbit
+	// takes microseconds, less than handing it to the pool, so they're solved on this thread
+	stage_start = reduction_clock::now();
+	const auto orbit_count{ tables.orbits.size() };
+	std::vector<std::vector<turn>> orbit_turns(orbit_count);
+	std::vector<std::chrono::microseconds> orbit_times(orbit_count);
+	std::vector<uint8_t> orbit_solved(orbit_count);
+	for (size_t index{}; index < orbit_count; ++index) {
+		const auto orbit_start{ reduction_clock::now() };
+		const auto &orbit{ tables.orbits[index] };
+		const auto homes{ orbit.wings ? wing_homes(cube, orbit, colour_faces) : centre_homes(cube, orbit, colour_faces) };
+		orbit_solved[index] = homes && solve_orbit(tables, orbit, *homes, orbit_turns[index]);
+		orbit_times[index] = elapsed_since(orbit_start);
+	}
+	solution.timings.orbits = elapsed_since(stage_start);
+
+	for (size_t index{}; index < orbit_count; ++index) {
+		if (!orbit_solved[index]) {
+			spdlog::error("[reduction_solver::solve] The orbit {} of the {}x{} cube can't be solved", index, size, size);
+			return std::nullopt;
+		}
+		(tables.orbits[index].wings ? solution.timings.wings : solution.timings.centres) += orbit_times[index];
+		for (const auto &t : orbit_turns[index]) {
+			append_turn(solution.turns, t);
+		}
+	}
+	solution.timings.total = elapsed_since(start);
+	return solution;
+}
+
+} // namespace gzn::game::magicube
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <optional>
+#include <cinttypes>
+
+#include <core/tools/task_pool.hpp>
+
+#include "game/magicube/cube/big_cube.hpp"
+#include "game/magicube/cube/notation.hpp"
+#include "game/magicube/solver/pocket_table.hpp"
+#include "game/magicube/solver/two_phase_solver.hpp"
+
+namespace gzn::game::magicube {
+
+/// @brief How long every stage of a solve took. `centres` and `wings` add up the time of their
+/// orbits and `orbits` is the wall time of the stage, the orbits being solved one after another.
+struct reduction_timings {
+	/// The corners and the middle edges as a 3x3, or the corners as a 2x2 on the even sizes
+	std::chrono::microseconds outer{};
+	std::chrono::microseconds parity{};
+	std::chrono::microseconds centres{};
+	std::chrono::microseconds wings{};
+	std::chrono::microseconds orbits{};
+	std::chrono::microseconds total{};
+};
+
+struct reduction_solution {
+	/// Face turns only, the inner layers as `3R`
+	std::vector<turn> turns;
+	reduction_timings timings;
+};
+
+struct reduction_options {
+	/// The 3x3 stage takes the first solution, the rest of the solve is a few hundred turns
+	/// anyway. With a pool, its variants are searched by several tasks at once, so `improved`
+	/// is called from them
+	two_phase_options outer{ 24, 30, std::chrono::milliseconds{ 500 } };
+};
+
+/// @brief Solves the 4x4 to 7x7 by reduction with pure commutators. The corners, with the
+/// middle edges of the odd sizes, are solved first as a 2x2 or a 3x3, the 3x3 by two-phase
+/// searches of its variants on the task pool. A wing orbit, the wings at the same depth, is then
+/// brought to an even permutation by a quarter turn of its inner layer, and at last every centre
+/// orbit and every wing orbit is solved by 3-cycles which move nothing else.
+///
+/// The 3-cycles are the commutators [X s X', t] for the centres and [s, X m X'] for the wings, X
+/// and m being face turns and s and t inner layers, conjugated by a breadth-first search over
+/// the layer turns until every 3-cycle of an orbit is known. They're generated once for every
+/// size, when the size is solved for the first time or by `prepare`.
+class reduction_solver {
+public:
+	static constexpr size_t min_size{ 4 };
+	static constexpr size_t max_size{ 7 };
+
+	/// @param tables Solve the odd sizes, may be null if only the even ones are solved
+	/// @param pocket Solves the even sizes, may be null if only the odd ones are solved
+	/// @param threads The 3x3 stage is searched on the calling thread when it's 1; 0 means every
+	/// hardware thread
+	reduction_solver(std::shared_ptr<const two_phase_tables> tables, std::shared_ptr<const pocket_table> pocket,
+		const size_t threads = 0);
+
+	/// @brief Generates the 3-cycles of the @p size ahead of the first solve
+	/// @returns false if the size is out of `[min_size, max_size]`
+	static bool prepare(const size_t size);
+
+	/// @returns Nothing if the size isn't supported, its table isn't there or the stickers don't
+	/// form a cube
+	[[nodiscard]] std::optional<reduction_solution> solve(const big_cube &cube,
+		const reduction_options &options = {}) const;
+
+private:
+	std::optional<two_phase_solver> m_solver;
+	std::shared_ptr<const pocket_table> m_pocket;
+	/// Solves share the pool, each one waits only for the task group of its own searches
+	std::unique_ptr<core::tools::task_pool> m_pool;
+
+	[[nodiscard]] std::optional<move_sequence> solve_outer(const cube_state &state,
+		const two_phase_options &options) const;
+};
+
+} // namespace gzn::game::magicube
@@ -0,0 +1,147 @@
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+
+#include "game/magicube/solver/solver_service.hpp"
+
+namespace gzn::game::magicube {
+
+namespace {
+
+using service_clock = std::chrono::steady_clock;
+
+[[nodiscard]] size_t service_threads(const size_t threads) noexcept {
+	if (threads != 0) return threads;
+	// the frame loop keeps a thread of its own
+	const auto available{ std::max(std::thread::hardware_concurrency(), 2u) - 1 };
+	return std::min<size_t>(available, two_phase_solver::variant_count);
+}
+
+} // anonymous namespace
+
+solver_service::solver_service(tables_future tables, const two_phase_options &options, const size_t threads)
+	: m_tables{ std::move(tables) }
+	, m_options{ options }
+	, m_pool{ service_threads(threads) } {
+	m_options.cancel = &m_cancel;
+	m_thread = std::thread{ [this] { work(); } };
+}
+
+solver_service::~solver_service() {
+	{
+		std::lock_guard lock{ m_mutex };
+		m_stopping = true;
+		m_pending.reset();
+	}
+	m_cancel.store(true, std::memory_order_relaxed);
+	m_wake.notify_one();
+	m_thread.join();
+}
+
+uint64_t solver_service::request(const cube_state &state) {
+	std::lock_guard lock{ m_mutex };
+	m_pending = pending_request{ state, ++m_current };
+	m_update.reset();
+	m_published_length = 0;
+	m_cancel.store(true, std::memory_order_relaxed);
+	m_wake.notify_one();
+	return m_current;
+}
+
+void solver_service::cancel() {
+	std::lock_guard lock{ m_mutex };
+	++m_current;
+	m_pending.reset();
+	m_update.reset();
+	m_published_length = 0;
+	m_cancel.store(true, std::memory_order_relaxed);
+}
+
+std::optional<solver_update> solver_service::poll() {
+	std::lock_guard lock{ m_mutex };
+	return std::exchange(m_update, std::nullopt);
+}
+
+void solver_service::work() {
+	for (;;) {
+		pending_request next;
+		{
+			std::unique_lock lock{ m_mutex };
+			m_wake.wait(lock, [this] { return m_stopping || m_pending.has_value(); });
+			if (m_stopping) return;
+
+			next = *std::exchange(m_pending, std::nullopt);
+			m_cancel.store(false, std::memory_order_relaxed);
+			m_busy.store(true, std::memory_order_relaxed);
+		}
+
+		const auto tables{ m_tables.get() };
+		if (!tables) {
+			spdlog::error("[solver_service::work] The solver tables aren't available");
+			publish(next.id, nullptr, true);
+			m_busy.store(false, std::memory_order_relaxed);
+			continue;
+		}
+
+		const two_phase_solver solver{ tables };
+		const auto deadline{ service_clock::now() + m_options.timeout };
+		std::atomic<uint8_t> shortest{ static_cast<uint8_t>(m_options.max_length + 1) };
+		auto options{ m_options };
+		options.shared_length = &shortest;
+		options.improved = [this, id = next.id](const move_sequence &solution) {
+			publish(id, &solution, false);
+		};
+
+		std::mutex best_mutex;
+		std::optional<move_sequence> best;
+		core::tools::task_group searches;
+		// a search per thread, each one interleaving its variants like a single search does
+		const auto search_count{ std::min(m_pool.size(), two_phase_solver::variant_count) };
+		for (size_t search{}; search < search_count; ++search) {
+			uint8_t variants{};
+			for (auto variant{ search }; variant < two_phase_solver::variant_count; variant += search_count) {
+				variants |= static_cast<uint8_t>(1u << variant);
+			}
+			m_pool.submit(searches, [&, variants] {
+				auto variant_options{ options };
+				variant_options.variants = variants;
+				// the searches share the deadline of the request, however late one of them starts
+				variant_options.timeout = std::max(std::chrono::milliseconds{ 0 },
+					std::chrono::duration_cast<std::chrono::milliseconds>(deadline - service_clock::now()));
+				auto solution{ solver.solve(next.state, variant_options) };
+
+				std::lock_guard lock{ best_mutex };
+				if (solution && (!best || solution->size() < best->size())) {
+					best = std::move(solution);
+				}
+			});
+		}
+		m_pool.wait(searches);
+
+		publish(next.id, best ? &*best : nullptr, true);
+		m_busy.store(false, std::memory_order_relaxed);
+	}
+}
+
+void solver_service::publish(const uint64_t id, const move_sequence *solution, const bool final) {
+	std::lock_guard lock{ m_mutex };
+	// the request was replaced or cancelled meanwhile
+	if (id != m_current) return;
+
+	// the searches of the variants find their solutions in any order
+	const bool shorter{ solution != nullptr && (m_published_length == 0 || solution->size() < m_published_length) };
+	if (!shorter && !final) return;
+
+	if (!m_update) {
+		m_update = solver_update{ id, std::nullopt, false };
+	}
+	if (solution != nullptr) {
+		m_update->solution = *solution;
+		m_published_length = std::min(m_published_length == 0 ? solution->size() : m_published_length, solution->size());
+	}
+	m_update->final = final;
+}
+
+} // namespace gzn::game::magicube
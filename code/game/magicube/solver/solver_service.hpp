@@ -0,0 +1,82 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <thread>
+#include <optional>
+#include <condition_variable>
+#include <core/tools/task_pool.hpp>
+
+#include "game/magicube/cube/cube_state.hpp"
+#include "game/magicube/solver/two_phase_solver.hpp"
+
+namespace gzn::game::magicube {
+
+struct solver_update {
+	uint64_t request{};
+	/// The shortest solution so far
+	std::optional<move_sequence> solution;
+	/// No shorter solution is coming for this request
+	bool final{ false };
+};
+
+/// @brief Solves on worker threads, so the frame loop only polls for the results. The six
+/// variants of the two-phase search, the cube seen from three axes and its inverse, are split
+/// between the threads of a pool, and the searches share the shortest length found. Every
+/// solution shorter than the previous one is published as soon as it's found, and a new request
+/// or a cancellation stops the searches which are running.
+class solver_service {
+public:
+	using tables_future = std::shared_future<std::shared_ptr<const two_phase_tables>>;
+
+	/// @param tables Waited for on the solver thread, never on the caller's one
+	/// @param threads Of the pool, 0 means every hardware thread but the caller's, one per
+	/// variant at most
+	solver_service(tables_future tables, const two_phase_options &options, size_t threads = 0);
+	~solver_service();
+
+	solver_service(const solver_service &other) = delete;
+	solver_service &operator=(const solver_service &other) = delete;
+
+	/// @brief Drops the current request and starts solving @p state
+	/// @returns The id which the updates of this request carry
+	uint64_t request(const cube_state &state);
+	void cancel();
+
+	/// @brief Never blocks
+	/// @returns The newest update since the previous poll
+	[[nodiscard]] std::optional<solver_update> poll();
+
+	[[nodiscard]] bool busy() const noexcept { return m_busy.load(std::memory_order_relaxed); }
+
+private:
+	struct pending_request {
+		cube_state state;
+		uint64_t id{};
+	};
+
+	tables_future m_tables;
+	two_phase_options m_options;
+
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::optional<pending_request> m_pending;
+	std::optional<solver_update> m_update;
+	/// Of the shortest solution published for the current request, 0 before the first one
+	size_t m_published_length{};
+	uint64_t m_current{};
+	bool m_stopping{ false };
+
+	std::atomic<bool> m_cancel{ false };
+	std::atomic<bool> m_busy{ false };
+	core::tools::task_pool m_pool;
+	/// Takes the requests and waits for their searches on the pool
+	std::thread m_thread;
+
+	void work();
+	void publish(const uint64_t id, const move_sequence *solution, const bool final);
+};
+
+} // namespace gzn::game::magicube
@@ -0,0 +1,127 @@
+#include <cstring>
+#include <type_traits>
+
+#include <spdlog/spdlog.h>
+
+#include "game/magicube/solver/transposition_table.hpp"
+
+namespace gzn::game::magicube {
+
+namespace {
+
+struct transposition_key {
+	uint64_t index;
+	uint64_t check;
+};
+
+/// The corners take 40 bits and the context 3, so `(corners << 3) | context` loses nothing
+transposition_key make_key(const cube_state &state, const uint8_t context) noexcept {
+	const auto corners{ (state.corners() << 3) | context };
+	return {
+		detail::mix(state.edges() ^ detail::mix(corners)),
+		detail::mix(state.edges() * 0x9E3779B97F4A7C15ull + detail::mix(~corners)) | 1,
+	};
+}
+
+std::atomic<size_t> next_transposition_stripe{ 0 };
+
+} // anonymous namespace
+
+std::unique_ptr<transposition_table> transposition_table::create(const size_t mib) {
+	const auto requested{ (mib << 20) / sizeof(bucket) };
+	if (requested == 0) {
+		spdlog::error("[transposition_table::create] {} MiB is too small", mib);
+		return nullptr;
+	}
+	size_t buckets{ 1 };
+	while (buckets * 2 <= requested) buckets *= 2;
+
+	auto memory{ core::tools::page_buffer::allocate(buckets * sizeof(bucket)) };
+	if (!memory) {
+		return nullptr;
+	}
+	spdlog::info("[transposition_table::create] {} MiB, {} entries{}", memory->size() >> 20,
+		buckets * bucket_size, memory->huge_pages() ? ", huge pages" : "");
+	return std::unique_ptr<transposition_table>{ new transposition_table{ std::move(*memory), buckets } };
+}
+
+transposition_table::transposition_table(core::tools::page_buffer &&memory, const size_t buckets) noexcept
+	: m_memory{ std::move(memory) }
+	, m_buckets{ reinterpret_cast<bucket *>(m_memory.data()) }
+	, m_mask{ buckets - 1 } {
+	// the pages come zeroed and an all-zero entry is an empty one
+	static_assert(std::is_trivially_destructible_v<bucket>);
+}
+
+uint8_t transposition_table::lower_bound(const cube_state &state, const uint8_t context) noexcept {
+	const auto key{ make_key(state, context) };
+	auto &target{ m_buckets[key.index & m_mask] };
+	for (auto &entry : target.entries) {
+		const auto data{ entry.data.load(std::memory_order_relaxed) };
+		if (data != 0 && (entry.lock.load(std::memory_order_relaxed) ^ data) == key.check) {
+			local_counters().hits.fetch_add(1, std::memory_order_relaxed);
+			return static_cast<uint8_t>(data);
+		}
+	}
+	local_counters().misses.fetch_add(1, std::memory_order_relaxed);
+	return 0;
+}
+
+void transposition_table::store(const cube_state &state, const uint8_t context, const uint8_t bound) noexcept {
+	const auto key{ make_key(state, context) };
+	auto &target{ m_buckets[key.index & m_mask] };
+
+	entry *victim{ nullptr };
+	uint64_t victim_data{ ~uint64_t{} };
+	for (auto &entry : target.entries) {
+		const auto data{ entry.data.load(std::memory_order_relaxed) };
+		if (data != 0 && (entry.lock.load(std::memory_order_relaxed) ^ data) == key.check) {
+			if (data >= bound) return;
+			victim = &entry;
+			victim_data = 0;
+			break;
+		}
+		if (data < victim_data) {
+			victim = &entry;
+			victim_data = data;
+		}
+	}
+	// the deeper entries saved more work, they stay
+	if (victim_data > bound) return;
+
+	auto &counters{ local_counters() };
+	counters.stores.fetch_add(1, std::memory_order_relaxed);
+	if (victim_data != 0) {
+		counters.collisions.fetch_add(1, std::memory_order_relaxed);
+	}
+	victim->lock.store(key.check ^ bound, std::memory_order_relaxed);
+	victim->data.store(bound, std::memory_order_relaxed);
+}
+
+void transposition_table::clear() noexcept {
+	std::memset(static_cast<void *>(m_buckets), 0, m_memory.size());
+	for (auto &stripe : m_counters) {
+		stripe.hits = 0;
+		stripe.misses = 0;
+		stripe.collisions = 0;
+		stripe.stores = 0;
+	}
+}
+
+transposition_statistics transposition_table::statistics() const noexcept {
+	transposition_statistics result;
+	for (const auto &stripe : m_counters) {
+		result.hits += stripe.hits.load(std::memory_order_relaxed);
+		result.misses += stripe.misses.load(std::memory_order_relaxed);
+		result.collisions += stripe.collisions.load(std::memory_order_relaxed);
+		result.stores += stripe.stores.load(std::memory_order_relaxed);
+	}
+	return result;
+}
+
+transposition_table::counters &transposition_table::local_counters() noexcept {
+	thread_local const size_t stripe{ next_transposition_stripe.fetch_add(1, std::memory_order_relaxed) };
+	return m_counters[stripe % counter_stripes];
+}
+
+} // namespace gzn::game::magicube
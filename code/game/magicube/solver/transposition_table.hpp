@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <cinttypes>
+
+#include <core/tools/page_buffer.hpp>
+
+#include "game/magicube/cube/cube_state.hpp"
+
+namespace gzn::game::magicube {
+
+struct transposition_statistics {
+	uint64_t hits{};
+	uint64_t misses{};
+	/// Stores which evicted an entry of another state
+	uint64_t collisions{};
+	uint64_t stores{};
+
+	[[nodiscard]] double hit_rate() const noexcept {
+		const auto probes{ hits + misses };
+		return probes > 0 ? static_cast<double>(hits) / static_cast<double>(probes) : 0.0;
+	}
+};
+
+/// @brief Lower bounds of the distances found by the searches, shared by all of the search
+/// threads without a lock. An entry is a pair of words: the data and the data xor the key.
+/// A torn write leaves a pair which doesn't match any key, so it reads as a miss.
+/// Buckets of four entries fill a cache line, and the entry with the lowest bound is replaced.
+class transposition_table {
+public:
+	/// No restriction on the next move
+	static constexpr uint8_t no_context{ face_count };
+
+	/// @param mib Size of the table, rounded down to a power of two of buckets
+	[[nodiscard]] static std::unique_ptr<transposition_table> create(const size_t mib);
+
+	/// @param context The face turned last, the search skips some of the moves after it
+	/// @returns The lower bound of the distance of @p state, 0 when unknown
+	[[nodiscard]] uint8_t lower_bound(const cube_state &state, const uint8_t context) noexcept;
+
+	/// @brief Records that @p state is at least @p bound moves away from the solved state
+	void store(const cube_state &state, const uint8_t context, const uint8_t bound) noexcept;
+
+	void clear() noexcept;
+
+	[[nodiscard]] transposition_statistics statistics() const noexcept;
+	[[nodiscard]] size_t capacity() const noexcept { return (m_mask + 1) * bucket_size; }
+	[[nodiscard]] size_t bytes() const noexcept { return m_memory.size(); }
+	[[nodiscard]] bool huge_pages() const noexcept { return m_memory.huge_pages(); }
+
+private:
+	static constexpr size_t bucket_size{ 4 };
+	static constexpr size_t counter_stripes{ 16 };
+
+	struct entry {
+		std::atomic<uint64_t> lock;
+		std::atomic<uint64_t> data;
+	};
+
+	struct alignas(64) bucket {
+		std::array<entry, bucket_size> entries;
+	};
+
+	/// The threads count into different cache lines
+	struct alignas(64) counters {
+		std::atomic<uint64_t> hits{ 0 };
+		std::atomic<uint64_t> misses{ 0 };
+		std::atomic<uint64_t> collisions{ 0 };
+		std::atomic<uint64_t> stores{ 0 };
+	};
+
+	core::tools::page_buffer m_memory;
+	bucket *m_buckets{ nullptr };
+	uint64_t m_mask{};
+	std::array<counters, counter_stripes> m_counters{};
+
+	transposition_table(core::tools::page_buffer &&memory, const size_t buckets) noexcept;
+
+	[[nodiscard]] counters &local_counters() noexcept;
+};
+
+} // namespace gzn::game::magicube
@@ -0,0 +1,267 @@
+#include <array>
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+#include <core/tools/bits.hpp>
+
+#include "game/magicube/solver/two_phase_solver.hpp"
+
+namespace gzn::game::magicube {
+
+namespace {
+
+constexpr size_t max_search_depth{ 32 };
+constexpr uint32_t timeout_check_interval{ 4096 };
+
+/// Long phase 2 searches are expensive; another phase 1 solution is a cheaper way to go
+constexpr size_t max_phase2_length{ 10 };
+
+/// A phase 1 solution which ends with a phase 2 move would have been found a move earlier
+constexpr bool ends_phase1(const move last) noexcept {
+	const auto f{ face_of(last) };
+	return f != face::U && f != face::D && power_of(last) != 2;
+}
+
+/// 120 degrees clockwise rotation of the whole cube around the URF-DBL diagonal
+constexpr cubie_cube urf_rotation{
+	{ 0, 4, 5, 1, 3, 7, 6, 2 }, { 1, 2, 1, 2, 2, 1, 2, 1 },
+	{ 1, 8, 5, 9, 3, 11, 7, 10, 0, 4, 6, 2 }, { 1, 0, 1, 0, 1, 0, 1, 0, 1, 1, 1, 1 }
+};
+
+constexpr size_t axis_count{ 3 };
+constexpr size_t variant_count{ two_phase_solver::variant_count };
+static_assert(variant_count == axis_count * 2);
+
+/// rotated_moves[axis][m] is the move `m` seen from the cube rotated `axis` times
+constexpr auto rotated_moves{ [] {
+	std::array<std::array<move, move_count>, axis_count> table{};
+	const auto rotation_inverse{ inverse(urf_rotation) };
+	for (size_t m{}; m < move_count; ++m) {
+		table[0][m] = static_cast<move>(m);
+	}
+	for (size_t axis{ 1 }; axis < axis_count; ++axis) {
+		for (size_t m{}; m < move_count; ++m) {
+			const auto turned{ apply(cubie_cube{}, table[axis - 1][m]) };
+			const auto conjugated{ multiply(multiply(rotation_inverse, turned), urf_rotation) };
+			for (size_t candidate{}; candidate < move_count; ++candidate) {
+				if (apply(cubie_cube{}, static_cast<move>(candidate)) == conjugated) {
+					table[axis][m] = static_cast<move>(candidate);
+				}
+			}
+		}
+	}
+	return table;
+}() };
+
+/// The search runs on the cube seen from three axes, and on its inverse for each of them.
+/// A short solution usually shows up much earlier in one of the six than in the original.
+struct search_variant {
+	cube_state state;
+	uint16_t twist{};
+	uint16_t flip{};
+	uint16_t slice{};
+	uint8_t lower_bound{};
+	uint8_t axis{};
+	bool inverted{ false };
+};
+
+class two_phase_search {
+public:
+	two_phase_search(const two_phase_tables &tables, const cube_state &state,
+		const two_phase_options &options) noexcept
+		: m_tables{ tables }
+		, m_options{ options }
+		, m_deadline{ std::chrono::steady_clock::now() + options.timeout }
+		, m_best_length{ static_cast<size_t>(options.max_length) + 1 } {
+		const auto rotation_inverse{ inverse(urf_rotation) };
+		auto cube{ state.to_cubies() };
+		for (size_t axis{}; axis < axis_count; ++axis) {
+			for (const bool inverted : { false, true }) {
+				const auto variant_cube{ inverted ? inverse(cube) : cube };
+				auto &variant{ m_variants[axis + (inverted ? axis_count : 0)] };
+				variant.state = cube_state::from_cubies(variant_cube);
+				variant.twist = coordinates::twist(variant_cube);
+				variant.flip = coordinates::flip(variant_cube);
+				variant.slice = coordinates::slice(variant_cube);
+				variant.lower_bound = tables.phase1_distance(variant.twist, variant.flip, variant.slice);
+				variant.axis = static_cast<uint8_t>(axis);
+				variant.inverted = inverted;
+			}
+			cube = multiply(multiply(rotation_inverse, cube), urf_rotation);
+		}
+	}
+
+	std::optional<move_sequence> run() {
+		for (size_t depth{}; depth < best_length() && depth <= m_options.max_length; ++depth) {
+			for (size_t index{}; index < variant_count; ++index) {
+				const auto &variant{ m_variants[index] };
+				if ((m_options.variants & (1u << index)) == 0 || variant.lower_bound > depth) continue;
+
+				m_variant = &variant;
+				if (phase1(variant.twist, variant.flip, variant.slice, 0, depth) || m_timed_out) {
+					return result();
+				}
+			}
+		}
+		return result();
+	}
+
+private:
+	const two_phase_tables &m_tables;
+	const two_phase_options &m_options;
+	const std::chrono::steady_clock::time_point m_deadline;
+
+	std::array<search_variant, variant_count> m_variants{};
+	const search_variant *m_variant{ nullptr };
+
+	std::array<move, max_search_depth> m_moves{};
+	move_sequence m_best;
+	size_t m_best_length;
+	uint32_t m_nodes{};
+	bool m_timed_out{ false };
+
+	/// The length which a new solution has to beat, whichever search found the current one
+	[[nodiscard]] size_t best_length() const noexcept {
+		return m_options.shared_length != nullptr
+			? std::min<size_t>(m_best_length, m_options.shared_length->load(std::memory_order_relaxed))
+			: m_best_length;
+	}
+
+	std::optional<move_sequence> result() {
+		if (m_best_length > m_options.max_length) {
+			return std::nullopt;
+		}
+		return std::move(m_best);
+	}
+
+	/// Maps the moves found for the current variant back to the original cube
+	void store_best(const size_t length) {
+		if (auto *shared{ m_options.shared_length }; shared != nullptr) {
+			auto current{ shared->load(std::memory_order_relaxed) };
+			do {
+				// another search found one as short meanwhile
+				if (current <= length) return;
+			} while (!shared->compare_exchange_weak(current, static_cast<uint8_t>(length), std::memory_order_relaxed));
+		}
+		m_best_length = length;
+		m_best.resize(length);
+
+		const auto &back{ rotated_moves[(axis_count - m_variant->axis) % axis_count] };
+		for (size_t i{}; i < length; ++i) {
+			m_best[i] = back[static_cast<size_t>(m_moves[i])];
+		}
+		if (m_variant->inverted) {
+			std::reverse(m_best.begin(), m_best.end());
+			for (auto &m : m_best) {
+				m = inverse(m);
+			}
+		}
+		if (m_options.improved) {
+			m_options.improved(m_best);
+		}
+	}
+
+	bool out_of_time() noexcept {
+		if (++m_nodes % timeout_check_interval == 0) {
+			const bool cancelled{ m_options.cancel != nullptr && m_options.cancel->load(std::memory_order_relaxed) };
+			// another search reached the target
+			const bool done{ m_options.shared_length != nullptr
+				&& m_options.shared_length->load(std::memory_order_relaxed) <= m_options.target_length };
+			m_timed_out = cancelled || done || std::chrono::steady_clock::now() > m_deadline;
+		}
+		return m_timed_out;
+	}
+
+	/// @returns true when the search should stop
+	bool phase1(const uint16_t twist, const uint16_t flip, const uint16_t slice,
+		const size_t depth, const size_t to_go) {
+		if (to_go == 0) {
+			return (depth == 0 || ends_phase1(m_moves[depth - 1])) && start_phase2(depth);
+		}
+		if (out_of_time()) return true;
+
+		const auto last{ depth > 0 ? static_cast<size_t>(face_of(m_moves[depth - 1])) : face_count };
+		for (auto moves{ canonical_successors(last) }; moves != 0; moves &= moves - 1) {
+			const auto m{ static_cast<move>(core::tools::count_trailing_zeros(moves)) };
+
+			const auto next_slice{ m_tables.slice_move(slice, m) };
+			const auto next_twist{ m_tables.twist_move(twist, m) };
+			if (m_tables.slice_twist_distance(next_slice, next_twist) >= to_go) continue;
+
+			const auto next_flip{ m_tables.flip_move(flip, m) };
+			if (m_tables.slice_flip_distance(next_slice, next_flip) >= to_go) continue;
+
+			m_moves[depth] = m;
+			if (phase1(next_twist, next_flip, next_slice, depth + 1, to_go - 1)) return true;
+		}
+		return false;
+	}
+
+	bool start_phase2(const size_t phase1_length) {
+		const auto best{ best_length() };
+		if (phase1_length + 1 > best) return false;
+		const auto budget{ phase1_length == 0
+			? best - 1
+			: std::min(best - 1 - phase1_length, max_phase2_length) };
+
+		auto state{ m_variant->state };
+		state.apply(m_moves.begin(), m_moves.begin() + phase1_length);
+		const auto cube{ state.to_cubies() };
+		const auto corners{ coordinates::corner_permutation(cube) };
+		const auto edges{ coordinates::ud_edge_permutation(cube) };
+		const auto slice{ coordinates::slice_permutation(cube) };
+
+		for (size_t depth{ m_tables.phase2_distance(corners, edges, slice) }; depth <= budget; ++depth) {
+			if (phase2(corners, edges, slice, phase1_length, depth)) {
+				store_best(phase1_length + depth);
+				return best_length() <= m_options.target_length;
+			}
+			if (m_timed_out) return true;
+		}
+		return false;
+	}
+
+	/// @returns true when the cube is solved
+	bool phase2(const uint16_t corners, const uint16_t edges, const uint16_t slice,
+		const size_t depth, const size_t to_go) {
+		if (to_go == 0) {
+			return corners == 0 && edges == 0 && slice == 0;
+		}
+		if (out_of_time()) return false;
+
+		for (size_t k{}; k < two_phase_tables::phase2_move_count; ++k) {
+			const auto m{ two_phase_tables::phase2_moves[k] };
+			if (depth > 0 && !canonical_successor(face_of(m_moves[depth - 1]), face_of(m))) continue;
+
+			const auto next_corners{ m_tables.corner_permutation_move(corners, k) };
+			const auto next_edges{ m_tables.ud_edge_permutation_move(edges, k) };
+			const auto next_slice{ m_tables.slice_permutation_move(slice, k) };
+			if (m_tables.phase2_distance(next_corners, next_edges, next_slice) >= to_go) continue;
+
+			m_moves[depth] = m;
+			if (phase2(next_corners, next_edges, next_slice, depth + 1, to_go - 1)) return true;
+		}
+		return false;
+	}
+};
+
+} // anonymous namespace
+
+two_phase_solver::two_phase_solver(std::shared_ptr<const two_phase_tables> tables) noexcept
+	: m_tables{ std::move(tables) } {}
+
+std::optional<move_sequence> two_phase_solver::solve(const cube_state &state,
+	const two_phase_options &options) const {
+	if (!is_solvable(state.to_cubies())) {
+		spdlog::warn("[two_phase_solver::solve] The cube state isn't solvable");
+		return std::nullopt;
+	}
+	if (options.max_length >= max_search_depth) {
+		spdlog::warn("[two_phase_solver::solve] Max length {} is too big, the limit is {}",
+			options.max_length, max_search_depth - 1);
+		return std::nullopt;
+	}
+	return two_phase_search{ *m_tables, state, options }.run();
+}
+
+} // namespace gzn::game::magicube
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <functional>
+
+#include "game/magicube/cube/cube_state.hpp"
+#include "game/magicube/solver/two_phase_tables.hpp"
+
+namespace gzn::game::magicube {
+
+struct two_phase_options {
+	/// Searching stops as soon as a solution of this length or shorter is found
+	uint8_t target_length{ 20 };
+	/// Solutions longer than this are never returned
+	uint8_t max_length{ 24 };
+	/// When it runs out, the shortest solution found so far is returned
+	std::chrono::milliseconds timeout{ 1000 };
+	/// Another thread sets it to stop the search early, like the timeout does
+	const std::atomic<bool> *cancel{ nullptr };
+	/// Called from the searching thread with every solution shorter than the ones before
+	std::function<void(const move_sequence &)> improved{};
+	/// The cube is searched as seen from three axes and as its inverse from each of them: bit
+	/// `axis + 3 * inverted` is set for the variants which this search covers
+	uint8_t variants{ 0b111111 };
+	/// Shared by the searches of one cube which split the variants between threads: the length
+	/// of the shortest solution any of them found, so that each one only looks for shorter ones
+	std::atomic<uint8_t> *shared_length{ nullptr };
+};
+
+/// @brief Kociemba's two-phase algorithm. Phase 1 brings the cube into <U, D, R2, L2, F2, B2>
+/// and phase 2 solves it with these moves only. Each phase is an IDA* search over the
+/// coordinate move tables, and every phase 1 solution is tried with a shrinking total length.
+class two_phase_solver {
+public:
+	/// The variants of `two_phase_options::variants`
+	static constexpr size_t variant_count{ 6 };
+
+	explicit two_phase_solver(std::shared_ptr<const two_phase_tables> tables) noexcept;
+
+	[[nodiscard]] std::optional<move_sequence> solve(const cube_state &state,
+		const two_phase_options &options = {}) const;
+
+	[[nodiscard]] const two_phase_tables &tables() const noexcept { return *m_tables; }
+
+private:
+	std::shared_ptr<const two_phase_tables> m_tables;
+};
+
+} // namespace gzn::game::magicube
@@ -0,0 +1,215 @@
+#include <chrono>
+#include <fstream>
+
+#include <spdlog/spdlog.h>
+
+#include "game/magicube/solver/two_phase_tables.hpp"
+
+namespace gzn::game::magicube {
+
+namespace {
+
+constexpr uint32_t two_phase_file_magic{ 0x5054474D }; // "MGTP"
+constexpr uint32_t two_phase_file_version{ 1 };
+constexpr uint8_t unknown_distance{ 0x0F };
+
+template<class Set, class Get, size_t MovesCount>
+std::vector<uint16_t> make_move_table(const uint32_t count, const std::array<move, MovesCount> &moves,
+	Set &&set, Get &&get) {
+	std::vector<uint16_t> table(count * MovesCount);
+	for (uint32_t value{}; value < count; ++value) {
+		cubie_cube cube;
+		set(cube, static_cast<uint16_t>(value));
+		for (size_t k{}; k < MovesCount; ++k) {
+			table[value * MovesCount + k] = get(apply(cube, moves[k]));
+		}
+	}
+	return table;
+}
+
+/// Breadth-first search over the product of two coordinates. Distances are stored as nibbles.
+template<class Next>
+std::vector<uint8_t> make_pruning_table(const size_t size, const size_t moves_count, Next &&next) {
+	std::vector<uint8_t> table((size + 1) / 2, 0xFF);
+	const auto get{ [&table](const size_t index) -> uint8_t {
+		return (table[index >> 1] >> ((index & 1) << 2)) & 0x0F;
+	} };
+	const auto set{ [&table](const size_t index, const uint8_t value) {
+		const auto shift{ (index & 1) << 2 };
+		table[index >> 1] = static_cast<uint8_t>((table[index >> 1] & ~(0x0F << shift)) | (value << shift));
+	} };
+
+	set(0, 0);
+	size_t done{ 1 };
+	for (uint8_t depth{}; done < size && depth + 1 < unknown_distance; ++depth) {
+		for (size_t index{}; index < size; ++index) {
+			if (get(index) != depth) continue;
+
+			for (size_t k{}; k < moves_count; ++k) {
+				if (const auto neighbour{ next(index, k) }; get(neighbour) == unknown_distance) {
+					set(neighbour, depth + 1);
+					++done;
+				}
+			}
+		}
+	}
+	return table;
+}
+
+template<class T>
+void write_table(std::ofstream &file, const std::vector<T> &table) {
+	const uint64_t size{ table.size() };
+	file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+	file.write(reinterpret_cast<const char *>(table.data()), static_cast<std::streamsize>(size * sizeof(T)));
+}
+
+template<class T>
+bool read_table(std::ifstream &file, std::vector<T> &table, const size_t expected_size) {
+	uint64_t size{};
+	if (!file.read(reinterpret_cast<char *>(&size), sizeof(size)) || size != expected_size) {
+		return false;
+	}
+	table.resize(expected_size);
+	return static_cast<bool>(file.read(reinterpret_cast<char *>(table.data()),
+		static_cast<std::streamsize>(size * sizeof(T))));
+}
+
+constexpr std::array<move, move_count> all_moves{ [] {
+	std::array<move, move_count> moves{};
+	for (size_t m{}; m < move_count; ++m) {
+		moves[m] = static_cast<move>(m);
+	}
+	return moves;
+}() };
+
+constexpr size_t slice_twist_size{ coordinates::slice_count * coordinates::twist_count };
+constexpr size_t slice_flip_size{ coordinates::slice_count * coordinates::flip_count };
+constexpr size_t slice_corner_size{ coordinates::slice_permutation_count * coordinates::corner_permutation_count };
+constexpr size_t slice_edge_size{ coordinates::slice_permutation_count * coordinates::ud_edge_permutation_count };
+
+} // anonymous namespace
+
+std::shared_ptr<const two_phase_tables> two_phase_tables::generate() {
+	namespace coords = coordinates;
+	auto tables{ std::make_shared<two_phase_tables>() };
+
+	tables->m_twist_moves = make_move_table(coords::twist_count, all_moves, &coords::set_twist, &coords::twist);
+	tables->m_flip_moves = make_move_table(coords::flip_count, all_moves, &coords::set_flip, &coords::flip);
+	tables->m_slice_moves = make_move_table(coords::slice_count, all_moves, &coords::set_slice, &coords::slice);
+	tables->m_corner_permutation_moves = make_move_table(coords::corner_permutation_count, phase2_moves,
+		&coords::set_corner_permutation, &coords::corner_permutation);
+	tables->m_ud_edge_permutation_moves = make_move_table(coords::ud_edge_permutation_count, phase2_moves,
+		&coords::set_ud_edge_permutation, &coords::ud_edge_permutation);
+	tables->m_slice_permutation_moves = make_move_table(coords::slice_permutation_count, phase2_moves,
+		&coords::set_slice_permutation, &coords::slice_permutation);
+
+	const auto &t{ *tables };
+	tables->m_slice_twist_pruning = make_pruning_table(slice_twist_size, move_count,
+		[&t](const size_t index, const size_t k) {
+			const auto m{ static_cast<move>(k) };
+			const auto slice{ t.slice_move(static_cast<uint16_t>(index / coords::twist_count), m) };
+			const auto twist{ t.twist_move(static_cast<uint16_t>(index % coords::twist_count), m) };
+			return size_t{ slice } * coords::twist_count + twist;
+		});
+	tables->m_slice_flip_pruning = make_pruning_table(slice_flip_size, move_count,
+		[&t](const size_t index, const size_t k) {
+			const auto m{ static_cast<move>(k) };
+			const auto slice{ t.slice_move(static_cast<uint16_t>(index / coords::flip_count), m) };
+			const auto flip{ t.flip_move(static_cast<uint16_t>(index % coords::flip_count), m) };
+			return size_t{ slice } * coords::flip_count + flip;
+		});
+	tables->m_slice_corner_pruning = make_pruning_table(slice_corner_size, phase2_move_count,
+		[&t](const size_t index, const size_t k) {
+			const auto slice{ t.slice_permutation_move(static_cast<uint16_t>(index / coords::corner_permutation_count), k) };
+			const auto corners{ t.corner_permutation_move(static_cast<uint16_t>(index % coords::corner_permutation_count), k) };
+			return size_t{ slice } * coords::corner_permutation_count + corners;
+		});
+	tables->m_slice_edge_pruning = make_pruning_table(slice_edge_size, phase2_move_count,
+		[&t](const size_t index, const size_t k) {
+			const auto slice{ t.slice_permutation_move(static_cast<uint16_t>(index / coords::ud_edge_permutation_count), k) };
+			const auto edges{ t.ud_edge_permutation_move(static_cast<uint16_t>(index % coords::ud_edge_permutation_count), k) };
+			return size_t{ slice } * coords::ud_edge_permutation_count + edges;
+		});
+
+	return tables;
+}
+
+std::shared_ptr<const two_phase_tables> two_phase_tables::load(const std::filesystem::path &path) {
+	namespace coords = coordinates;
+
+	std::ifstream file{ path, std::ios::binary };
+	if (!file) {
+		return nullptr;
+	}
+
+	uint32_t header[2]{};
+	if (!file.read(reinterpret_cast<char *>(header), sizeof(header))
+		|| header[0] != two_phase_file_magic || header[1] != two_phase_file_version) {
+		spdlog::warn("[two_phase_tables::load] '{}' isn't a two-phase tables file of version {}",
+			path.string(), two_phase_file_version);
+		return nullptr;
+	}
+
+	auto tables{ std::make_shared<two_phase_tables>() };
+	const bool loaded{
+		read_table(file, tables->m_twist_moves, coords::twist_count * move_count)
+		&& read_table(file, tables->m_flip_moves, coords::flip_count * move_count)
+		&& read_table(file, tables->m_slice_moves, coords::slice_count * move_count)
+		&& read_table(file, tables->m_corner_permutation_moves, coords::corner_permutation_count * phase2_move_count)
+		&& read_table(file, tables->m_ud_edge_permutation_moves, coords::ud_edge_permutation_count * phase2_move_count)
+		&& read_table(file, tables->m_slice_permutation_moves, coords::slice_permutation_count * phase2_move_count)
+		&& read_table(file, tables->m_slice_twist_pruning, (slice_twist_size + 1) / 2)
+		&& read_table(file, tables->m_slice_flip_pruning, (slice_flip_size + 1) / 2)
+		&& read_table(file, tables->m_slice_corner_pruning, (slice_corner_size + 1) / 2)
+		&& read_table(file, tables->m_slice_edge_pruning, (slice_edge_size + 1) / 2)
+	};
+	if (!loaded) {
+		spdlog::warn("[two_phase_tables::load] '{}' is truncated or corrupted", path.string());
+		return nullptr;
+	}
+	return tables;
+}
+
+bool two_phase_tables::save(const std::filesystem::path &path) const {
+	std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+	if (!file) {
+		spdlog::error("[two_phase_tables::save] Failed to open '{}' for writing", path.string());
+		return false;
+	}
+
+	const uint32_t header[2]{ two_phase_file_magic, two_phase_file_version };
+	file.write(reinterpret_cast<const char *>(header), sizeof(header));
+	write_table(file, m_twist_moves);
+	write_table(file, m_flip_moves);
+	write_table(file, m_slice_moves);
+	write_table(file, m_corner_permutation_moves);
+	write_table(file, m_ud_edge_permutation_moves);
+	write_table(file, m_slice_permutation_moves);
+	write_table(file, m_slice_twist_pruning);
+	write_table(file, m_slice_flip_pruning);
+	write_table(file, m_slice_corner_pruning);
+	write_table(file, m_slice_edge_pruning);
+	return static_cast<bool>(file);
+}
+
+std::shared_ptr<const two_phase_tables> two_phase_tables::load_or_generate(const std::filesystem::path &path) {
+	using clock = std::chrono::steady_clock;
+	const auto start{ clock::now() };
+	const auto elapsed{ [&start] {
+		return std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - start).count();
+	} };
+
+	if (auto tables{ load(path) }; tables != nullptr) {
+		spdlog::info("[two_phase_tables::load_or_generate] Loaded '{}' in {} ms", path.string(), elapsed());
+		return tables;
+	}
+
+	auto tables{ generate() };
+	spdlog::info("[two_phase_tables::load_or_generate] Generated the tables in {} ms", elapsed());
+	if (tables->save(path)) {
+		spdlog::info("[two_phase_tables::load_or_generate] Saved the tables to '{}'", path.string());
+	}
+	return tables;
+}
+
+} // namespace gzn::game::magicube
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <algorithm>
+#include <vector>
+#include <cinttypes>
+#include <filesystem>
+
+#include "game/magicube/cube/move.hpp"
+#include "game/magicube/solver/coordinates.hpp"
+
+namespace gzn::game::magicube {
+
+/// @brief Move and pruning tables of the Kociemba's two-phase algorithm.
+/// Generating them takes a couple of seconds, so they're built once and cached on disk.
+class two_phase_tables {
+public:
+	static constexpr size_t phase2_move_count{ 10 };
+	static constexpr std::array<move, phase2_move_count> phase2_moves{
+		move::U1, move::U2, move::U3, move::D1, move::D2, move::D3,
+		move::R2, move::L2, move::F2, move::B2,
+	};
+
+	[[nodiscard]] static std::shared_ptr<const two_phase_tables> generate();
+	[[nodiscard]] static std::shared_ptr<const two_phase_tables> load(const std::filesystem::path &path);
+	[[nodiscard]] bool save(const std::filesystem::path &path) const;
+
+	/// @brief Loads the tables from @p path or generates them and saves to @p path
+	[[nodiscard]] static std::shared_ptr<const two_phase_tables> load_or_generate(const std::filesystem::path &path);
+
+	[[nodiscard]] uint16_t twist_move(const uint16_t twist, const move m) const noexcept {
+		return m_twist_moves[twist * move_count + static_cast<size_t>(m)];
+	}
+	[[nodiscard]] uint16_t flip_move(const uint16_t flip, const move m) const noexcept {
+		return m_flip_moves[flip * move_count + static_cast<size_t>(m)];
+	}
+	[[nodiscard]] uint16_t slice_move(const uint16_t slice, const move m) const noexcept {
+		return m_slice_moves[slice * move_count + static_cast<size_t>(m)];
+	}
+	[[nodiscard]] uint16_t corner_permutation_move(const uint16_t permutation, const size_t phase2_move) const noexcept {
+		return m_corner_permutation_moves[permutation * phase2_move_count + phase2_move];
+	}
+	[[nodiscard]] uint16_t ud_edge_permutation_move(const uint16_t permutation, const size_t phase2_move) const noexcept {
+		return m_ud_edge_permutation_moves[permutation * phase2_move_count + phase2_move];
+	}
+	[[nodiscard]] uint16_t slice_permutation_move(const uint16_t permutation, const size_t phase2_move) const noexcept {
+		return m_slice_permutation_moves[permutation * phase2_move_count + phase2_move];
+	}
+
+	/// @brief Lower bound of the phase 1 distance
+	[[nodiscard]] uint8_t phase1_distance(const uint16_t twist, const uint16_t flip, const uint16_t slice) const noexcept {
+		return std::max(slice_twist_distance(slice, twist), slice_flip_distance(slice, flip));
+	}
+	[[nodiscard]] uint8_t slice_twist_distance(const uint16_t slice, const uint16_t twist) const noexcept {
+		return nibble(m_slice_twist_pruning, size_t{ slice } * coordinates::twist_count + twist);
+	}
+	[[nodiscard]] uint8_t slice_flip_distance(const uint16_t slice, const uint16_t flip) const noexcept {
+		return nibble(m_slice_flip_pruning, size_t{ slice } * coordinates::flip_count + flip);
+	}
+
+	/// @brief Lower bound of the phase 2 distance
+	[[nodiscard]] uint8_t phase2_distance(const uint16_t corners, const uint16_t edges, const uint16_t slice) const noexcept {
+		const auto base{ static_cast<size_t>(slice) };
+		return std::max(
+			nibble(m_slice_corner_pruning, base * coordinates::corner_permutation_count + corners),
+			nibble(m_slice_edge_pruning, base * coordinates::ud_edge_permutation_count + edges)
+		);
+	}
+
+private:
+	std::vector<uint16_t> m_twist_moves;
+	std::vector<uint16_t> m_flip_moves;
+	std::vector<uint16_t> m_slice_moves;
+	std::vector<uint16_t> m_corner_permutation_moves;
+	std::vector<uint16_t> m_ud_edge_permutation_moves;
+	std::vector<uint16_t> m_slice_permutation_moves;
+
+	// distances are packed two per byte
+	std::vector<uint8_t> m_slice_twist_pruning;
+	std::vector<uint8_t> m_slice_flip_pruning;
+	std::vector<uint8_t> m_slice_corner_pruning;
+	std::vector<uint8_t> m_slice_edge_pruning;
+
+	[[nodiscard]] static uint8_t nibble(const std::vector<uint8_t> &table, const size_t index) noexcept {
+		return (table[index >> 1] >> ((index & 1) << 2)) & 0x0F;
+	}
+};
+
+} // namespace gzn::game::magicube
@@ -1,8 +1,22 @@
+#include <string_view>
+
 #include <spdlog/spdlog.h>
 #include <core/app/application.hpp>
 #include <game/magicube/instance.hpp>
+#include <game/magicube/batch/batch_solver.hpp>
+#include <game/magicube/scramble/scramble_generator.hpp>
+
+int main(int argc, char **argv) try {
+	// the batch mode is headless: neither a window nor a GL context is created
+	if (argc > 1 && std::string_view{ argv[1] } == "--batch") {
+		const auto options{ gzn::game::magicube::batch_options::parse(argc - 2, argv + 2) };
+		return options ? gzn::game::magicube::batch_solver{ *options }.run() : EXIT_FAILURE;
+	}
+	if (argc > 1 && std::string_view{ argv[1] } == "--scramble") {
+		const auto options{ gzn::game::magicube::scramble_options::parse(argc - 2, argv + 2) };
+		return options ? gzn::game::magicube::scramble_generator{ *options }.run() : EXIT_FAILURE;
+	}
 
-int main() try {
 	if (auto app{ gzn::core::application::create() }; app != nullptr) {
 		app->assign_game(std::make_shared<gzn::game::magicube::instance>());
 		return app->run();
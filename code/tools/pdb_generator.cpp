@@ -0,0 +1,94 @@
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <string_view>
+
+#include <spdlog/spdlog.h>
+
+#include "game/magicube/solver/optimal_solver.hpp"
+#include "game/magicube/solver/pattern_generator.hpp"
+
+namespace {
+
+using namespace gzn::game::magicube;
+
+constexpr std::string_view usage{
+	"Usage: magicube_pdb_generator [options]\n"
+	"  --standard [directory]      Generates the missing databases of the optimal solver,\n"
+	"                              in assets/pdb by default\n"
+	"  --layout <layout>           corners or edges:<first edge index>:<count>\n"
+	"  --output <path>             Output file of --layout\n"
+	"  --encoding <nibble|mod3>    Distance packing, nibble by default\n"
+	"  --threads <count>           0 (default) uses every hardware thread\n"
+	"  --no-resume                 Ignores the checkpoint of a previous run\n"
+};
+
+std::optional<pattern_layout> parse_layout(const std::string_view text) {
+	if (text == "corners") {
+		return pattern_layout::corners();
+	}
+	unsigned first{};
+	unsigned count{};
+	if (std::sscanf(std::string{ text }.c_str(), "edges:%u:%u", &first, &count) != 2
+		|| first >= edge_count || count == 0 || first + count > edge_count) {
+		return std::nullopt;
+	}
+	return pattern_layout::edges(static_cast<edge>(first), static_cast<uint8_t>(count));
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv) {
+	std::optional<std::filesystem::path> standard;
+	std::optional<pattern_layout> layout;
+	std::filesystem::path output;
+	pattern_generator_options options;
+
+	for (int i{ 1 }; i < argc; ++i) {
+		const std::string_view argument{ argv[i] };
+		const auto value{ [&]() -> std::string_view { return i + 1 < argc ? argv[++i] : ""; } };
+
+		if (argument == "--standard") {
+			const bool has_directory{ i + 1 < argc && argv[i + 1][0] != '-' };
+			standard = has_directory ? std::filesystem::path{ value() }
+				: std::filesystem::path{ defaults::solver::pattern_databases_path };
+		} else if (argument == "--layout") {
+			if (i + 1 >= argc) {
+				spdlog::error("[pdb_generator] Missing the layout after --layout");
+				return EXIT_FAILURE;
+			}
+			const auto text{ value() };
+			layout = parse_layout(text);
+			if (!layout) {
+				spdlog::error("[pdb_generator] Invalid layout '{}'", text);
+				return EXIT_FAILURE;
+			}
+		} else if (argument == "--output") {
+			output = value();
+		} else if (argument == "--encoding") {
+			const auto encoding{ value() };
+			if (encoding != "nibble" && encoding != "mod3") {
+				spdlog::error("[pdb_generator] Unknown encoding '{}'", encoding);
+				return EXIT_FAILURE;
+			}
+			options.encoding = encoding == "mod3" ? pattern_encoding::mod3 : pattern_encoding::nibble;
+		} else if (argument == "--threads") {
+			options.threads = std::strtoull(std::string{ value() }.c_str(), nullptr, 10);
+		} else if (argument == "--no-resume") {
+			options.resume = false;
+		} else {
+			fmt::print("{}", usage);
+			return argument == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	if (standard) {
+		return optimal_solver::generate(*standard, options) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+	if (!layout || output.empty()) {
+		fmt::print("{}", usage);
+		return EXIT_FAILURE;
+	}
+	return pattern_generator{ *layout, options }.run(output) ? EXIT_SUCCESS : EXIT_FAILURE;
+}